@@ -0,0 +1,325 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+// This file is part of LookupTable <https://github.com/zjldemers/LookupTable>.
+// 
+// MIT License
+// Copyright (c) 2022 Zachary J. L. Demers
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "LookupAxis.h"
+#include <algorithm>
+#include <cmath>
+#include "LookupStats.h"
+#include "LookupUtils.hpp"
+#if defined(_MSC_VER)
+	#include <intrin.h>
+#endif
+
+using namespace zjld; // feel free to remove/rename as the license above allows
+
+
+namespace
+{
+	// Hints the processor to start loading the cache line holding aAddress
+	inline void Prefetch(const void* aAddress)
+	{
+	#if defined(__GNUC__) || defined(__clang__)
+		__builtin_prefetch(aAddress);
+	#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+		_mm_prefetch(static_cast<const char*>(aAddress), _MM_HINT_T0);
+	#else
+		(void)aAddress;
+	#endif
+	}
+
+	// Number of times aValue must be halved (rounding up) to reach 1, i.e. the number of
+	// steps of a binary search among aValue segments
+	inline size_t CeilLog2(size_t aValue)
+	{
+		size_t steps = 0;
+		for (; aValue > 1; aValue -= aValue / 2) {
+			steps++;
+		}
+		return steps;
+	}
+
+	// Number of consecutive set bits starting from the least significant bit
+	inline unsigned CountTrailingOnes(const size_t aValue)
+	{
+		const unsigned long long inverted = ~static_cast<unsigned long long>(aValue);
+	#if defined(__GNUC__) || defined(__clang__)
+		return inverted ? static_cast<unsigned>(__builtin_ctzll(inverted)) : 64;
+	#elif defined(_MSC_VER) && defined(_M_X64)
+		unsigned long idx;
+		return _BitScanForward64(&idx, inverted) ? static_cast<unsigned>(idx) : 64;
+	#else
+		unsigned count = 0;
+		for (unsigned long long v = inverted; count < 64 && !(v & 1); v >>= 1)
+			count++;
+		return count;
+	#endif
+	}
+}
+
+
+LookupAxis::LookupAxis()
+	: _data{}
+	, _uniform{ false }
+	, _origin{ 0.0 }
+	, _invStep{ 0.0 }
+	, _eytzinger{}
+	, _eytzingerIdx{}
+	, _bounds{ BoundPolicy::Error }
+{}
+
+LookupAxis::LookupAxis(const TableData& aData)
+	: LookupAxis(aData, SearchLayout::Auto, BoundPolicy::Error)
+{}
+
+LookupAxis::LookupAxis(const TableData& aData,
+	const SearchLayout& aLayout)
+	: LookupAxis(aData, aLayout, BoundPolicy::Error)
+{}
+
+LookupAxis::LookupAxis(const TableData& aData,
+	const SearchLayout& aLayout,
+	const BoundPolicy& aBounds)
+	: _data{ aData }
+	, _uniform{ false }
+	, _origin{ aData.empty() ? 0.0 : aData.front() }
+	, _invStep{ 0.0 }
+	, _eytzinger{}
+	, _eytzingerIdx{}
+	, _bounds{ aBounds }
+{
+	if (_data.size() < 3)
+		return; // nothing to gain over the search for so few breakpoints
+
+	// Check if every breakpoint is (nearly) where an evenly spaced axis would put it
+	const double step = (_data.back() - _data.front()) / static_cast<double>(_data.size() - 1);
+	bool uniform = (step > 0.0);
+	for (size_t i = 1; uniform && i < _data.size() - 1; i++) {
+		const double expected = _data.front() + step * static_cast<double>(i);
+		uniform = (std::abs(_data[i] - expected) <= step * kUniformTolerance);
+	}
+	if (uniform) {
+		_uniform = true;
+		_invStep = 1.0 / step;
+		return; // no search needed at all
+	}
+
+	// Indices into _data are stored as 32-bit values to keep the layout compact
+	const bool eytzinger = (aLayout == SearchLayout::Eytzinger)
+		|| (aLayout == SearchLayout::Auto && _data.size() >= kEytzingerMinSize);
+	if (eytzinger && _data.size() < UINT32_MAX) {
+		_eytzinger = TableData(_data.size() + 1);
+		_eytzingerIdx = std::vector<uint32_t>(_data.size() + 1);
+		size_t next = 0;
+		BuildEytzinger(&next, 1);
+	}
+}
+
+
+const TableData& LookupAxis::Data() const
+{
+	return _data;
+}
+size_t LookupAxis::Size() const
+{
+	return _data.size();
+}
+bool LookupAxis::Uniform() const
+{
+	return _uniform;
+}
+double LookupAxis::Origin() const
+{
+	return _origin;
+}
+double LookupAxis::InvStep() const
+{
+	return _invStep;
+}
+LookupAxis::SearchLayout LookupAxis::Layout() const
+{
+	return _eytzinger.empty() ? SearchLayout::Binary : SearchLayout::Eytzinger;
+}
+size_t LookupAxis::SearchDataSize() const
+{
+	return _eytzinger.size();
+}
+size_t LookupAxis::SearchDepth() const
+{
+	if (_uniform || _data.size() < 2)
+		return 0;
+	// Eytzinger: one step per level of the tree, otherwise one per halving of the segments
+	return _eytzinger.empty() ? CeilLog2(_data.size() - 1) : CeilLog2(_data.size() + 1);
+}
+LookupAxis::BoundPolicy LookupAxis::Bounds() const
+{
+	return _bounds;
+}
+
+
+bool LookupAxis::FindApproxPos(const double& aValue,
+	double* outApproxPosition) const
+{
+	// Axes with a single value are rejected since there is nothing to interpolate between
+	double clamped, value;
+	if (_data.size() < 2 || !ApplyBounds(aValue, &clamped, &value))
+		return false;
+	*outApproxPosition = ApproxPosInSegment(FindSegment(clamped), value);
+	return true;
+}
+
+bool LookupAxis::FindApproxPos(const double& aValue,
+	size_t* ioSegment,
+	double* outApproxPosition) const
+{
+	double clamped, value;
+	if (_data.size() < 2 || !ApplyBounds(aValue, &clamped, &value))
+		return false;
+	*ioSegment = FindSegment(clamped, *ioSegment);
+	*outApproxPosition = ApproxPosInSegment(*ioSegment, value);
+	return true;
+}
+
+size_t LookupAxis::FindSegment(const double& aValue) const
+{
+	const size_t lastSegment = _data.size() - 2;
+	if (_uniform) {
+		// The estimate is within one segment of the answer since the breakpoints are within
+		// kUniformTolerance of even spacing, so a single correction step either way is exact
+		const double estimate = (aValue - _origin) * _invStep;
+		size_t l = static_cast<size_t>(estimate); // value is in bounds, so estimate >= 0
+		l = (l < lastSegment) ? l : lastSegment;
+		l -= (l > 0 && _data[l] > aValue) ? 1 : 0;
+		l += (l < lastSegment && _data[l + 1] <= aValue) ? 1 : 0;
+		return l;
+	}
+
+	if (!_eytzinger.empty())
+		return SearchEytzinger(aValue);
+	return SearchSegments(0, lastSegment + 1, aValue);
+}
+
+size_t LookupAxis::FindSegment(const double& aValue,
+	const size_t& aHint) const
+{
+	const size_t lastSegment = _data.size() - 2;
+	if (_uniform)
+		return FindSegment(aValue);
+
+	size_t h = (aHint < lastSegment) ? aHint : lastSegment;
+	if (_data[h] <= aValue) {
+		// At or above the hinted segment: check it and the next one directly
+		if (h == lastSegment || aValue < _data[h + 1])
+			return h;
+		h++;
+		if (h == lastSegment || aValue < _data[h + 1])
+			return h;
+
+		// Gallop upward doubling the step until passing the value (or the last segment),
+		// then search the last step taken
+		size_t step = 1;
+		while (h + step <= lastSegment && _data[h + step] <= aValue) {
+			h += step;
+			step *= 2;
+			ZJLD_LOOKUP_STATS_ONLY(stats::Add(stats::Counter::SearchSteps, 1));
+		}
+		const size_t end = (h + step <= lastSegment) ? h + step : lastSegment + 1;
+		ZJLD_LOOKUP_STATS_ONLY(stats::Add(stats::Counter::SearchSteps, CeilLog2(end - h)));
+		return SearchSegments(h, end - h, aValue);
+	}
+
+	// Below the hinted segment (so h > 0 since the value is within the breakpoints): check
+	// the previous one directly, then gallop downward the same way
+	h--;
+	if (_data[h] <= aValue)
+		return h;
+	size_t step = 1;
+	while (h >= step && _data[h - step] > aValue) {
+		h -= step;
+		step *= 2;
+		ZJLD_LOOKUP_STATS_ONLY(stats::Add(stats::Counter::SearchSteps, 1));
+	}
+	const size_t first = (h >= step) ? h - step : 0;
+	ZJLD_LOOKUP_STATS_ONLY(stats::Add(stats::Counter::SearchSteps, CeilLog2(h - first)));
+	return SearchSegments(first, h - first, aValue);
+}
+
+double LookupAxis::ApproxPosInSegment(const size_t& aSegment,
+	const double& aValue) const
+{
+	bool snapped = false;
+	const double pos = PositionInSegment(_data.data(), aSegment, aValue, &snapped);
+	ZJLD_LOOKUP_STATS_ONLY(if (snapped) stats::Add(stats::Counter::ExactHits, 1));
+	return pos;
+}
+
+
+bool LookupAxis::ApplyBounds(const double& aValue,
+	double* outClamped,
+	double* outValue) const
+{
+	return ApplyBounds(_data.data(), _data.size(), _bounds, aValue, outClamped, outValue);
+}
+
+size_t LookupAxis::SearchSegments(size_t aFirst,
+	size_t aCount,
+	const double& aValue) const
+{
+	return SearchSegments(_data.data(), aFirst, aCount, aValue);
+}
+
+void LookupAxis::BuildEytzinger(size_t* ioNext,
+	const size_t& aNode)
+{
+	if (aNode >= _eytzinger.size())
+		return;
+	BuildEytzinger(ioNext, 2 * aNode);
+	_eytzinger[aNode] = _data[*ioNext];
+	_eytzingerIdx[aNode] = static_cast<uint32_t>(*ioNext);
+	(*ioNext)++;
+	BuildEytzinger(ioNext, 2 * aNode + 1);
+}
+
+size_t LookupAxis::SearchEytzinger(const double& aValue) const
+{
+	// Descend the implicit tree going right at every breakpoint <= aValue, prefetching the
+	// node 3 levels down (8 breakpoints per 64 byte cache line means the line holding its
+	// 8 consecutive descendants serves the next 3 levels of the search)
+	const double* tree = _eytzinger.data();
+	const size_t count = _eytzinger.size();
+	size_t k = 1;
+	while (k < count) {
+		Prefetch(tree + 8 * k);
+		k = 2 * k + ((tree[k] <= aValue) ? 1 : 0);
+	}
+
+	// Undo the trailing right turns (and the final left one) to get back to the first
+	// breakpoint above aValue, where k == 0 means there is none (aValue is at the last one)
+	k >>= CountTrailingOnes(k) + 1;
+	const size_t lastSegment = _data.size() - 2;
+	if (k == 0)
+		return lastSegment;
+	const size_t upper = _eytzingerIdx[k]; // > 0 since aValue is within the breakpoints
+	return (upper - 1 < lastSegment) ? upper - 1 : lastSegment;
+}
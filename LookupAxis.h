@@ -0,0 +1,302 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+// This file is part of LookupTable <https://github.com/zjldemers/LookupTable>.
+// 
+// MIT License
+// Copyright (c) 2022 Zachary J. L. Demers
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef _ZJLD_LOOKUP_AXIS_H_
+#define _ZJLD_LOOKUP_AXIS_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "LookupUtils.hpp"
+
+namespace zjld // feel free to remove/rename as the license above allows
+{
+
+	typedef std::vector<double>    TableData;
+	typedef std::vector<TableData> TableDataSet;
+
+
+	// This class holds the independent data of one dimension of a table (its breakpoints)
+	// along with whatever is needed to quickly find where a value falls within them.  The
+	// search strategy is chosen once when the axis is built:
+	// - Uniform: evenly spaced breakpoints (within a small tolerance) are located directly
+	//   from the value as (value - origin) / step, with no search required
+	// - Binary: otherwise, a branchless binary search over the breakpoints is used
+	// - Eytzinger: large axes may instead keep a copy of the breakpoints in breadth-first
+	//   (Eytzinger) order, where the next few levels of the search share a cache line and
+	//   can be prefetched ahead of time (see SearchLayout below)
+	// - Hinted: if a previously found segment is given, it and its neighbours are checked
+	//   first, then the search gallops outward from it before finishing with a binary search
+	// Every strategy finds the exact same segment, so results never depend on the strategy.
+	// Values outside of the breakpoints are handled according to the axis' BoundPolicy.
+	class LookupAxis
+	{
+	public:
+		// The search used for axes that are not uniform:
+		// - Auto: Eytzinger for axes of at least kEytzingerMinSize breakpoints, else Binary
+		// - Binary: branchless binary search directly over the breakpoints
+		// - Eytzinger: branchless search over an extra breadth-first copy of the breakpoints,
+		//   trading memory (another 1.5x that of the breakpoints) for fewer cache misses
+		enum class SearchLayout { Auto, Binary, Eytzinger };
+
+		// How values outside of the breakpoints are handled.  Either way the search itself
+		// only sees values clamped to the breakpoints, so the policy costs one min/max:
+		// - Error: the value is rejected (FindApproxPos returns false)
+		// - Clamp: the value is treated as the nearest breakpoint, as if clamped by the caller
+		// - Extrapolate: the position continues linearly beyond the first or last segment
+		//   (e.g. -0.5 for half a segment below the first breakpoint)
+		// - Nearest: the same as Clamp (with linear interpolation, the nearest breakpoint's
+		//   value is the value at the bound)
+		// NaN values are rejected by every policy.
+		enum class BoundPolicy { Error, Clamp, Extrapolate, Nearest = Clamp };
+
+		// Breakpoints may deviate from perfectly even spacing by up to this fraction of the
+		// step and still be treated as uniform (the segment found is exact regardless).
+		static constexpr double kUniformTolerance = 1e-6;
+
+		// Smallest axis given an Eytzinger layout by SearchLayout::Auto.  Below this the
+		// breakpoints fit comfortably in cache and the plain binary search is faster.
+		static const size_t kEytzingerMinSize = 8192;
+
+	private:
+		TableData _data;  // breakpoints (must be monotonically increasing)
+		bool _uniform;    // true if the breakpoints are evenly spaced
+		double _origin;   // first breakpoint (uniform axes only)
+		double _invStep;  // reciprocal of the breakpoint spacing (uniform axes only)
+		TableData _eytzinger;           // breakpoints in breadth-first order from [1] (if used)
+		std::vector<uint32_t> _eytzingerIdx; // index in _data of each _eytzinger value
+		BoundPolicy _bounds;    // handling of values outside of the breakpoints
+
+	public:
+		LookupAxis();
+		explicit LookupAxis(const TableData& aData);
+		LookupAxis(const TableData& aData,
+			const SearchLayout& aLayout);
+		LookupAxis(const TableData& aData,
+			const SearchLayout& aLayout,
+			const BoundPolicy& aBounds);
+
+		const TableData& Data() const; // breakpoints
+		size_t Size() const;           // number of breakpoints
+		bool Uniform() const;          // true if located directly (see above)
+		double Origin() const;         // first breakpoint
+		double InvStep() const;        // reciprocal spacing (only meaningful if Uniform)
+		SearchLayout Layout() const;   // Binary or Eytzinger (never Auto, ignored if Uniform)
+		size_t SearchDataSize() const; // number of values stored for the search layout
+		size_t SearchDepth() const;    // steps taken by an unhinted search (0 if Uniform)
+		BoundPolicy Bounds() const;    // handling of values outside of the breakpoints
+
+		/* This returns false if aValue is NaN or rejected by the BoundPolicy, or if there
+		* are fewer than 2 breakpoints.  Otherwise it returns true with outApproxPosition set
+		* to the floating point "index" of aValue, using simple linear interpolation between
+		* the surrounding breakpoints (e.g. 1.3 for 30% of the way from [1] to [2]).  Only
+		* BoundPolicy::Extrapolate gives positions outside of [0, Size()-1].
+		*/
+		bool FindApproxPos(const double& aValue,
+			double* outApproxPosition) const;
+
+		/* This is the same as the above, but starts the search from the segment held by
+		* ioSegment (see the hinted FindSegment below) and, on success, updates it with the
+		* segment that was found.  On failure ioSegment is left unchanged.
+		*/
+		bool FindApproxPos(const double& aValue,
+			size_t* ioSegment,
+			double* outApproxPosition) const;
+
+		/* This returns the segment [l, l+1] holding aValue, i.e. the last l in [0, Size()-2]
+		* where Data()[l] <= aValue.  aValue must be within the breakpoints.
+		*/
+		size_t FindSegment(const double& aValue) const;
+
+		/* This returns the same segment as the above, but expects it to be at or near aHint
+		* (e.g. the segment found for the previous value of a slowly changing input).  The
+		* hinted segment and its neighbours cost one or two comparisons, and further values
+		* are found by galloping outward from the hint, so the cost grows with the distance
+		* from the hint rather than with Size().  Any aHint is accepted (out of range hints
+		* are clamped), and uniform axes ignore it as they need no search at all.
+		*/
+		size_t FindSegment(const double& aValue,
+			const size_t& aHint) const;
+
+		/* This converts a segment found by FindSegment into the approximate position given
+		* by FindApproxPos, snapping to breakpoints that are approximately equal to aValue.
+		* aValue may be outside of the segment to extrapolate from it.
+		*/
+		double ApproxPosInSegment(const size_t& aSegment,
+			const double& aValue) const;
+
+		/* The steps below place a value along a dimension's breakpoints, and are shared by
+		* every lookup path that cannot hold a LookupAxis (StaticLookupTable, and
+		* device::EvaluatePoint on devices) as well as by this class and the tables, so
+		* that all of them find bit-identical positions (the SIMD kernels of LookupSimd.cpp
+		* vectorize the same steps).  Each works on aSize strictly increasing breakpoints
+		* at aData, at least 2, and is constexpr and compiled for devices too.
+		*/
+
+		/* This sets outClamped to aValue clamped to the breakpoints (the value to search
+		* for) and outValue to the value to find the position of within that segment (aValue
+		* itself if extrapolating).  It returns false if aValue is NaN or rejected by
+		* aBounds.
+		*/
+		ZJLD_LOOKUP_HOST_DEVICE static constexpr bool ApplyBounds(const double* aData,
+			const size_t aSize,
+			const BoundPolicy aBounds,
+			const double aValue,
+			double* outClamped,
+			double* outValue)
+		{
+			// Written so that NaN values stay NaN through the clamp and then fail (every
+			// comparison with NaN is false), leaving a single branch on the policy for in
+			// bounds values
+			*outClamped = std::min(std::max(aValue, aData[0]), aData[aSize - 1]);
+			if (!(*outClamped == *outClamped))
+				return false;
+			switch (aBounds) {
+			case BoundPolicy::Error:
+				*outValue = aValue;
+				return *outClamped == aValue;
+			case BoundPolicy::Extrapolate:
+				*outValue = aValue;
+				return true;
+			default:
+				*outValue = *outClamped;
+				return true;
+			}
+		}
+
+		/* Branchless binary search for the segment holding aValue among the aCount segments
+		* starting at aFirst, where aData[aFirst] <= aValue and the segment after the range
+		* (if any) starts above aValue.
+		*/
+		ZJLD_LOOKUP_HOST_DEVICE static constexpr size_t SearchSegments(const double* aData,
+			size_t aFirst,
+			size_t aCount,
+			const double aValue)
+		{
+			// - NOTE: this is why the independent data must be monotonically increasing
+			while (aCount > 1) {
+				const size_t half = aCount / 2;
+				aFirst += (aData[aFirst + half] <= aValue) ? half : 0;
+				aCount -= half;
+			}
+			return aFirst;
+		}
+
+		/* This returns the approximate position of aValue from segment aSegment, snapping
+		* to either of its breakpoints if approximately equal to aValue (setting outSnapped,
+		* if not null, to whether it did).  aValue may be outside of the segment to
+		* extrapolate from it.
+		*/
+		ZJLD_LOOKUP_HOST_DEVICE static constexpr double PositionInSegment(const double* aData,
+			const size_t aSegment,
+			const double aValue,
+			bool* outSnapped = nullptr)
+		{
+			// The first breakpoint is not snapped to so that results stay identical to the
+			// earlier probing binary search, which never tested it
+			double pos = 0.0;
+			bool snapped = true;
+			if (aSegment > 0 && utils::IsApproxEqual(aValue, aData[aSegment]))
+				pos = static_cast<double>(aSegment);
+			else if (utils::IsApproxEqual(aValue, aData[aSegment + 1]))
+				pos = static_cast<double>(aSegment + 1);
+			else {
+				pos = static_cast<double>(aSegment) + utils::ILerp(aData[aSegment], aData[aSegment + 1], aValue);
+				snapped = false;
+			}
+			if (outSnapped)
+				*outSnapped = snapped;
+			return pos;
+		}
+
+		/* This splits an approximate position into the low index of its cell and the
+		* percent progress from there to the next index (e.g. 1.3 gives 1 and 0.3).  The low
+		* index is limited to the last segment so that checking the "high" value later will
+		* not go out of bounds: a position at the last index gets a percent progress of 100%
+		* (1.0), and extrapolated positions continue from the first or last segment with a
+		* percent progress below 0.0 or above 1.0.
+		*/
+		ZJLD_LOOKUP_HOST_DEVICE static constexpr void CellFromPosition(const double aPosition,
+			const size_t aSize,
+			size_t* outLowIdx,
+			double* outPercProgress)
+		{
+			// (std::floor is not constexpr, but positions within [0, lastLow) are truncated,
+			// which is their floor)
+			const double lastLow = static_cast<double>(aSize - 2);
+			const double low = (aPosition >= lastLow) ? lastLow
+				: (aPosition <= 0.0) ? 0.0 : static_cast<double>(static_cast<size_t>(aPosition));
+			*outLowIdx = static_cast<size_t>(low);
+			*outPercProgress = aPosition - low;
+		}
+
+		/* This is all of the above in turn, with an unhinted binary search: it finds the
+		* low index and percent progress of aValue, returning false if aBounds rejects it,
+		* exactly as FindApproxPos followed by LookupTableND's PositionFromApproxPos would.
+		*/
+		ZJLD_LOOKUP_HOST_DEVICE static constexpr bool FindPosition(const double* aData,
+			const size_t aSize,
+			const BoundPolicy aBounds,
+			const double aValue,
+			size_t* outLowIdx,
+			double* outPercProgress)
+		{
+			double clamped = 0.0, value = 0.0;
+			if (!ApplyBounds(aData, aSize, aBounds, aValue, &clamped, &value))
+				return false;
+			const size_t segment = SearchSegments(aData, 0, aSize - 1, clamped);
+			CellFromPosition(PositionInSegment(aData, segment, value), aSize, outLowIdx, outPercProgress);
+			return true;
+		}
+
+	private:
+		/* This applies _bounds to aValue, as the static ApplyBounds above does.  There must
+		* be at least 2 breakpoints.
+		*/
+		bool ApplyBounds(const double& aValue,
+			double* outClamped,
+			double* outValue) const;
+
+		/* This places the breakpoints from index ioNext onward into the subtree of _eytzinger
+		* rooted at aNode (children of node k are 2k and 2k+1) using an in-order traversal,
+		* which leaves them in breadth-first order.  ioNext is advanced past those placed.
+		*/
+		void BuildEytzinger(size_t* ioNext,
+			const size_t& aNode);
+
+		/* Branchless search for the segment holding aValue using _eytzinger.
+		*/
+		size_t SearchEytzinger(const double& aValue) const;
+
+		/* The static SearchSegments above, over _data.
+		*/
+		size_t SearchSegments(size_t aFirst,
+			size_t aCount,
+			const double& aValue) const;
+	};
+}
+
+#endif // _ZJLD_LOOKUP_AXIS_H_
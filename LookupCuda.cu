@@ -0,0 +1,371 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+// This file is part of LookupTable <https://github.com/zjldemers/LookupTable>.
+// 
+// MIT License
+// Copyright (c) 2022 Zachary J. L. Demers
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "LookupCuda.h"
+#include <algorithm>
+#include <limits>
+#include <cuda_runtime.h>
+
+using namespace zjld; // feel free to remove/rename as the license above allows
+using std::string;
+using std::vector;
+using utils::ErrorCode;
+using utils::ErrorCodeMessage;
+
+
+namespace
+{
+	// Batches use at most this many blocks, each thread looping over every
+	// (blocks * kBlockSize)th point beyond that
+	const size_t kMaxBlocks = 1 << 16;
+
+	// The input pointers of a batch, passed to the kernels by value
+	struct DimValues {
+		const double* values[device::kMaxDimensions];
+	};
+
+	// Sets the mask bits of the points of a warp with a single atomic per warp.  Threads of
+	// a warp handle consecutive points starting at aBase, a multiple of 32 (the block size
+	// and the grid stride being multiples of 32), so their bits make up one half of a mask
+	// word.  Every thread of the warp must call this together, those past the end of the
+	// batch with aValid false, which is why the kernels loop on the index of the warp's
+	// first point rather than their own.
+	__device__ void SetValidBits(const size_t aBase,
+		const bool aValid,
+		unsigned long long* outValidMask)
+	{
+		const unsigned int bits = __ballot_sync(0xffffffffu, aValid);
+		if ((threadIdx.x & 31) == 0 && bits != 0)
+			atomicOr(&outValidMask[aBase / 64], static_cast<unsigned long long>(bits) << (aBase % 64));
+	}
+
+	// Evaluates aCount points with device::EvaluatePoint, for tables of kDims dimensions
+	template<size_t kDims>
+	__global__ void EvaluateBatchKernel(const device::TableView aView,
+		const DimValues aDimValues,
+		const size_t aCount,
+		double* outValues,
+		unsigned long long* outValidMask)
+	{
+		const size_t lane = threadIdx.x & 31;
+		const size_t stride = static_cast<size_t>(blockDim.x) * gridDim.x;
+		for (size_t base = static_cast<size_t>(blockIdx.x) * blockDim.x + threadIdx.x - lane;
+			base < aCount; base += stride) {
+			const size_t i = base + lane;
+			bool valid = false;
+			if (i < aCount) {
+				double values[kDims];
+				for (size_t d = 0; d < kDims; d++) {
+					values[d] = aDimValues.values[d][i];
+				}
+				double value = 0.0;
+				valid = device::EvaluatePoint<kDims>(aView, values, &value);
+				outValues[i] = valid ? value : std::numeric_limits<double>::quiet_NaN();
+			}
+			if (outValidMask)
+				SetValidBits(base, valid, outValidMask);
+		}
+	}
+
+	// The same as EvaluateBatchKernel, but with the texture units interpolating the cell
+	// at the position found along each dimension (texel centers being at index + 0.5)
+	template<size_t kDims>
+	__global__ void EvaluateTextureKernel(const device::TableView aView,
+		const cudaTextureObject_t aTexture,
+		const DimValues aDimValues,
+		const size_t aCount,
+		double* outValues,
+		unsigned long long* outValidMask)
+	{
+		const size_t lane = threadIdx.x & 31;
+		const size_t stride = static_cast<size_t>(blockDim.x) * gridDim.x;
+		for (size_t base = static_cast<size_t>(blockIdx.x) * blockDim.x + threadIdx.x - lane;
+			base < aCount; base += stride) {
+			const size_t i = base + lane;
+			bool valid = false;
+			if (i < aCount) {
+				float coords[3] = { 0.0f, 0.0f, 0.0f };
+				valid = true;
+				for (size_t d = 0; d < kDims; d++) {
+					size_t low = 0;
+					double prc = 0.0;
+					valid = device::FindPosition(aView, d, aDimValues.values[d][i], &low, &prc) && valid;
+					coords[d] = static_cast<float>(static_cast<double>(low) + prc) + 0.5f;
+				}
+				float value = 0.0f;
+				if constexpr (kDims == 2)
+					value = tex2D<float>(aTexture, coords[0], coords[1]);
+				else
+					value = tex3D<float>(aTexture, coords[0], coords[1], coords[2]);
+				outValues[i] = valid ? static_cast<double>(value) : std::numeric_limits<double>::quiet_NaN();
+			}
+			if (outValidMask)
+				SetValidBits(base, valid, outValidMask);
+		}
+	}
+}
+
+
+// ==== Begin Section: Construction/Destruction (Public) ==== //
+LookupTableCuda::LookupTableCuda()
+	: _data{}
+	, _view{}
+	, _deviceAxes{ nullptr }
+	, _deviceDepData{ nullptr }
+	, _array{ nullptr }
+	, _texture{ 0 }
+	, _options{}
+	, _valid{ false }
+{}
+
+LookupTableCuda::~LookupTableCuda()
+{
+	Reset();
+}
+
+bool LookupTableCuda::Upload(const LookupTableND& aTable,
+	string* outErrMsg)
+{
+	return Upload(aTable, Options(), outErrMsg);
+}
+
+bool LookupTableCuda::Upload(const LookupTableND& aTable,
+	const Options& aOptions,
+	string* outErrMsg)
+{
+	Reset();
+	const ErrorCode error = _data.Build(aTable);
+	if (error != ErrorCode::None) {
+		if (outErrMsg)
+			*outErrMsg = ErrorCodeMessage(error);
+		return false;
+	}
+	if (aOptions.hardwareInterpolation) {
+		bool extrapolates = false;
+		for (size_t i = 0; i < _data.Dimensions(); i++) {
+			extrapolates = extrapolates || aTable.Axis(i).Bounds() == LookupAxis::BoundPolicy::Extrapolate;
+		}
+		if ((_data.Dimensions() != 2 && _data.Dimensions() != 3) || extrapolates) {
+			Reset();
+			if (outErrMsg)
+				*outErrMsg = "Hardware interpolation needs a 2D or 3D table that does not extrapolate.";
+			return false;
+		}
+	}
+
+	// Breakpoints, then the dependent data either as is or as a texture
+	const vector<double>& axes = _data.AxisData();
+	const vector<double>& depData = _data.DepData();
+	bool success = CheckCuda(cudaMalloc(&_deviceAxes, axes.size() * sizeof(double)), "cudaMalloc", outErrMsg)
+		&& CheckCuda(cudaMemcpy(_deviceAxes, axes.data(), axes.size() * sizeof(double),
+			cudaMemcpyHostToDevice), "cudaMemcpy", outErrMsg);
+	if (success && aOptions.hardwareInterpolation) {
+		success = UploadTexture(outErrMsg);
+	}
+	else if (success) {
+		success = CheckCuda(cudaMalloc(&_deviceDepData, depData.size() * sizeof(double)), "cudaMalloc", outErrMsg)
+			&& CheckCuda(cudaMemcpy(_deviceDepData, depData.data(), depData.size() * sizeof(double),
+				cudaMemcpyHostToDevice), "cudaMemcpy", outErrMsg);
+	}
+	if (!success) {
+		Reset();
+		return false;
+	}
+	_view = _data.View(_deviceAxes, _deviceDepData);
+	_options = aOptions;
+	_valid = true;
+	return true;
+}
+
+void LookupTableCuda::Reset()
+{
+	// (errors freeing are ignored, as there is nothing left to do with the memory)
+	if (_texture != 0)
+		cudaDestroyTextureObject(_texture);
+	if (_array != nullptr)
+		cudaFreeArray(_array);
+	if (_deviceDepData != nullptr)
+		cudaFree(_deviceDepData);
+	if (_deviceAxes != nullptr)
+		cudaFree(_deviceAxes);
+	_data.Reset();
+	_view = device::TableView{};
+	_deviceAxes = nullptr;
+	_deviceDepData = nullptr;
+	_array = nullptr;
+	_texture = 0;
+	_options = Options();
+	_valid = false;
+}
+// ==== End Section: Construction/Destruction (Public) ==== //
+
+
+
+
+// ==== Begin Section: Batch Lookup Methods (Public) ==== //
+bool LookupTableCuda::QueryBatchByValues(const vector<const double*>& aDimValues,
+	const size_t& aCount,
+	double* outValues,
+	uint64_t* outValidMask,
+	string* outErrMsg,
+	cudaStream_t aStream) const
+{
+	ErrorCode error = ErrorCode::None;
+	if (!_valid)
+		error = ErrorCode::InvalidTable;
+	else if (aDimValues.size() != _view.dims)
+		error = ErrorCode::WrongInputCount;
+	else if (nullptr == outValues || std::count(aDimValues.begin(), aDimValues.end(), nullptr) != 0)
+		error = ErrorCode::NullPointer;
+	if (error != ErrorCode::None) {
+		if (outErrMsg)
+			*outErrMsg = ErrorCodeMessage(error);
+		return false;
+	}
+	if (aCount == 0)
+		return true;
+
+	DimValues dimValues{};
+	std::copy(aDimValues.begin(), aDimValues.end(), dimValues.values);
+	unsigned long long* validMask = reinterpret_cast<unsigned long long*>(outValidMask);
+	static_assert(sizeof(unsigned long long) == sizeof(uint64_t), "Mismatched mask words.");
+	if (outValidMask && !CheckCuda(cudaMemsetAsync(outValidMask, 0,
+		utils::BatchMaskWords(aCount) * sizeof(uint64_t), aStream), "cudaMemsetAsync", outErrMsg))
+		return false;
+
+	// (the kernels handle whole warps at a time, see SetValidBits)
+	static_assert(kBlockSize % 32 == 0, "Blocks must be made of whole warps.");
+	static_assert(device::kMaxDimensions == 8, "Update the cases below.");
+	const unsigned int blocks = static_cast<unsigned int>(
+		std::min((aCount + kBlockSize - 1) / kBlockSize, kMaxBlocks));
+	if (_texture == 0) {
+		switch (_view.dims) {
+		case 2: EvaluateBatchKernel<2><<<blocks, kBlockSize, 0, aStream>>>(_view, dimValues, aCount, outValues, validMask); break;
+		case 3: EvaluateBatchKernel<3><<<blocks, kBlockSize, 0, aStream>>>(_view, dimValues, aCount, outValues, validMask); break;
+		case 4: EvaluateBatchKernel<4><<<blocks, kBlockSize, 0, aStream>>>(_view, dimValues, aCount, outValues, validMask); break;
+		case 5: EvaluateBatchKernel<5><<<blocks, kBlockSize, 0, aStream>>>(_view, dimValues, aCount, outValues, validMask); break;
+		case 6: EvaluateBatchKernel<6><<<blocks, kBlockSize, 0, aStream>>>(_view, dimValues, aCount, outValues, validMask); break;
+		case 7: EvaluateBatchKernel<7><<<blocks, kBlockSize, 0, aStream>>>(_view, dimValues, aCount, outValues, validMask); break;
+		default: EvaluateBatchKernel<8><<<blocks, kBlockSize, 0, aStream>>>(_view, dimValues, aCount, outValues, validMask); break;
+		}
+	}
+	else if (_view.dims == 2) {
+		EvaluateTextureKernel<2><<<blocks, kBlockSize, 0, aStream>>>(_view, _texture, dimValues,
+			aCount, outValues, validMask);
+	}
+	else {
+		EvaluateTextureKernel<3><<<blocks, kBlockSize, 0, aStream>>>(_view, _texture, dimValues,
+			aCount, outValues, validMask);
+	}
+	return CheckCuda(cudaGetLastError(), "Kernel launch", outErrMsg);
+}
+// ==== End Section: Batch Lookup Methods (Public) ==== //
+
+
+
+
+// ==== Begin Section: Metadata (Public) ==== //
+bool LookupTableCuda::Valid() const
+{
+	return _valid;
+}
+
+size_t LookupTableCuda::Dimensions() const
+{
+	return _view.dims;
+}
+
+bool LookupTableCuda::HardwareInterpolation() const
+{
+	return _texture != 0;
+}
+
+size_t LookupTableCuda::DeviceBytes() const
+{
+	if (!_valid)
+		return 0;
+	const size_t depBytes = _data.DepData().size() * ((_texture != 0) ? sizeof(float) : sizeof(double));
+	return _data.AxisData().size() * sizeof(double) + depBytes;
+}
+// ==== End Section: Metadata (Public) ==== //
+
+
+
+
+// ==== Begin Section: Helpers (Protected) ==== //
+bool LookupTableCuda::CheckCuda(const cudaError_t& aError,
+	const char* aWhat,
+	string* outErrMsg)
+{
+	if (aError == cudaSuccess)
+		return true;
+	if (outErrMsg)
+		*outErrMsg = string(aWhat) + " failed: " + cudaGetErrorString(aError);
+	return false;
+}
+
+bool LookupTableCuda::UploadTexture(string* outErrMsg)
+{
+	// Textures hold the first dimension along x, which is also the fastest changing one
+	// of the Linear dependent data, so the values are copied in their existing order
+	const vector<double>& depData = _data.DepData();
+	const vector<float> values(depData.begin(), depData.end());
+	const size_t width = _data.AxisSize(0);
+	const size_t height = _data.AxisSize(1);
+	const cudaChannelFormatDesc channel = cudaCreateChannelDesc<float>();
+	if (_data.Dimensions() == 2) {
+		if (!CheckCuda(cudaMallocArray(&_array, &channel, width, height), "cudaMallocArray", outErrMsg)
+			|| !CheckCuda(cudaMemcpy2DToArray(_array, 0, 0, values.data(), width * sizeof(float),
+				width * sizeof(float), height, cudaMemcpyHostToDevice), "cudaMemcpy2DToArray", outErrMsg))
+			return false;
+	}
+	else {
+		const cudaExtent extent = make_cudaExtent(width, height, _data.AxisSize(2));
+		cudaMemcpy3DParms copy = {};
+		copy.srcPtr = make_cudaPitchedPtr(const_cast<float*>(values.data()), width * sizeof(float),
+			width, height);
+		copy.extent = extent;
+		copy.kind = cudaMemcpyHostToDevice;
+		if (!CheckCuda(cudaMalloc3DArray(&_array, &channel, extent), "cudaMalloc3DArray", outErrMsg))
+			return false;
+		copy.dstArray = _array;
+		if (!CheckCuda(cudaMemcpy3D(&copy), "cudaMemcpy3D", outErrMsg))
+			return false;
+	}
+
+	cudaResourceDesc resource = {};
+	resource.resType = cudaResourceTypeArray;
+	resource.res.array.array = _array;
+	cudaTextureDesc texture = {};
+	for (size_t i = 0; i < 3; i++) {
+		texture.addressMode[i] = cudaAddressModeClamp;
+	}
+	texture.filterMode = cudaFilterModeLinear;
+	texture.readMode = cudaReadModeElementType;
+	texture.normalizedCoords = 0;
+	return CheckCuda(cudaCreateTextureObject(&_texture, &resource, &texture, nullptr),
+		"cudaCreateTextureObject", outErrMsg);
+}
+// ==== End Section: Helpers (Protected) ==== //
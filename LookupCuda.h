@@ -0,0 +1,150 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+// This file is part of LookupTable <https://github.com/zjldemers/LookupTable>.
+// 
+// MIT License
+// Copyright (c) 2022 Zachary J. L. Demers
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef _ZJLD_LOOKUP_CUDA_H_
+#define _ZJLD_LOOKUP_CUDA_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <cuda_runtime_api.h>
+#include "LookupDevice.h"
+#include "LookupTableND.h"
+
+
+namespace zjld // feel free to remove/rename as the license above allows
+{
+
+	// This class is a copy of a LookupTableND in the memory of a CUDA device, evaluating
+	// batches whose inputs and outputs are already on that device (e.g. the points of a
+	// Monte Carlo run generated there), so that nothing is copied back to the host per
+	// point.  The table's data is uploaded once by Upload, after which the table itself is
+	// no longer needed.  Only built when the CMake option ZJLD_LOOKUP_CUDA is on (or when
+	// compiling LookupCuda.cu with nvcc some other way, with --fmad=false and
+	// --expt-relaxed-constexpr).
+	// By default each point is interpolated by device::EvaluatePoint, with results
+	// bit-identical to LookupTableND::QueryBatchByValues.  Options::hardwareInterpolation
+	// instead stores the dependent data of a 2D or 3D table in a texture and lets the
+	// texture units interpolate the cell once its position has been found the same way,
+	// which saves the corner loads and arithmetic at the cost of precision: the values are
+	// rounded to float, and the hardware's interpolation weights have 8 fractional bits,
+	// so results are within about 1/256 of the range of the cell's corner values of the
+	// exact ones.
+	// Batches are asynchronous on the given stream, and any number of them may run at once
+	// (the device copy is read-only).  Upload and Reset must not run while any batch that
+	// uses the table is still running.
+	class LookupTableCuda
+	{
+	public:
+		struct Options {
+			bool hardwareInterpolation; // interpolate by texture (2D and 3D only, see above)
+
+			Options() : hardwareInterpolation{ false } {}
+		};
+
+	protected:
+		LookupDeviceData _data;   // host copy of what was uploaded (see LookupDeviceData)
+		device::TableView _view;  // _data as uploaded (device pointers)
+		double* _deviceAxes;      // breakpoints on the device
+		double* _deviceDepData;   // dependent data on the device (null if by texture)
+		cudaArray_t _array;       // dependent data as float (only if by texture)
+		cudaTextureObject_t _texture; // filtered reads of _array (0 if not by texture)
+		Options _options;         // how the table was uploaded
+		bool _valid;              // true once uploaded
+
+	public:
+		// Threads per block of the batch kernels
+		static const unsigned int kBlockSize = 256;
+
+	// ==== Begin Section: Construction/Destruction (Public) ==== //
+		LookupTableCuda();
+		~LookupTableCuda();
+		LookupTableCuda(const LookupTableCuda&) = delete;
+		LookupTableCuda& operator=(const LookupTableCuda&) = delete;
+
+		/* Copies aTable to the current CUDA device (replacing any previous copy), returning
+		* false with a description of the reason in outErrMsg if it cannot be used there
+		* (e.g. invalid, cubic, paged or lazy tables, or more than device::kMaxDimensions
+		* dimensions, see LookupDeviceData) or the copy fails.  Hardware interpolation also
+		* needs a 2D or 3D table without any Extrapolate bound policy (as textures cannot
+		* extrapolate).  The table is left invalid on failure.
+		*/
+		bool Upload(const LookupTableND& aTable,
+			std::string* outErrMsg);
+		bool Upload(const LookupTableND& aTable,
+			const Options& aOptions,
+			std::string* outErrMsg);
+
+		/* Frees the device copy, leaving the table invalid.
+		*/
+		void Reset();
+	// ==== End Section: Construction/Destruction (Public) ==== //
+
+
+
+	// ==== Begin Section: Batch Lookup Methods (Public) ==== //
+		/* The device equivalent of LookupTableND::QueryBatchByValues: aDimValues holds one
+		* device pointer per dimension, each to aCount contiguous values, and outValues
+		* (aCount values) and outValidMask (utils::BatchMaskWords(aCount) words, or null
+		* if not needed) are device memory, filled as the host batch would fill them.
+		* The batch is queued on aStream without waiting for it, so the results may only be
+		* read once the stream has reached that point (e.g. after cudaStreamSynchronize).
+		* Returns false with a reason in outErrMsg if the batch could not be queued (e.g.
+		* an invalid table, the wrong number of dimensions, or a null pointer), in which
+		* case nothing was written.
+		*/
+		bool QueryBatchByValues(const std::vector<const double*>& aDimValues,
+			const size_t& aCount,
+			double* outValues,
+			uint64_t* outValidMask,
+			std::string* outErrMsg,
+			cudaStream_t aStream = 0) const;
+	// ==== End Section: Batch Lookup Methods (Public) ==== //
+
+
+
+	// ==== Begin Section: Metadata (Public) ==== //
+		bool Valid() const;
+		size_t Dimensions() const;
+		bool HardwareInterpolation() const; // true if uploaded by texture
+		size_t DeviceBytes() const;         // device memory used by the copy
+	// ==== End Section: Metadata (Public) ==== //
+
+	protected:
+		/* Returns false with a description of aError in outErrMsg (if not null) unless it
+		* is cudaSuccess, with aWhat naming the failed step.
+		*/
+		static bool CheckCuda(const cudaError_t& aError,
+			const char* aWhat,
+			std::string* outErrMsg);
+
+		/* Uploads _data's dependent data as a float texture with linear filtering.
+		*/
+		bool UploadTexture(std::string* outErrMsg);
+	};
+}
+
+#endif // _ZJLD_LOOKUP_CUDA_H_
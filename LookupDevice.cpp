@@ -0,0 +1,125 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+// This file is part of LookupTable <https://github.com/zjldemers/LookupTable>.
+// 
+// MIT License
+// Copyright (c) 2022 Zachary J. L. Demers
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "LookupDevice.h"
+#include "LookupTableND.h"
+
+using namespace zjld; // feel free to remove/rename as the license above allows
+using std::vector;
+using utils::ErrorCode;
+
+
+// ==== Begin Section: Construction (Public) ==== //
+LookupDeviceData::LookupDeviceData()
+	: _axes{}
+	, _depData{}
+	, _layout{}
+	, _valid{ false }
+{}
+
+ErrorCode LookupDeviceData::Build(const LookupTableND& aTable)
+{
+	static_assert(device::kMaxDimensions == LookupTableND::kMaxFastDimensions,
+		"Mismatched dimension limits.");
+	Reset();
+	if (!aTable.Valid())
+		return ErrorCode::InvalidTable;
+	const size_t kInSize = aTable._indepData.size(); // shorthand
+	if (kInSize > device::kMaxDimensions || aTable._reader || !aTable._derivData.empty())
+		return ErrorCode::Unsupported; // (only linear interpolation of data held in memory)
+
+	_layout.dims = kInSize;
+	for (size_t i = 0; i < kInSize; i++) {
+		const TableData& breakpoints = aTable._indepData[i];
+		_axes.insert(_axes.end(), breakpoints.begin(), breakpoints.end());
+		_layout.axisSizes[i] = breakpoints.size();
+		_layout.strides[i] = aTable._strides[i];
+		_layout.bounds[i] = aTable._axes[i].Bounds();
+	}
+	_depData = aTable.LogicalDepData();
+	_valid = true;
+	return ErrorCode::None;
+}
+
+void LookupDeviceData::Reset()
+{
+	_axes.clear();
+	_depData.clear();
+	_layout = device::TableView{};
+	_valid = false;
+}
+// ==== End Section: Construction (Public) ==== //
+
+
+
+
+// ==== Begin Section: Views (Public) ==== //
+device::TableView LookupDeviceData::View(const double* aAxes,
+	const double* aDepData) const
+{
+	device::TableView view = _layout;
+	for (size_t i = 0, offset = 0; i < view.dims; i++) {
+		view.axes[i] = aAxes + offset;
+		offset += view.axisSizes[i];
+	}
+	view.depData = aDepData;
+	return view;
+}
+
+device::TableView LookupDeviceData::HostView() const
+{
+	return View(_axes.data(), _depData.data());
+}
+// ==== End Section: Views (Public) ==== //
+
+
+
+
+// ==== Begin Section: Metadata (Public) ==== //
+bool LookupDeviceData::Valid() const
+{
+	return _valid;
+}
+
+size_t LookupDeviceData::Dimensions() const
+{
+	return _layout.dims;
+}
+
+size_t LookupDeviceData::AxisSize(const size_t& aDimension) const
+{
+	return (aDimension < _layout.dims) ? _layout.axisSizes[aDimension] : 0;
+}
+
+const vector<double>& LookupDeviceData::AxisData() const
+{
+	return _axes;
+}
+
+const vector<double>& LookupDeviceData::DepData() const
+{
+	return _depData;
+}
+// ==== End Section: Metadata (Public) ==== //
@@ -0,0 +1,178 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+// This file is part of LookupTable <https://github.com/zjldemers/LookupTable>.
+// 
+// MIT License
+// Copyright (c) 2022 Zachary J. L. Demers
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef _ZJLD_LOOKUP_DEVICE_H_
+#define _ZJLD_LOOKUP_DEVICE_H_
+
+#include <cstddef>
+#include <vector>
+#include "LookupAxis.h"
+#include "LookupUtils.hpp"
+
+// Functions below are compiled for both the host and the device when built by nvcc (see
+// ZJLD_LOOKUP_HOST_DEVICE in LookupUtils.hpp), and are plain inline functions otherwise.
+
+
+namespace zjld // feel free to remove/rename as the license above allows
+{
+	class LookupTableND;
+
+	namespace device
+	{
+		// Maximum number of dimensions supported on the device (matches
+		// LookupTableND::kMaxFastDimensions)
+		static const size_t kMaxDimensions = 8;
+
+		// Flat description of a table's data for device code, in the same spirit as
+		// simd::BatchLayout, with every pointer in the memory space of the code using it.
+		// The dependent data is always Linear and double.
+		struct TableView {
+			size_t dims;                          // number of independent dimensions
+			const double* axes[kMaxDimensions];   // independent data per dimension
+			size_t axisSizes[kMaxDimensions];     // size of each independent data vector
+			size_t strides[kMaxDimensions];       // dependent data step per dimension
+			LookupAxis::BoundPolicy bounds[kMaxDimensions]; // out of bounds handling
+			const double* depData;                // dependent data
+		};
+
+		// Finds the low index and percent progress of aValue along aDimension of aView with
+		// LookupAxis::FindPosition (and so the same results as the tables), returning false
+		// if the bound policy rejects it
+		ZJLD_LOOKUP_HOST_DEVICE inline bool FindPosition(const TableView& aView,
+			const size_t aDimension,
+			const double aValue,
+			size_t* outLowIdx,
+			double* outPercProgress)
+		{
+			return LookupAxis::FindPosition(aView.axes[aDimension], aView.axisSizes[aDimension],
+				aView.bounds[aDimension], aValue, outLowIdx, outPercProgress);
+		}
+
+		// Interpolates the point given by aValues (one per dimension) in the table of
+		// aView, whose dimension count kDims must be aView.dims, with the corner order and
+		// arithmetic of LookupTableND::InterpolateCell, so that results are bit-identical as
+		// long as the compiler does not fuse multiplies and adds (nvcc's --fmad=false).
+		// Returns false if any value is rejected.  The corners take 1 << kDims values, so
+		// device code keeps only as many as the table needs (in registers for small tables).
+		template<size_t kDims>
+		ZJLD_LOOKUP_HOST_DEVICE inline bool EvaluatePoint(const TableView& aView,
+			const double* aValues,
+			double* outValue)
+		{
+			static_assert(kDims >= 2 && kDims <= kMaxDimensions, "Unsupported dimension count.");
+			size_t lowIdxs[kDims];
+			double prcPrgs[kDims];
+			size_t offset = 0;
+			for (size_t i = 0; i < kDims; i++) {
+				if (!FindPosition(aView, i, aValues[i], &lowIdxs[i], &prcPrgs[i]))
+					return false;
+				offset += lowIdxs[i] * aView.strides[i];
+			}
+
+			// Gather the corners (the last dimension being the least significant bit of
+			// each corner's number), then work down through them one dimension at a time
+			const size_t comboCount = static_cast<size_t>(1) << kDims;
+			double vals[comboCount];
+			for (size_t j = 0; j < comboCount; j++) {
+				size_t corner = offset;
+				for (size_t i = 0; i < kDims; i++) {
+					corner += ((j >> i) & 1) ? aView.strides[kDims - i - 1] : 0;
+				}
+				vals[j] = aView.depData[corner];
+			}
+			for (size_t i = 0, count = comboCount; i < kDims; i++, count >>= 1) {
+				const double prc = prcPrgs[kDims - i - 1];
+				for (size_t j = 1; j < count; j += 2) {
+					vals[j / 2] = utils::Lerp(vals[j - 1], vals[j], prc);
+				}
+			}
+			*outValue = vals[0];
+			return true;
+		}
+
+		// Selects the above for aView.dims (returning false if not between 2 and
+		// kMaxDimensions), e.g. to check a HostView on the host.  Kernels should call the
+		// template for their own dimension count instead, since with every case inlined
+		// their local memory may be sized for the corners of the largest.
+		ZJLD_LOOKUP_HOST_DEVICE inline bool EvaluatePoint(const TableView& aView,
+			const double* aValues,
+			double* outValue)
+		{
+			static_assert(kMaxDimensions == 8, "Update the cases below.");
+			switch (aView.dims) {
+			case 2: return EvaluatePoint<2>(aView, aValues, outValue);
+			case 3: return EvaluatePoint<3>(aView, aValues, outValue);
+			case 4: return EvaluatePoint<4>(aView, aValues, outValue);
+			case 5: return EvaluatePoint<5>(aView, aValues, outValue);
+			case 6: return EvaluatePoint<6>(aView, aValues, outValue);
+			case 7: return EvaluatePoint<7>(aView, aValues, outValue);
+			case 8: return EvaluatePoint<8>(aView, aValues, outValue);
+			default: return false;
+			}
+		}
+	}
+
+
+	// This class holds a host copy of a LookupTableND's data laid out for device code (see
+	// device::TableView): every dimension's breakpoints one after another, and the
+	// dependent data in its logical order as double (values stored as Float or BFloat16
+	// keep their rounding, so results match the table's).  Device backends such as
+	// LookupTableCuda upload these once, then describe the uploaded copies with View.
+	// HostView describes the host copies themselves, so that device::EvaluatePoint can
+	// be checked against the table on the host.
+	class LookupDeviceData
+	{
+	protected:
+		std::vector<double> _axes;      // every dimension's breakpoints in turn
+		std::vector<double> _depData;   // dependent data (Linear)
+		device::TableView _layout;      // sizes, strides and bounds (pointers unset)
+		bool _valid;                    // true once built from a valid table
+
+	public:
+		LookupDeviceData();
+
+		/* Copies the data of aTable, returning the reason if it cannot be used on devices:
+		* InvalidTable if it is not valid, and Unsupported for more than
+		* device::kMaxDimensions dimensions, cubic interpolation, or paged or lazy tables.
+		* This is left empty on failure.
+		*/
+		utils::ErrorCode Build(const LookupTableND& aTable);
+		void Reset();
+
+		/* Describes copies of AxisData() and DepData() at aAxes and aDepData.
+		*/
+		device::TableView View(const double* aAxes,
+			const double* aDepData) const;
+		device::TableView HostView() const;
+
+		bool Valid() const;
+		size_t Dimensions() const;
+		size_t AxisSize(const size_t& aDimension) const;
+		const std::vector<double>& AxisData() const;
+		const std::vector<double>& DepData() const;
+	};
+}
+
+#endif // _ZJLD_LOOKUP_DEVICE_H_
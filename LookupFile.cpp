@@ -0,0 +1,261 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+// This file is part of LookupTable <https://github.com/zjldemers/LookupTable>.
+// 
+// MIT License
+// Copyright (c) 2022 Zachary J. L. Demers
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "LookupFile.h"
+#include <cstring>
+#include <fstream>
+#if defined(_WIN32)
+	#ifndef NOMINMAX
+		#define NOMINMAX
+	#endif
+	#include <windows.h>
+#elif defined(__unix__) || defined(__APPLE__)
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+	#define ZJLD_LOOKUP_POSIX_MMAP
+#endif
+
+using namespace zjld; // feel free to remove/rename as the license above allows
+using namespace zjld::file;
+
+
+namespace
+{
+	const char kMagic[8] = { 'Z', 'J', 'L', 'D', 'L', 'U', 'T', '\0' };
+
+	bool FitsInFile(const uint64_t& aOffset, const uint64_t& aBytes, const size_t& aFileBytes)
+	{
+		return aOffset <= aFileBytes && aBytes <= aFileBytes - aOffset;
+	}
+}
+
+
+
+
+Header file::EmptyHeader()
+{
+	Header header;
+	std::memset(&header, 0, sizeof(header));
+	std::memcpy(header.magic, kMagic, sizeof(kMagic));
+	header.version = kVersion;
+	header.byteOrder = kByteOrderMark;
+	header.headerBytes = static_cast<uint32_t>(kHeaderBytes);
+	return header;
+}
+
+std::string file::CheckHeader(const Header& aHeader, const size_t& aFileBytes)
+{
+	if (std::memcmp(aHeader.magic, kMagic, sizeof(kMagic)) != 0) {
+		return "Not a binary lookup table file.";
+	}
+	if (aHeader.byteOrder != kByteOrderMark) {
+		return "The file was written on a machine of a different byte order.";
+	}
+	if (aHeader.version != kVersion) {
+		return "Unsupported binary lookup table version " + std::to_string(aHeader.version) + ".";
+	}
+	if (aHeader.headerBytes != kHeaderBytes) {
+		return "Unexpected header size.";
+	}
+	if (!FitsInFile(aHeader.axesOffset, aHeader.axesBytes, aFileBytes)
+		|| !FitsInFile(aHeader.depOffset, aHeader.depBytes, aFileBytes)) {
+		return "The file is truncated.";
+	}
+	if (aHeader.axesOffset % sizeof(uint64_t) != 0 || aHeader.axesBytes % sizeof(uint64_t) != 0
+		|| aHeader.depOffset % kAlignment != 0 || aHeader.depBytes % sizeof(uint64_t) != 0) {
+		return "The file's blocks are misaligned.";
+	}
+	return {};
+}
+
+uint64_t file::Checksum(const void* aData, const size_t& aBytes, uint64_t aHash)
+{
+	const uint64_t prime = 0x100000001b3ull;
+	const unsigned char* data = static_cast<const unsigned char*>(aData);
+	const size_t words = aBytes / sizeof(uint64_t);
+	for (size_t i = 0; i < words; ++i) {
+		uint64_t word = 0;
+		if (data) {
+			std::memcpy(&word, data + i * sizeof(uint64_t), sizeof(word));
+		}
+		aHash = (aHash ^ word) * prime;
+	}
+	const size_t tail = aBytes % sizeof(uint64_t);
+	if (tail) {
+		uint64_t word = 0;
+		if (data) {
+			std::memcpy(&word, data + words * sizeof(uint64_t), tail);
+		}
+		aHash = (aHash ^ word) * prime;
+	}
+	return aHash;
+}
+
+size_t file::AlignUp(const size_t& aValue)
+{
+	return (aValue + kAlignment - 1) / kAlignment * kAlignment;
+}
+
+
+
+
+// ==== Begin Section: MappedFile (Public) ==== //
+MappedFile::MappedFile()
+	: _data{ nullptr }
+	, _size{ 0 }
+	, _mapped{ false }
+	, _buffer{}
+#if defined(_WIN32)
+	, _fileHandle{ nullptr }
+	, _mappingHandle{ nullptr }
+#endif
+{}
+
+MappedFile::~MappedFile()
+{
+	if (!_mapped) {
+		return;
+	}
+#if defined(_WIN32)
+	UnmapViewOfFile(_data);
+	CloseHandle(static_cast<HANDLE>(_mappingHandle));
+	CloseHandle(static_cast<HANDLE>(_fileHandle));
+#elif defined(ZJLD_LOOKUP_POSIX_MMAP)
+	munmap(const_cast<unsigned char*>(_data), _size);
+#endif
+}
+
+std::shared_ptr<MappedFile> MappedFile::Open(const std::string& aPath,
+	const bool& aMap,
+	std::string* outErrMsg)
+{
+	std::shared_ptr<MappedFile> result{ new MappedFile };
+	std::string errMsg;
+#if defined(_WIN32)
+	if (aMap) {
+		HANDLE fileHandle = CreateFileA(aPath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+			OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		LARGE_INTEGER size;
+		if (fileHandle == INVALID_HANDLE_VALUE) {
+			errMsg = "Unable to open " + aPath + ".";
+		} else if (!GetFileSizeEx(fileHandle, &size) || size.QuadPart <= 0) {
+			errMsg = "Unable to map " + aPath + " (empty or unreadable).";
+			CloseHandle(fileHandle);
+		} else {
+			HANDLE mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			const void* view = mappingHandle ? MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0) : nullptr;
+			if (!view) {
+				errMsg = "Unable to map " + aPath + ".";
+				if (mappingHandle) {
+					CloseHandle(mappingHandle);
+				}
+				CloseHandle(fileHandle);
+			} else {
+				result->_data = static_cast<const unsigned char*>(view);
+				result->_size = static_cast<size_t>(size.QuadPart);
+				result->_mapped = true;
+				result->_fileHandle = fileHandle;
+				result->_mappingHandle = mappingHandle;
+				return result;
+			}
+		}
+		if (outErrMsg) {
+			*outErrMsg = errMsg;
+		}
+		return nullptr;
+	}
+#elif defined(ZJLD_LOOKUP_POSIX_MMAP)
+	if (aMap) {
+		const int fd = open(aPath.c_str(), O_RDONLY);
+		struct stat info;
+		if (fd < 0) {
+			errMsg = "Unable to open " + aPath + ".";
+		} else if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+			errMsg = "Unable to map " + aPath + " (empty or unreadable).";
+			close(fd);
+		} else {
+			const size_t size = static_cast<size_t>(info.st_size);
+			void* view = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+			close(fd); // the mapping keeps the file referenced
+			if (view == MAP_FAILED) {
+				errMsg = "Unable to map " + aPath + ".";
+			} else {
+				result->_data = static_cast<const unsigned char*>(view);
+				result->_size = size;
+				result->_mapped = true;
+				return result;
+			}
+		}
+		if (outErrMsg) {
+			*outErrMsg = errMsg;
+		}
+		return nullptr;
+	}
+#endif
+
+	// read the whole file instead (uint64_t buffer for the alignment of the blocks)
+	std::ifstream stream{ aPath, std::ios::binary | std::ios::ate };
+	if (!stream) {
+		if (outErrMsg) {
+			*outErrMsg = "Unable to open " + aPath + ".";
+		}
+		return nullptr;
+	}
+	const std::streamoff size = stream.tellg();
+	if (size <= 0) {
+		if (outErrMsg) {
+			*outErrMsg = "Unable to read " + aPath + " (empty or unreadable).";
+		}
+		return nullptr;
+	}
+	result->_size = static_cast<size_t>(size);
+	result->_buffer.resize((result->_size + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+	stream.seekg(0);
+	if (!stream.read(reinterpret_cast<char*>(result->_buffer.data()), size)) {
+		if (outErrMsg) {
+			*outErrMsg = "Unable to read " + aPath + ".";
+		}
+		return nullptr;
+	}
+	result->_data = reinterpret_cast<const unsigned char*>(result->_buffer.data());
+	return result;
+}
+
+const unsigned char* MappedFile::Data() const
+{
+	return _data;
+}
+
+size_t MappedFile::Size() const
+{
+	return _size;
+}
+
+bool MappedFile::Mapped() const
+{
+	return _mapped;
+}
@@ -0,0 +1,143 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+// This file is part of LookupTable <https://github.com/zjldemers/LookupTable>.
+// 
+// MIT License
+// Copyright (c) 2022 Zachary J. L. Demers
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef _ZJLD_LOOKUP_FILE_H_
+#define _ZJLD_LOOKUP_FILE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace zjld // feel free to remove/rename as the license above allows
+{
+
+	// How a table is populated from a binary file (see LookupTableND::LoadBinary):
+	// - Copy: the file is read into the table's own memory (and its checksum verified)
+	// - Map: the file is memory mapped read-only and the dependent data is used directly
+	//   from the mapped pages, so loading takes the same time regardless of the table's
+	//   size and processes mapping the same file share its pages in memory
+	enum class FileMode { Copy, Map };
+
+
+	namespace file
+	{
+		// Binary table format (version 1), with all values in the byte order of the machine
+		// that wrote the file (files from a machine of the other byte order are rejected):
+		// - Header: the Header struct below (kHeaderBytes bytes)
+		// - Axes block (at axesOffset): one uint64 size per dimension followed by every
+		//   dimension's breakpoints as doubles, in dimension order
+		// - Dependent block (at depOffset, a multiple of kAlignment): depCount values of the
+		//   given storage type in the given layout (exactly as stored by the table, including
+		//   any tiling padding)
+		// Both blocks are zero padded up to a multiple of kAlignment bytes, and the dependent
+		// block is always followed by at least one value of padding (see LookupStorage::Data).
+		// The checksum is a 64-bit FNV-1a hash over the 64-bit words of the axes block
+		// followed by the dependent block.
+		static const uint32_t kVersion = 1;
+		static const uint32_t kByteOrderMark = 0x01020304;
+		static const size_t kHeaderBytes = 128;
+		static const size_t kAlignment = 64;
+
+		struct Header
+		{
+			char magic[8];        // "ZJLDLUT" (null terminated)
+			uint32_t version;     // kVersion
+			uint32_t byteOrder;   // kByteOrderMark as written by the creating machine
+			uint32_t headerBytes; // kHeaderBytes
+			uint32_t dimensions;  // number of independent dimensions
+			uint32_t storageType; // StorageType of the dependent data
+			uint32_t dataLayout;  // TableOptions::DataLayout of the dependent data
+			uint64_t tileSize;    // TableOptions::tileSize (Tiled only)
+			uint64_t axesOffset;  // file position of the axes block
+			uint64_t axesBytes;   // size of the axes block (including padding)
+			uint64_t depOffset;   // file position of the dependent block
+			uint64_t depCount;    // number of dependent values stored
+			uint64_t depBytes;    // size of the dependent block (including padding)
+			uint64_t checksum;    // see above
+			uint8_t reserved[kHeaderBytes - 88]; // zero
+		};
+		static_assert(sizeof(Header) == kHeaderBytes, "Unexpected binary header size.");
+
+		/* This returns a Header with every field that does not depend on the table filled
+		* in (magic, version, byte order and header size) and all others zero.
+		*/
+		Header EmptyHeader();
+
+		/* This returns the error in aHeader (e.g. not a table file, unsupported version,
+		* blocks outside of the file) or an empty string if none, given the file's size.
+		*/
+		std::string CheckHeader(const Header& aHeader,
+			const size_t& aFileBytes);
+
+		/* This continues the FNV-1a checksum aHash over aBytes bytes at aData (if aData is
+		* null, aBytes of zeros), zero extending a final partial word.  The checksum of
+		* nothing is kChecksumSeed.
+		*/
+		static const uint64_t kChecksumSeed = 0xcbf29ce484222325ull;
+		uint64_t Checksum(const void* aData,
+			const size_t& aBytes,
+			uint64_t aHash);
+
+		/* Rounds aValue up to the next multiple of kAlignment.
+		*/
+		size_t AlignUp(const size_t& aValue);
+
+
+		// A read-only view of a whole file's contents, which is either memory mapped or read
+		// into memory (if mapping is not requested or not supported on this platform).
+		class MappedFile
+		{
+			const unsigned char* _data;
+			size_t _size;
+			bool _mapped;
+			std::vector<uint64_t> _buffer; // contents if not mapped
+		#if defined(_WIN32)
+			void* _fileHandle;
+			void* _mappingHandle;
+		#endif
+
+			MappedFile();
+
+		public:
+			~MappedFile();
+			MappedFile(const MappedFile&) = delete;
+			MappedFile& operator=(const MappedFile&) = delete;
+
+			/* This opens aPath, returning null (with a reason in outErrMsg) on failure.
+			*/
+			static std::shared_ptr<MappedFile> Open(const std::string& aPath,
+				const bool& aMap,
+				std::string* outErrMsg);
+
+			const unsigned char* Data() const;
+			size_t Size() const;
+			bool Mapped() const; // false if read into memory instead
+		};
+	}
+}
+
+#endif // _ZJLD_LOOKUP_FILE_H_
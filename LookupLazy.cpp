@@ -0,0 +1,263 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+// This file is part of LookupTable <https://github.com/zjldemers/LookupTable>.
+// 
+// MIT License
+// Copyright (c) 2022 Zachary J. L. Demers
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "LookupLazy.h"
+#include "LookupFile.h"
+#include <cstring>
+#include <limits>
+
+using namespace zjld; // feel free to remove/rename as the license above allows
+
+
+namespace
+{
+	const char kMagic[8] = { 'Z', 'J', 'L', 'D', 'L', 'Z', 'Y', '\0' };
+	const uint32_t kVersion = 1;
+
+	struct TileFileHeader
+	{
+		char magic[8];
+		uint32_t version;
+		uint32_t byteOrder;
+		uint64_t tileSize;
+		uint64_t dimensions;
+		uint64_t gridChecksum;
+		uint8_t reserved[LazyTiles::kHeaderBytes - 40];
+	};
+	static_assert(sizeof(TileFileHeader) == LazyTiles::kHeaderBytes, "Unexpected tile file header size.");
+}
+
+
+
+
+// ==== Begin Section: Construction/Destruction (Public) ==== //
+LazyTiles::LazyTiles()
+	: _axes{}
+	, _tileSize{ 0 }
+	, _tileVolume{ 0 }
+	, _tileCounts{}
+	, _generator{}
+	, _tiles{}
+	, _once{}
+	, _tileCount{ 0 }
+	, _filled{ 0 }
+	, _file{}
+	, _fileMutex{}
+{}
+
+LazyTiles::~LazyTiles()
+{
+	for (size_t i = 0; i < _tileCount; i++) {
+		delete[] _tiles[i].load(std::memory_order_relaxed);
+	}
+}
+
+std::shared_ptr<LazyTiles> LazyTiles::Create(const TableDataSet& aIndepData,
+	const size_t& aTileSize,
+	const DepDataGenerator& aGenerator,
+	const LazyOptions& aOptions,
+	std::string* outErrMsg)
+{
+	std::shared_ptr<LazyTiles> result{ new LazyTiles };
+	result->_axes = aIndepData;
+	result->_tileSize = aTileSize;
+	result->_tileVolume = 1;
+	result->_tileCount = 1;
+	for (const TableData& breakpoints : aIndepData) {
+		result->_tileVolume *= aTileSize;
+		result->_tileCounts.push_back((breakpoints.size() + aTileSize - 1) / aTileSize);
+		result->_tileCount *= result->_tileCounts.back();
+	}
+	result->_generator = aGenerator;
+	result->_tiles.reset(new std::atomic<const double*>[result->_tileCount]);
+	for (size_t i = 0; i < result->_tileCount; i++) {
+		result->_tiles[i].store(nullptr, std::memory_order_relaxed);
+	}
+	result->_once.reset(new std::once_flag[result->_tileCount]);
+	if (!aOptions.tileFile.empty() && !result->OpenFile(aOptions.tileFile, outErrMsg))
+		return nullptr;
+	return result;
+}
+// ==== End Section: Construction/Destruction (Public) ==== //
+
+
+
+
+// ==== Begin Section: Reading (Public) ==== //
+bool LazyTiles::Read(const size_t* aPositions,
+	const size_t& aCount,
+	double* outValues)
+{
+	for (size_t i = 0; i < aCount; i++) {
+		outValues[i] = Tile(aPositions[i] / _tileVolume)[aPositions[i] % _tileVolume];
+	}
+	return false;
+}
+
+size_t LazyTiles::MemoryBytes() const
+{
+	return FilledTiles() * _tileVolume * sizeof(double)
+		+ _tileCount * (sizeof(std::atomic<const double*>) + sizeof(std::once_flag));
+}
+
+size_t LazyTiles::TileCount() const
+{
+	return _tileCount;
+}
+
+size_t LazyTiles::FilledTiles() const
+{
+	return _filled.load(std::memory_order_relaxed);
+}
+// ==== End Section: Reading (Public) ==== //
+
+
+
+
+// ==== Begin Section: Helpers (Private) ==== //
+const double* LazyTiles::Tile(const size_t& aTile)
+{
+	const double* values = _tiles[aTile].load(std::memory_order_acquire);
+	if (!values) {
+		std::call_once(_once[aTile], &LazyTiles::Fill, this, aTile);
+		values = _tiles[aTile].load(std::memory_order_acquire);
+	}
+	return values;
+}
+
+void LazyTiles::Fill(const size_t& aTile)
+{
+	// Walk the tile in storage order (dimension 0 fastest), from its first grid point
+	const size_t kInSize = _axes.size(); // shorthand
+	std::vector<size_t> first(kInSize), local(kInSize, 0);
+	std::vector<double> point(kInSize);
+	for (size_t i = 0, rest = aTile; i < kInSize; i++) {
+		first[i] = (rest % _tileCounts[i]) * _tileSize;
+		rest /= _tileCounts[i];
+	}
+	std::unique_ptr<double[]> values(new double[_tileVolume]);
+	for (size_t pos = 0; pos < _tileVolume; pos++) {
+		bool inside = true;
+		for (size_t i = 0; inside && i < kInSize; i++) {
+			const size_t idx = first[i] + local[i];
+			inside = idx < _axes[i].size();
+			point[i] = inside ? _axes[i][idx] : 0.0;
+		}
+		values[pos] = inside ? _generator(point.data()) : std::numeric_limits<double>::quiet_NaN();
+		for (size_t i = 0; i < kInSize && ++local[i] == _tileSize; i++) {
+			local[i] = 0;
+		}
+	}
+
+	if (_file.is_open()) {
+		// (a tile that fails to be written is still used, it is just generated again next run)
+		std::lock_guard<std::mutex> lock(_fileMutex);
+		const uint64_t number = aTile;
+		_file.write(reinterpret_cast<const char*>(&number), sizeof(number));
+		_file.write(reinterpret_cast<const char*>(values.get()), _tileVolume * sizeof(double));
+		_file.flush();
+	}
+	_tiles[aTile].store(values.release(), std::memory_order_release);
+	_filled.fetch_add(1, std::memory_order_relaxed);
+}
+
+uint64_t LazyTiles::GridChecksum() const
+{
+	uint64_t hash = file::kChecksumSeed;
+	for (const TableData& breakpoints : _axes) {
+		const uint64_t size = breakpoints.size();
+		hash = file::Checksum(&size, sizeof(size), hash);
+	}
+	for (const TableData& breakpoints : _axes) {
+		hash = file::Checksum(breakpoints.data(), breakpoints.size() * sizeof(double), hash);
+	}
+	return hash;
+}
+
+bool LazyTiles::OpenFile(const std::string& aPath,
+	std::string* outErrMsg)
+{
+	TileFileHeader expected;
+	std::memset(&expected, 0, sizeof(expected));
+	std::memcpy(expected.magic, kMagic, sizeof(kMagic));
+	expected.version = kVersion;
+	expected.byteOrder = file::kByteOrderMark;
+	expected.tileSize = _tileSize;
+	expected.dimensions = _axes.size();
+	expected.gridChecksum = GridChecksum();
+
+	// Read back every complete record of a file written for this same grid
+	const size_t recordBytes = sizeof(uint64_t) + _tileVolume * sizeof(double);
+	uint64_t fileBytes = 0, validBytes = 0;
+	{
+		std::ifstream stream{ aPath, std::ios::binary | std::ios::ate };
+		if (stream) {
+			fileBytes = static_cast<uint64_t>(stream.tellg());
+			stream.seekg(0);
+		}
+		TileFileHeader header;
+		if (stream && stream.read(reinterpret_cast<char*>(&header), sizeof(header))
+			&& std::memcmp(&header, &expected, sizeof(header)) == 0) {
+			validBytes = sizeof(header);
+			std::unique_ptr<double[]> values(new double[_tileVolume]);
+			uint64_t number;
+			while (stream.read(reinterpret_cast<char*>(&number), sizeof(number))
+				&& stream.read(reinterpret_cast<char*>(values.get()), _tileVolume * sizeof(double))
+				&& number < _tileCount) {
+				if (!_tiles[number].load(std::memory_order_relaxed)) {
+					_tiles[number].store(values.release(), std::memory_order_relaxed);
+					_filled.fetch_add(1, std::memory_order_relaxed);
+					values.reset(new double[_tileVolume]);
+				}
+				validBytes += recordBytes;
+			}
+		}
+	}
+
+	// Append to the file if all of it was read back, or else write it again from what was
+	// (a new file, one for another grid, or one ending with a partial record)
+	const bool rewrite = validBytes == 0 || validBytes != fileBytes;
+	_file.open(aPath, std::ios::binary | (rewrite ? std::ios::trunc : std::ios::app));
+	if (rewrite && _file) {
+		_file.write(reinterpret_cast<const char*>(&expected), sizeof(expected));
+		for (size_t i = 0; i < _tileCount; i++) {
+			const double* values = _tiles[i].load(std::memory_order_relaxed);
+			if (values) {
+				const uint64_t number = i;
+				_file.write(reinterpret_cast<const char*>(&number), sizeof(number));
+				_file.write(reinterpret_cast<const char*>(values), _tileVolume * sizeof(double));
+			}
+		}
+		_file.flush();
+	}
+	if (!_file) {
+		if (outErrMsg) {
+			*outErrMsg = "Unable to write " + aPath + ".";
+		}
+		return false;
+	}
+	return true;
+}
+// ==== End Section: Helpers (Private) ==== //
@@ -0,0 +1,135 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+// This file is part of LookupTable <https://github.com/zjldemers/LookupTable>.
+// 
+// MIT License
+// Copyright (c) 2022 Zachary J. L. Demers
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef _ZJLD_LOOKUP_LAZY_H_
+#define _ZJLD_LOOKUP_LAZY_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "LookupAxis.h"
+#include "LookupStorage.h"
+
+namespace zjld // feel free to remove/rename as the license above allows
+{
+
+	// This computes the dependent value at one point of a table's grid (see
+	// LookupTableND::PopulateLazy), given as one breakpoint per dimension at aPoint.  It may
+	// be called from any thread that looks up the table, but only ever once per point (and
+	// never for two points of the same tile at once), and must not throw.
+	typedef std::function<double(const double* aPoint)> DepDataGenerator;
+
+
+	// This holds the options of a table whose dependent data is generated as lookups need
+	// it (see LookupTableND::PopulateLazy).
+	struct LazyOptions
+	{
+		// If not empty, every tile generated is also appended to this file, and the tiles
+		// already in it are read back when populating, so that each point is only ever
+		// generated once across runs (see LazyTiles for the format).  A file written for a
+		// different grid or tile size is replaced.
+		std::string tileFile;
+
+		LazyOptions() : tileFile{} {}
+	};
+
+
+	// This class holds the dependent data of a table in Tiled order (see
+	// TableOptions::DataLayout), where each tile is only generated, one value per point of
+	// the grid through a DepDataGenerator, the first time any of its values is read.  Tiles
+	// are generated exactly once even when many threads read them at once (each waiting
+	// only for the tiles it reads), and memory is only used for those generated along with
+	// a small index entry per tile.
+	// Tile files are the byte order of the machine writing them: a header of kHeaderBytes
+	// (magic "ZJLDLZY", version, byte order mark, tile size, number of dimensions, then a
+	// 64-bit FNV-1a checksum of the grid's sizes and breakpoints), followed by one record
+	// per tile generated: its tile number (uint64) and then its values in storage order
+	// (doubles, NaN padded beyond the grid).  A partial record left by an interrupted write
+	// is dropped.
+	class LazyTiles : public DepDataReader
+	{
+		TableDataSet _axes;         // breakpoints of every dimension
+		size_t _tileSize;           // tile edge length
+		size_t _tileVolume;         // values per tile (tileSize^N)
+		std::vector<size_t> _tileCounts; // tiles along each dimension
+		DepDataGenerator _generator;
+
+		std::unique_ptr<std::atomic<const double*>[]> _tiles; // values of each tile (or null)
+		std::unique_ptr<std::once_flag[]> _once; // generates each tile
+		size_t _tileCount;
+		std::atomic<size_t> _filled; // tiles generated or read from the tile file
+
+		std::ofstream _file;   // tile file appended to (if not open, tiles are not saved)
+		std::mutex _fileMutex; // guards _file
+
+		LazyTiles();
+		const double* Tile(const size_t& aTile);
+		void Fill(const size_t& aTile);
+		uint64_t GridChecksum() const;
+		bool OpenFile(const std::string& aPath,
+			std::string* outErrMsg);
+
+	public:
+		static const size_t kHeaderBytes = 64;
+
+		~LazyTiles();
+		LazyTiles(const LazyTiles&) = delete;
+		LazyTiles& operator=(const LazyTiles&) = delete;
+
+		/* This creates the (empty) tiles of a grid with the given breakpoints along each
+		* dimension and tile edge length aTileSize (at least 2), reading back those in the
+		* tile file of aOptions if any.  It returns null (with a reason in outErrMsg) if
+		* the tile file cannot be opened or written.
+		*/
+		static std::shared_ptr<LazyTiles> Create(const TableDataSet& aIndepData,
+			const size_t& aTileSize,
+			const DepDataGenerator& aGenerator,
+			const LazyOptions& aOptions,
+			std::string* outErrMsg);
+
+		/* This returns the values at the given positions (see DepDataReader), generating
+		* their tiles first where needed.  It always returns false, since nothing can be
+		* generated ahead of being needed.
+		*/
+		bool Read(const size_t* aPositions,
+			const size_t& aCount,
+			double* outValues) override;
+
+		/* This returns the memory used by the generated tiles and the index.
+		*/
+		size_t MemoryBytes() const override;
+
+		size_t TileCount() const;   // number of tiles in the grid
+		size_t FilledTiles() const; // number of those generated (or read back) so far
+	};
+}
+
+#endif // _ZJLD_LOOKUP_LAZY_H_
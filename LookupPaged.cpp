@@ -0,0 +1,399 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+// This file is part of LookupTable <https://github.com/zjldemers/LookupTable>.
+// 
+// MIT License
+// Copyright (c) 2022 Zachary J. L. Demers
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "LookupPaged.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#if defined(_WIN32)
+	#ifndef NOMINMAX
+		#define NOMINMAX
+	#endif
+	#include <windows.h>
+#elif defined(__unix__) || defined(__APPLE__)
+	#include <fcntl.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+	#define ZJLD_LOOKUP_POSIX_PREAD
+#endif
+
+using namespace zjld; // feel free to remove/rename as the license above allows
+
+
+namespace
+{
+	// Reads one value of type T at aBytes, which need not be aligned for it
+	template<typename T>
+	double ValueAt(const unsigned char* aBytes)
+	{
+		T value;
+		std::memcpy(&value, aBytes, sizeof(value));
+		return LookupStorage::ToDouble(value);
+	}
+}
+
+
+
+
+// ==== Begin Section: PageStats (Public) ==== //
+PageStats::PageStats()
+	: hits{ 0 }
+	, misses{ 0 }
+	, prefetches{ 0 }
+	, prefetchHits{ 0 }
+	, evictions{ 0 }
+	, readErrors{ 0 }
+	, residentPages{ 0 }
+{}
+
+double PageStats::HitRate() const
+{
+	const uint64_t reads = hits + misses;
+	return reads ? static_cast<double>(hits) / static_cast<double>(reads) : 0.0;
+}
+// ==== End Section: PageStats (Public) ==== //
+
+
+
+
+// ==== Begin Section: Construction/Destruction (Public) ==== //
+PageCache::PageCache()
+#if defined(_WIN32)
+	: _fileHandle{ nullptr }
+#else
+	: _fd{ -1 }
+#endif
+	, _stream{}
+	, _streamMutex{}
+	, _fileBytes{ 0 }
+	, _options{}
+	, _depOffset{ 0 }
+	, _depCount{ 0 }
+	, _type{ StorageType::Double }
+	, _pageValues{ 1 }
+	, _maxPages{ 1 }
+	, _mutex{}
+	, _pages{}
+	, _index{}
+	, _stats{}
+	, _queue{}
+	, _queued{}
+	, _wake{}
+	, _stopping{ false }
+	, _prefetcher{}
+{}
+
+PageCache::~PageCache()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_stopping = true;
+	}
+	_wake.notify_all();
+	if (_prefetcher.joinable()) {
+		_prefetcher.join();
+	}
+#if defined(_WIN32)
+	if (_fileHandle) {
+		CloseHandle(static_cast<HANDLE>(_fileHandle));
+	}
+#else
+	if (_fd >= 0) {
+		close(_fd);
+	}
+#endif
+}
+
+std::shared_ptr<PageCache> PageCache::Open(const std::string& aPath,
+	const PageOptions& aOptions,
+	std::string* outErrMsg)
+{
+	std::shared_ptr<PageCache> result{ new PageCache };
+	result->_options = aOptions;
+	result->_options.pageBytes = std::max<size_t>(
+		(aOptions.pageBytes + sizeof(uint64_t) - 1) / sizeof(uint64_t) * sizeof(uint64_t),
+		sizeof(uint64_t));
+	bool opened = false;
+#if defined(_WIN32)
+	HANDLE fileHandle = CreateFileA(aPath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	LARGE_INTEGER size;
+	if (fileHandle != INVALID_HANDLE_VALUE) {
+		result->_fileHandle = fileHandle;
+		opened = GetFileSizeEx(fileHandle, &size) != 0;
+		result->_fileBytes = opened ? static_cast<uint64_t>(size.QuadPart) : 0;
+	}
+#elif defined(ZJLD_LOOKUP_POSIX_PREAD)
+	result->_fd = open(aPath.c_str(), O_RDONLY);
+	struct stat info;
+	if (result->_fd >= 0 && fstat(result->_fd, &info) == 0) {
+		result->_fileBytes = static_cast<uint64_t>(info.st_size);
+		opened = true;
+	}
+#else
+	result->_stream.open(aPath, std::ios::binary | std::ios::ate);
+	if (result->_stream) {
+		result->_fileBytes = static_cast<uint64_t>(result->_stream.tellg());
+		opened = true;
+	}
+#endif
+	if (!opened) {
+		if (outErrMsg) {
+			*outErrMsg = "Unable to open " + aPath + ".";
+		}
+		return nullptr;
+	}
+	return result;
+}
+// ==== End Section: Construction/Destruction (Public) ==== //
+
+
+
+
+// ==== Begin Section: Reading (Public) ==== //
+bool PageCache::ReadBytes(const uint64_t& aOffset,
+	const size_t& aBytes,
+	void* outData) const
+{
+	if (aOffset > _fileBytes || aBytes > _fileBytes - aOffset)
+		return false;
+	char* data = static_cast<char*>(outData);
+	for (size_t done = 0; done < aBytes;) {
+		// (reads are made in parts of at most 1 GB, since some platforms limit them)
+		const size_t part = std::min<size_t>(aBytes - done, size_t(1) << 30);
+		size_t count = 0;
+#if defined(_WIN32)
+		OVERLAPPED overlapped = {};
+		const uint64_t offset = aOffset + done;
+		overlapped.Offset = static_cast<DWORD>(offset);
+		overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+		DWORD read = 0;
+		if (ReadFile(static_cast<HANDLE>(_fileHandle), data + done, static_cast<DWORD>(part),
+			&read, &overlapped)) {
+			count = read;
+		}
+#elif defined(ZJLD_LOOKUP_POSIX_PREAD)
+		const ssize_t read = pread(_fd, data + done, part, static_cast<off_t>(aOffset + done));
+		count = (read > 0) ? static_cast<size_t>(read) : 0;
+#else
+		std::lock_guard<std::mutex> lock(_streamMutex);
+		_stream.clear();
+		_stream.seekg(static_cast<std::streamoff>(aOffset + done));
+		_stream.read(data + done, static_cast<std::streamsize>(part));
+		count = static_cast<size_t>(_stream.gcount());
+#endif
+		if (count == 0)
+			return false;
+		done += count;
+	}
+	return true;
+}
+
+uint64_t PageCache::FileBytes() const
+{
+	return _fileBytes;
+}
+
+void PageCache::Attach(const uint64_t& aOffset,
+	const size_t& aCount,
+	const StorageType& aType)
+{
+	_depOffset = aOffset;
+	_depCount = aCount;
+	_type = aType;
+	_pageValues = _options.pageBytes / LookupStorage::ValueBytes(aType);
+	_maxPages = std::max<size_t>(_options.cacheBytes / _options.pageBytes, 1);
+	if (_options.prefetch && !_prefetcher.joinable()) {
+		_prefetcher = std::thread(&PageCache::PrefetchLoop, this);
+	}
+}
+
+bool PageCache::Read(const size_t* aPositions,
+	const size_t& aCount,
+	double* outValues)
+{
+	bool moved = false;
+	std::unique_lock<std::mutex> lock(_mutex);
+	for (size_t i = 0; i < aCount; i++) {
+		const size_t number = aPositions[i] / _pageValues;
+		auto found = _index.find(number);
+		std::list<Page>::iterator page;
+		if (found != _index.end()) {
+			page = found->second;
+			_pages.splice(_pages.begin(), _pages, page);
+			_stats.hits++;
+			if (page->prefetched) {
+				page->prefetched = false;
+				_stats.prefetchHits++;
+				moved = true;
+			}
+		}
+		else {
+			// Read the page without holding the lock, so that other threads are not held
+			// up by the file (if another thread reads the same page meanwhile, the first
+			// one inserted is kept)
+			_stats.misses++;
+			moved = true;
+			lock.unlock();
+			Page loaded{ number, {}, false };
+			const bool ok = LoadPage(number, &loaded.data);
+			lock.lock();
+			if (!ok) {
+				_stats.readErrors++;
+				outValues[i] = std::numeric_limits<double>::quiet_NaN();
+				continue;
+			}
+			page = Insert(std::move(loaded));
+		}
+		outValues[i] = Value(*page, aPositions[i] % _pageValues);
+	}
+	return moved;
+}
+
+void PageCache::Prefetch(const size_t* aPositions,
+	const size_t& aCount)
+{
+	if (!_options.prefetch)
+		return;
+	bool queued = false;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		size_t last = std::numeric_limits<size_t>::max();
+		for (size_t i = 0; i < aCount && _queue.size() < kMaxQueuedPages; i++) {
+			const size_t number = aPositions[i] / _pageValues;
+			if (number == last || aPositions[i] >= _depCount)
+				continue; // (neighbouring positions are often on the same page)
+			last = number;
+			if (_index.count(number) == 0 && _queued.insert(number).second) {
+				_queue.push_back(number);
+				queued = true;
+			}
+		}
+	}
+	if (queued) {
+		_wake.notify_one();
+	}
+}
+
+bool PageCache::Prefetching() const
+{
+	return _options.prefetch;
+}
+
+size_t PageCache::MemoryBytes() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	size_t bytes = 0;
+	for (const Page& page : _pages) {
+		bytes += page.data.size() * sizeof(uint64_t);
+	}
+	return bytes;
+}
+
+PageStats PageCache::Stats() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	PageStats stats = _stats;
+	stats.residentPages = _pages.size();
+	return stats;
+}
+
+void PageCache::ResetStats()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_stats = PageStats();
+}
+// ==== End Section: Reading (Public) ==== //
+
+
+
+
+// ==== Begin Section: Helpers (Private) ==== //
+bool PageCache::LoadPage(const size_t& aNumber,
+	std::vector<uint64_t>* outData) const
+{
+	// The last page is cut short at the end of the values rather than the file
+	const size_t valueBytes = LookupStorage::ValueBytes(_type);
+	const size_t first = aNumber * _pageValues;
+	const size_t bytes = std::min(_pageValues, _depCount - first) * valueBytes;
+	outData->assign((bytes + sizeof(uint64_t) - 1) / sizeof(uint64_t), 0);
+	return ReadBytes(_depOffset + static_cast<uint64_t>(first) * valueBytes, bytes, outData->data());
+}
+
+std::list<PageCache::Page>::iterator PageCache::Insert(Page&& aPage)
+{
+	auto found = _index.find(aPage.number);
+	if (found != _index.end())
+		return found->second;
+	while (_pages.size() >= _maxPages) {
+		_index.erase(_pages.back().number);
+		_pages.pop_back();
+		_stats.evictions++;
+	}
+	_pages.push_front(std::move(aPage));
+	_index[_pages.front().number] = _pages.begin();
+	return _pages.begin();
+}
+
+double PageCache::Value(const Page& aPage,
+	const size_t& aPosition) const
+{
+	const unsigned char* bytes = reinterpret_cast<const unsigned char*>(aPage.data.data());
+	switch (_type) {
+	case StorageType::Float:
+		return ValueAt<float>(bytes + aPosition * sizeof(float));
+	case StorageType::BFloat16:
+		return ValueAt<BFloat16>(bytes + aPosition * sizeof(BFloat16));
+	default:
+		return ValueAt<double>(bytes + aPosition * sizeof(double));
+	}
+}
+
+void PageCache::PrefetchLoop()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	while (true) {
+		_wake.wait(lock, [&] { return _stopping || !_queue.empty(); });
+		if (_stopping)
+			return;
+		const size_t number = _queue.front();
+		_queue.pop_front();
+		if (_index.count(number) == 0) {
+			lock.unlock();
+			Page loaded{ number, {}, true };
+			const bool ok = LoadPage(number, &loaded.data);
+			lock.lock();
+			if (ok && _index.count(number) == 0) {
+				Insert(std::move(loaded));
+				_stats.prefetches++;
+			}
+			else if (!ok) {
+				_stats.readErrors++;
+			}
+		}
+		_queued.erase(number);
+	}
+}
+// ==== End Section: Helpers (Private) ==== //
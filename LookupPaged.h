@@ -0,0 +1,207 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+// This file is part of LookupTable <https://github.com/zjldemers/LookupTable>.
+// 
+// MIT License
+// Copyright (c) 2022 Zachary J. L. Demers
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef _ZJLD_LOOKUP_PAGED_H_
+#define _ZJLD_LOOKUP_PAGED_H_
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "LookupStorage.h"
+
+namespace zjld // feel free to remove/rename as the license above allows
+{
+
+	// This supplies the dependent data of a table in chunks, in its logical order (see
+	// LookupTableND::PopulateStream): each call fills up to aMaxCount values at outValues,
+	// continuing from where the previous call stopped, and returns the number filled, or 0
+	// once every value has been supplied.  For example, reading a large text or HDF5 file
+	// a block at a time.
+	typedef std::function<size_t(double* outValues, const size_t& aMaxCount)> DepDataSource;
+
+
+	// This holds the options of a table whose dependent data stays in its binary file and
+	// is read a page at a time as lookups need it (see LookupTableND::LoadBinary).
+	struct PageOptions
+	{
+		size_t pageBytes;  // bytes read from the file at a time (rounded up to 8 bytes)
+		size_t cacheBytes; // memory the cached pages may use (at least one page is kept)
+
+		// If true, each lookup that had to read a page (or first used one read ahead of
+		// it) also queues the pages of the neighbouring cells, which a background thread
+		// then reads, so that lookups moving steadily through the table rarely wait.
+		bool prefetch;
+
+		PageOptions()
+			: pageBytes{ 64 * 1024 }
+			, cacheBytes{ 256 * 1024 * 1024 }
+			, prefetch{ true }
+		{}
+	};
+
+
+	// This holds the counts of a PageCache's activity since it was opened or last reset
+	// (see LookupTableND::PagingStats).  Hits and misses count values read, so a lookup
+	// reads 2^N of them.
+	struct PageStats
+	{
+		uint64_t hits;         // values read from a page already in memory
+		uint64_t misses;       // values whose page had to be read from the file first
+		uint64_t prefetches;   // pages read by the background thread
+		uint64_t prefetchHits; // of those, pages since used by a lookup
+		uint64_t evictions;    // pages dropped to stay within PageOptions::cacheBytes
+		uint64_t readErrors;   // pages the file could not be read for (their values are NaN)
+		size_t residentPages;  // pages currently in memory
+
+		PageStats();
+
+		/* This returns hits / (hits + misses), or 0 if no value has been read.
+		*/
+		double HitRate() const;
+	};
+
+
+	// This class reads the dependent block of a binary table file (see LookupFile.h) in
+	// fixed-size pages, keeping the most recently used ones in memory up to a budget and
+	// dropping the least recently used beyond it.  Pages are read with positional reads,
+	// so no file position is shared between threads.  One mutex guards the cache, which is
+	// only held while looking pages up (never while reading the file), so any number of
+	// threads may read through the same cache at once, though heavily parallel batches
+	// contend for it.
+	class PageCache : public DepDataReader
+	{
+		struct Page
+		{
+			size_t number;              // position in the dependent block / pageBytes
+			std::vector<uint64_t> data; // the page's bytes (as words, for their alignment)
+			bool prefetched;            // read by the background thread and not used since
+		};
+
+		// The file, read through a positional read where the platform has one, or else
+		// through a stream that one read at a time seeks
+	#if defined(_WIN32)
+		void* _fileHandle;
+	#else
+		int _fd;
+	#endif
+		mutable std::ifstream _stream;   // (only if there are no positional reads)
+		mutable std::mutex _streamMutex; // guards _stream
+		uint64_t _fileBytes;
+
+		PageOptions _options;
+		uint64_t _depOffset;       // file position of the dependent data
+		size_t _depCount;          // number of dependent values
+		StorageType _type;         // their storage type
+		size_t _pageValues;        // values per page
+		size_t _maxPages;          // pages kept in memory at most
+
+		mutable std::mutex _mutex; // guards everything below
+		std::list<Page> _pages;    // cached pages, most recently used first
+		std::unordered_map<size_t, std::list<Page>::iterator> _index; // page number -> page
+		PageStats _stats;
+		std::deque<size_t> _queue; // pages waiting to be prefetched
+		std::unordered_set<size_t> _queued; // pages queued or being prefetched
+		std::condition_variable _wake; // signals the prefetch thread
+		bool _stopping;
+		std::thread _prefetcher;
+
+		PageCache();
+		bool LoadPage(const size_t& aNumber,
+			std::vector<uint64_t>* outData) const;
+		std::list<Page>::iterator Insert(Page&& aPage);
+		double Value(const Page& aPage,
+			const size_t& aPosition) const;
+		void PrefetchLoop();
+
+	public:
+		// Prefetch requests beyond this many queued pages are dropped
+		static const size_t kMaxQueuedPages = 64;
+
+		~PageCache();
+		PageCache(const PageCache&) = delete;
+		PageCache& operator=(const PageCache&) = delete;
+
+		/* This opens aPath for reading with the given options, returning null (with a
+		* reason in outErrMsg) on failure.  No values can be read until Attach is called.
+		*/
+		static std::shared_ptr<PageCache> Open(const std::string& aPath,
+			const PageOptions& aOptions,
+			std::string* outErrMsg);
+
+		/* This reads aBytes bytes at file position aOffset straight into outData (without
+		* caching them), returning false if they could not all be read.
+		*/
+		bool ReadBytes(const uint64_t& aOffset,
+			const size_t& aBytes,
+			void* outData) const;
+		uint64_t FileBytes() const;
+
+		/* This sets where the dependent data starts in the file (aOffset, a multiple of 8),
+		* the number of values and their storage type, and starts the prefetch thread if
+		* enabled.  It must be called once, before any value is read.
+		*/
+		void Attach(const uint64_t& aOffset,
+			const size_t& aCount,
+			const StorageType& aType);
+
+		/* This returns the values at the given positions of the dependent data (see
+		* DepDataReader), reading their pages from the file where needed.  It returns true
+		* if any of those pages had to be read or had been prefetched and not used since,
+		* i.e. if the lookup moved into a different part of the table.
+		*/
+		bool Read(const size_t* aPositions,
+			const size_t& aCount,
+			double* outValues) override;
+
+		/* This queues the pages holding the given positions for the background thread,
+		* skipping those already in memory or queued (or does nothing if not prefetching).
+		*/
+		void Prefetch(const size_t* aPositions,
+			const size_t& aCount) override;
+		bool Prefetching() const override;
+
+		/* This returns the memory used by the cached pages.
+		*/
+		size_t MemoryBytes() const override;
+
+		/* These return and reset the counts above (see PageStats).
+		*/
+		PageStats Stats() const;
+		void ResetStats();
+	};
+}
+
+#endif // _ZJLD_LOOKUP_PAGED_H_
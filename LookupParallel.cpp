@@ -0,0 +1,239 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+// This file is part of LookupTable <https://github.com/zjldemers/LookupTable>.
+// 
+// MIT License
+// Copyright (c) 2022 Zachary J. L. Demers
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "LookupParallel.h"
+#include <algorithm>
+
+using namespace zjld; // feel free to remove/rename as the license above allows
+
+
+namespace
+{
+	// Set on pool workers (and callers taking part in a run) so that nested runs execute
+	// inline instead of waiting for threads that are busy running their caller
+	thread_local const ThreadPool* tRunningPool = nullptr;
+
+	const uint64_t kMaxRunTasks = UINT32_MAX; // larger runs are done in several parts
+
+	uint64_t PackRange(const uint64_t& aBegin, const uint64_t& aEnd)
+	{
+		return aBegin | (aEnd << 32);
+	}
+	uint64_t RangeBegin(const uint64_t& aRange) { return aRange & UINT32_MAX; }
+	uint64_t RangeEnd(const uint64_t& aRange) { return aRange >> 32; }
+}
+
+
+
+
+// ==== Begin Section: Construction/Destruction (Public) ==== //
+ThreadPool::ThreadPool(const size_t& aThreadCount)
+	: _threads{}
+	, _ranges{}
+	, _runMutex{}
+	, _mutex{}
+	, _wake{}
+	, _done{}
+	, _generation{ 0 }
+	, _active{ 0 }
+	, _stop{ false }
+	, _task{ nullptr }
+	, _remaining{ 0 }
+{
+	size_t threadCount = aThreadCount;
+	if (threadCount == 0) {
+		const size_t hardware = std::thread::hardware_concurrency();
+		threadCount = (hardware > 1) ? hardware - 1 : 0;
+	}
+	_ranges.reset(new TaskRange[threadCount + 1]);
+	for (size_t i = 0; i <= threadCount; i++) {
+		_ranges[i].range.store(0);
+	}
+	_threads.reserve(threadCount);
+	for (size_t i = 0; i < threadCount; i++) {
+		_threads.emplace_back(&ThreadPool::WorkerLoop, this, i);
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_stop = true;
+	}
+	_wake.notify_all();
+	for (std::thread& thread : _threads) {
+		thread.join();
+	}
+}
+// ==== End Section: Construction/Destruction (Public) ==== //
+
+
+
+
+// ==== Begin Section: Running Tasks (Public) ==== //
+void ThreadPool::Run(const size_t& aTaskCount,
+	const std::function<void(size_t)>& aTask)
+{
+	if (aTaskCount == 0)
+		return;
+	if (tRunningPool == this || _threads.empty()) {
+		for (size_t i = 0; i < aTaskCount; i++) {
+			aTask(i);
+		}
+		return;
+	}
+
+	std::lock_guard<std::mutex> runLock(_runMutex);
+	for (size_t first = 0; first < aTaskCount; first += static_cast<size_t>(kMaxRunTasks)) {
+		const size_t count = static_cast<size_t>(std::min<uint64_t>(aTaskCount - first, kMaxRunTasks));
+		const std::function<void(size_t)> task = [&](size_t aIndex) { aTask(first + aIndex); };
+
+		// Hand every thread (the caller last) an equal share of the tasks
+		const size_t rangeCount = _threads.size() + 1;
+		for (size_t i = 0; i < rangeCount; i++) {
+			_ranges[i].range.store(PackRange(count * i / rangeCount, count * (i + 1) / rangeCount));
+		}
+		_remaining.store(count);
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_task = &task;
+			_generation++;
+		}
+		_wake.notify_all();
+
+		tRunningPool = this;
+		Work(_threads.size());
+		tRunningPool = nullptr;
+
+		// Wait for the tasks still running elsewhere, and for every worker to stop looking
+		// for more, before the task goes out of scope
+		std::unique_lock<std::mutex> lock(_mutex);
+		_done.wait(lock, [&] { return _remaining.load() == 0 && _active == 0; });
+		_task = nullptr;
+	}
+}
+
+BatchExecutor ThreadPool::Executor()
+{
+	return [this](size_t aTaskCount, const std::function<void(size_t)>& aTask) {
+		Run(aTaskCount, aTask);
+	};
+}
+
+size_t ThreadPool::ThreadCount() const
+{
+	return _threads.size() + 1;
+}
+
+ThreadPool& ThreadPool::Default()
+{
+	static ThreadPool pool;
+	return pool;
+}
+// ==== End Section: Running Tasks (Public) ==== //
+
+
+
+
+// ==== Begin Section: Helpers (Private) ==== //
+void ThreadPool::WorkerLoop(const size_t& aIndex)
+{
+	tRunningPool = this;
+	uint64_t generation = 0;
+	std::unique_lock<std::mutex> lock(_mutex);
+	while (true) {
+		_wake.wait(lock, [&] { return _stop || (_generation != generation && _task); });
+		if (_stop)
+			return;
+		generation = _generation;
+		_active++;
+		lock.unlock();
+		Work(aIndex);
+		lock.lock();
+		if (--_active == 0)
+			_done.notify_all();
+	}
+}
+
+void ThreadPool::Work(const size_t& aIndex)
+{
+	size_t task;
+	while (Take(aIndex, &task) || Steal(aIndex, &task)) {
+		(*_task)(task);
+		if (_remaining.fetch_sub(1) == 1) {
+			std::lock_guard<std::mutex> lock(_mutex);
+			_done.notify_all();
+		}
+	}
+}
+
+bool ThreadPool::Take(const size_t& aIndex,
+	size_t* outTask)
+{
+	std::atomic<uint64_t>& range = _ranges[aIndex].range; // shorthand
+	uint64_t current = range.load(std::memory_order_relaxed);
+	while (RangeBegin(current) < RangeEnd(current)) {
+		if (range.compare_exchange_weak(current, PackRange(RangeBegin(current) + 1, RangeEnd(current)),
+			std::memory_order_acq_rel)) {
+			*outTask = static_cast<size_t>(RangeBegin(current));
+			return true;
+		}
+	}
+	return false;
+}
+
+bool ThreadPool::Steal(const size_t& aIndex,
+	size_t* outTask)
+{
+	// Steal the back half of the largest range (which is only ever empty when called,
+	// since a thread only steals once its own range is exhausted)
+	const size_t rangeCount = _threads.size() + 1;
+	while (true) {
+		size_t victim = rangeCount;
+		uint64_t victimRange = 0, victimSize = 0;
+		for (size_t i = 0; i < rangeCount; i++) {
+			const uint64_t current = _ranges[i].range.load(std::memory_order_relaxed);
+			const uint64_t size = RangeEnd(current) - std::min(RangeBegin(current), RangeEnd(current));
+			if (i != aIndex && size > victimSize) {
+				victim = i;
+				victimRange = current;
+				victimSize = size;
+			}
+		}
+		if (victim == rangeCount)
+			return false; // nothing left to start (though tasks may still be running)
+
+		const uint64_t begin = RangeBegin(victimRange), end = RangeEnd(victimRange);
+		const uint64_t middle = end - (victimSize + 1) / 2;
+		if (_ranges[victim].range.compare_exchange_strong(victimRange, PackRange(begin, middle),
+			std::memory_order_acq_rel)) {
+			_ranges[aIndex].range.store(PackRange(middle + 1, end), std::memory_order_release);
+			*outTask = static_cast<size_t>(middle);
+			return true;
+		}
+	}
+}
+// ==== End Section: Helpers (Private) ==== //
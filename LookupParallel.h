@@ -0,0 +1,118 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+// This file is part of LookupTable <https://github.com/zjldemers/LookupTable>.
+// 
+// MIT License
+// Copyright (c) 2022 Zachary J. L. Demers
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef _ZJLD_LOOKUP_PARALLEL_H_
+#define _ZJLD_LOOKUP_PARALLEL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace zjld // feel free to remove/rename as the license above allows
+{
+
+	// An executor runs aTaskCount independent tasks by calling aTask(i) exactly once for
+	// every i in [0, aTaskCount), from any threads and in any order, and returns once all
+	// of them have finished.  Tasks never throw.  This is the extension point for running
+	// parallel batches (see LookupTableND::QueryBatchByValuesParallel) on another thread
+	// pool, e.g. within a TBB arena:
+	//   [&](size_t aTaskCount, const std::function<void(size_t)>& aTask) {
+	//       arena.execute([&] { tbb::parallel_for(size_t(0), aTaskCount, aTask); }); }
+	typedef std::function<void(size_t aTaskCount, const std::function<void(size_t)>& aTask)>
+		BatchExecutor;
+
+
+	// This class is a fixed-size pool of worker threads running tasks with work stealing.
+	// Each run splits the tasks into one contiguous range per thread (including the
+	// calling thread, which takes part), and every thread takes tasks from the front of its
+	// own range until it is empty, then steals the back half of the largest range it finds
+	// elsewhere.  Ranges are single atomic words, so taking a task is one compare-exchange
+	// on memory that is (almost always) only touched by its owner.
+	class ThreadPool
+	{
+		// A range of task indices [begin, end) packed as begin | (end << 32)
+		struct alignas(64) TaskRange
+		{
+			std::atomic<uint64_t> range;
+		};
+
+		std::vector<std::thread> _threads;
+		std::unique_ptr<TaskRange[]> _ranges; // one per worker, then one for the caller
+		std::mutex _runMutex;                 // one run at a time
+		std::mutex _mutex;                    // guards everything below
+		std::condition_variable _wake;        // signals workers when a run starts
+		std::condition_variable _done;        // signals the caller when a run may be done
+		uint64_t _generation;                 // number of runs started
+		size_t _active;                       // workers taking part in the current run
+		bool _stop;
+		const std::function<void(size_t)>* _task; // current run's task (null if none)
+		std::atomic<size_t> _remaining;       // tasks of the current run not yet finished
+
+		void WorkerLoop(const size_t& aIndex);
+		void Work(const size_t& aIndex);
+		bool Take(const size_t& aIndex,
+			size_t* outTask);
+		bool Steal(const size_t& aIndex,
+			size_t* outTask);
+
+	public:
+		/* This starts aThreadCount worker threads (if 0, one less than the number of
+		* hardware threads, since the thread calling Run also works).
+		*/
+		explicit ThreadPool(const size_t& aThreadCount = 0);
+		~ThreadPool();
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+		/* This runs aTask(i) for every i in [0, aTaskCount) on the workers and the calling
+		* thread, returning once all have finished (see BatchExecutor).  Runs from
+		* different threads take turns, while a run from within a task of this pool
+		* executes its tasks inline on the calling thread.
+		*/
+		void Run(const size_t& aTaskCount,
+			const std::function<void(size_t)>& aTask);
+
+		/* This returns a BatchExecutor running tasks with Run.  The pool must outlive it.
+		*/
+		BatchExecutor Executor();
+
+		/* This returns the number of threads running tasks (workers and the caller).
+		*/
+		size_t ThreadCount() const;
+
+		/* This returns a pool shared by the whole process, with default arguments, which
+		* is started on first use.
+		*/
+		static ThreadPool& Default();
+	};
+}
+
+#endif // _ZJLD_LOOKUP_PARALLEL_H_
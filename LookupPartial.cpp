@@ -0,0 +1,228 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+// This file is part of LookupTable <https://github.com/zjldemers/LookupTable>.
+// 
+// MIT License
+// Copyright (c) 2022 Zachary J. L. Demers
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "LookupPartial.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include "LookupTableND.h"
+
+using namespace zjld; // feel free to remove/rename as the license above allows
+using utils::ErrorCode;
+using utils::Result;
+using utils::Scratch;
+
+
+namespace
+{
+	const size_t kFastDimensions = 8; // free dimensions interpolated without allocating
+}
+
+
+LookupPartial::LookupPartial()
+	: _table{ nullptr }
+	, _generation{ 0 }
+	, _free{}
+	, _inputs{}
+	, _axes{}
+	, _strides{}
+	, _values{}
+{}
+
+void LookupPartial::Reset()
+{
+	_table = nullptr;
+	_generation = 0;
+	_free.clear();
+	_inputs.clear();
+	_axes.clear();
+	_strides.clear();
+	_values.clear();
+}
+
+
+bool LookupPartial::Valid() const
+{
+	return nullptr != _table;
+}
+size_t LookupPartial::Dimensions() const
+{
+	return _free.size();
+}
+const std::vector<size_t>& LookupPartial::FreeDimensions() const
+{
+	return _free;
+}
+const TableData& LookupPartial::Inputs() const
+{
+	return _inputs;
+}
+const TableData& LookupPartial::Values() const
+{
+	return _values;
+}
+const LookupAxis& LookupPartial::Axis(const size_t& aFreeDimension) const
+{
+	if (aFreeDimension >= _axes.size())
+		throw std::invalid_argument("Invalid dimension provided: " + std::to_string(aFreeDimension));
+	return _axes[aFreeDimension];
+}
+
+
+bool LookupPartial::Matches(const LookupTableND* aTable,
+	const std::vector<size_t>& aFreeDimensions,
+	const double* aInputs,
+	const size_t& aCount) const
+{
+	if (nullptr == _table || aTable != _table || aTable->Generation() != _generation
+		|| aFreeDimensions != _free || aCount != _inputs.size())
+		return false;
+	for (size_t i = 0, f = 0; i < aCount; i++) {
+		if (f < _free.size() && _free[f] == i) {
+			f++;
+		}
+		else if (aInputs[i] != _inputs[i]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+
+double LookupPartial::LookupByValues(const std::vector<double>& aFreeInputs) const
+{
+	double value;
+	const ErrorCode error = FindByValues(aFreeInputs.data(), aFreeInputs.size(), &value);
+	if (error == ErrorCode::InvalidTable)
+		throw std::runtime_error(utils::ErrorCodeMessage(error));
+	if (error != ErrorCode::None)
+		throw std::invalid_argument(utils::ErrorCodeMessage(error));
+	return value;
+}
+bool LookupPartial::QueryByValues(const std::vector<double>& aFreeInputs,
+	double* outValue,
+	std::string* outErrMsg) const
+{
+	if (nullptr == outValue || nullptr == outErrMsg)
+		return false;
+	const ErrorCode error = FindByValues(aFreeInputs.data(), aFreeInputs.size(), outValue);
+	if (error != ErrorCode::None) {
+		*outErrMsg = utils::ErrorCodeMessage(error);
+		return false;
+	}
+	return true;
+}
+Result<double> LookupPartial::QueryByValues(const std::vector<double>& aFreeInputs) const
+{
+	double value;
+	const ErrorCode error = FindByValues(aFreeInputs.data(), aFreeInputs.size(), &value);
+	return (error == ErrorCode::None) ? Result<double>(value) : Result<double>(error);
+}
+
+double LookupPartial::LookupByValue(const double& aFreeInput) const
+{
+	double value;
+	const ErrorCode error = FindByValues(&aFreeInput, 1, &value);
+	if (error == ErrorCode::InvalidTable)
+		throw std::runtime_error(utils::ErrorCodeMessage(error));
+	if (error != ErrorCode::None)
+		throw std::invalid_argument(utils::ErrorCodeMessage(error));
+	return value;
+}
+bool LookupPartial::QueryByValue(const double& aFreeInput,
+	double* outValue,
+	std::string* outErrMsg) const
+{
+	if (nullptr == outValue || nullptr == outErrMsg)
+		return false;
+	const ErrorCode error = FindByValues(&aFreeInput, 1, outValue);
+	if (error != ErrorCode::None) {
+		*outErrMsg = utils::ErrorCodeMessage(error);
+		return false;
+	}
+	return true;
+}
+Result<double> LookupPartial::QueryByValue(const double& aFreeInput) const
+{
+	double value;
+	const ErrorCode error = FindByValues(&aFreeInput, 1, &value);
+	return (error == ErrorCode::None) ? Result<double>(value) : Result<double>(error);
+}
+
+
+ErrorCode LookupPartial::FindByValues(const double* aFreeInputs,
+	const size_t& aCount,
+	double* outValue) const
+{
+	if (nullptr == _table)
+		return ErrorCode::InvalidTable;
+	const size_t kFreeSize = _free.size(); // shorthand
+	if (aCount != kFreeSize)
+		return ErrorCode::WrongInputCount;
+
+	// Find the cell of the free dimensions as the table would (see
+	// LookupTableND::PositionFromApproxPos), summing the offset of its lowest corner
+	Scratch<double, kFastDimensions> prcPrgs(kFreeSize);
+	double* prcs = prcPrgs.Data();
+	size_t base = 0;
+	for (size_t i = 0; i < kFreeSize; i++) {
+		double pos;
+		if (!_axes[i].FindApproxPos(aFreeInputs[i], &pos))
+			return ErrorCode::ValueOutOfBounds;
+		size_t low;
+		LookupAxis::CellFromPosition(pos, _axes[i].Size(), &low, &prcs[i]);
+		base += low * _strides[i];
+	}
+	if (kFreeSize == 1) {
+		*outValue = utils::Lerp(_values[base], _values[base + 1], prcs[0]);
+		return ErrorCode::None;
+	}
+
+	// Gather the corners with the last free dimension as the least significant bit and
+	// interpolate them down one dimension at a time, in the same order as the table
+	const size_t comboCount = static_cast<size_t>(1) << kFreeSize;
+	Scratch<size_t, static_cast<size_t>(1) << kFastDimensions> offsetsScratch(comboCount);
+	Scratch<double, static_cast<size_t>(1) << kFastDimensions> valsScratch(comboCount);
+	size_t* offsets = offsetsScratch.Data();
+	double* vals = valsScratch.Data();
+	offsets[0] = base;
+	for (size_t i = 0, bit = 1; i < kFreeSize; i++, bit <<= 1) {
+		const size_t step = _strides[kFreeSize - i - 1];
+		for (size_t j = 0; j < bit; j++) {
+			offsets[j | bit] = offsets[j] + step;
+		}
+	}
+	for (size_t i = 0; i < comboCount; i++) {
+		vals[i] = _values[offsets[i]];
+	}
+	for (size_t i = 0, count = comboCount; i < kFreeSize; i++, count >>= 1) {
+		const double prc = prcs[kFreeSize - i - 1];
+		for (size_t j = 1; j < count; j += 2) {
+			vals[j / 2] = utils::Lerp(vals[j - 1], vals[j], prc);
+		}
+	}
+	*outValue = vals[0];
+	return ErrorCode::None;
+}
@@ -0,0 +1,125 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+// This file is part of LookupTable <https://github.com/zjldemers/LookupTable>.
+// 
+// MIT License
+// Copyright (c) 2022 Zachary J. L. Demers
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef _ZJLD_LOOKUP_PARTIAL_H_
+#define _ZJLD_LOOKUP_PARTIAL_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "LookupAxis.h"
+#include "LookupUtils.hpp"
+
+namespace zjld // feel free to remove/rename as the license above allows
+{
+
+	class LookupTableND;
+
+
+	// This holds a table with some of its inputs bound to fixed values: the table reduced
+	// to its remaining (free) dimensions, with the bound inputs already interpolated at
+	// every breakpoint of the free ones.  Looking it up then only searches the free
+	// dimensions and interpolates between their 2^F corners (for F free dimensions), e.g.
+	// a single search and lerp per point when sweeping one input with the others fixed.
+	// Results equal those of the table's LookupByValues at the same inputs to within the
+	// rounding of the interpolation, and are bit-identical to them when the free
+	// dimensions are the first ones of the table (e.g. only dimension 0), whose corners
+	// the table always interpolates last.  The searches follow the table's options (the
+	// bound policies included) at the time the partial was taken.
+	// Partials are filled by LookupTableND::QueryPartial, which keeps an existing partial
+	// as it is if it already holds the one asked for.  Like a LookupSlice, a partial
+	// belongs to the caller (and shares nothing with the table once filled), so const
+	// tables stay safe to share between threads as long as each thread uses its own.
+	class LookupPartial
+	{
+		friend class LookupTableND; // fills in the partial
+
+		const LookupTableND* _table;  // table the partial was taken from (null if empty)
+		uint64_t _generation;         // the table's Generation when it was taken
+		std::vector<size_t> _free;    // dimensions of the table left free, in order
+		TableData _inputs;            // inputs it was taken at (those of _free unused)
+		std::vector<LookupAxis> _axes; // search structures of the free dimensions
+		std::vector<size_t> _strides; // _values step per free dimension
+		TableData _values;            // table's value at each breakpoint of the free
+		                              // dimensions (the first fastest)
+
+	public:
+		LookupPartial();
+
+		/* This empties the partial.  Partials of a table that has since been repopulated
+		* (or whose options have changed) never match it again (see Matches), so they need
+		* not be reset.
+		*/
+		void Reset();
+
+		bool Valid() const;            // false until filled by a table
+		size_t Dimensions() const;     // number of free dimensions
+		const std::vector<size_t>& FreeDimensions() const; // free dimensions of the table
+		const TableData& Inputs() const; // inputs it was taken at
+		const TableData& Values() const; // reduced values (see above)
+		const LookupAxis& Axis(const size_t& aFreeDimension) const; // search of a free
+		                                                            // dimension (by position)
+
+		/* Returns true if this holds the partial of aTable with aFreeDimensions left free
+		* at aInputs (aCount values, one per dimension of the table), ignoring the inputs
+		* of the free dimensions, as taken from the table's current data and options (see
+		* LookupTableND::Generation).
+		*/
+		bool Matches(const LookupTableND* aTable,
+			const std::vector<size_t>& aFreeDimensions,
+			const double* aInputs,
+			const size_t& aCount) const;
+
+		/* These return the value of the table at the given inputs of the free dimensions
+		* (one per free dimension, in the order of FreeDimensions), through the three
+		* lookup schemas of the table's LookupByValues and QueryByValues.
+		*/
+		double LookupByValues(const std::vector<double>& aFreeInputs) const;
+		bool QueryByValues(const std::vector<double>& aFreeInputs,
+			double* outValue,
+			std::string* outErrMsg) const;
+		utils::Result<double> QueryByValues(const std::vector<double>& aFreeInputs) const;
+
+		/* These are the same as the above for a partial with a single free dimension,
+		* taking its input directly.
+		*/
+		double LookupByValue(const double& aFreeInput) const;
+		bool QueryByValue(const double& aFreeInput,
+			double* outValue,
+			std::string* outErrMsg) const;
+		utils::Result<double> QueryByValue(const double& aFreeInput) const;
+
+	private:
+		/* This is the non-throwing core of the lookups above.
+		*/
+		utils::ErrorCode FindByValues(const double* aFreeInputs,
+			const size_t& aCount,
+			double* outValue) const;
+	};
+
+}
+
+#endif // _ZJLD_LOOKUP_PARTIAL_H_
@@ -0,0 +1,621 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+// This file is part of LookupTable <https://github.com/zjldemers/LookupTable>.
+// 
+// MIT License
+// Copyright (c) 2022 Zachary J. L. Demers
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "LookupSimd.h"
+#include <limits>
+
+#if !defined(ZJLD_LOOKUP_NO_SIMD)
+	#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+		#define ZJLD_SIMD_AVX2 1
+		#define ZJLD_TARGET_AVX2 __attribute__((target("avx2")))
+		#define ZJLD_TARGET_AVX512 __attribute__((target("avx512f")))
+		#include <immintrin.h>
+	#elif defined(_MSC_VER) && defined(_M_X64)
+		#define ZJLD_SIMD_AVX2 1
+		#define ZJLD_TARGET_AVX2
+		#define ZJLD_TARGET_AVX512
+		#include <immintrin.h>
+		#include <intrin.h>
+	#endif
+	// No NEON kernels are implemented yet, so ARM machines use the scalar batches
+#endif
+
+using namespace zjld; // feel free to remove/rename as the license above allows
+
+
+#if defined(ZJLD_SIMD_AVX2)
+namespace
+{
+	// Converts 4 small (< 2^31) non-negative 64-bit integers to doubles, since AVX2 has no
+	// direct 64-bit integer conversion
+	ZJLD_TARGET_AVX2 inline __m256d ToDouble(const __m256i aValues)
+	{
+		const __m256i lowHalves = _mm256_permutevar8x32_epi32(aValues,
+			_mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6));
+		return _mm256_cvtepi32_pd(_mm256_castsi256_si128(lowHalves));
+	}
+
+	// Vector version of utils::IsApproxEqual, using the same operations in the same order
+	ZJLD_TARGET_AVX2 inline __m256d IsApproxEqual(const __m256d aA,
+		const __m256d aB)
+	{
+		const __m256d absMask = _mm256_castsi256_pd(_mm256_set1_epi64x(0x7FFFFFFFFFFFFFFF));
+		const __m256d diff = _mm256_and_pd(_mm256_sub_pd(aA, aB), absMask);
+		const __m256d max = _mm256_max_pd(_mm256_and_pd(aA, absMask), _mm256_and_pd(aB, absMask));
+		const __m256d eps = _mm256_mul_pd(
+			_mm256_mul_pd(max, _mm256_set1_pd(std::numeric_limits<double>::epsilon())),
+			_mm256_set1_pd(5.0));
+		return _mm256_cmp_pd(diff, eps, _CMP_LE_OQ);
+	}
+
+	// Number of 4-lane vectors processed together.  Each search step depends on the result
+	// of a gather from the previous step, so interleaving independent groups hides latency.
+	static const size_t kGroup = 8;
+
+	// Vector version of LookupTableND::FindPositionInfo for one dimension of kGroup vectors.
+	// Lanes that are rejected (NaN, or out of bounds with BoundPolicy::Error) are cleared in
+	// ioValid and searched as if at the front of the data.
+	ZJLD_TARGET_AVX2 inline void FindPositionInfo(const double* aData,
+		const size_t aSize,
+		const bool aUniform,
+		const double aOrigin,
+		const double aInvStep,
+		const LookupAxis::BoundPolicy aBounds,
+		const double* aValues,
+		__m256d* ioValid,
+		__m256i* outLowIdx,
+		__m256d* outPercProgress)
+	{
+		// Same bound handling as LookupAxis::ApplyBounds: the search sees values clamped to
+		// the data (max_pd returns front for NaN lanes), while values[] holds the value to
+		// find the position of within the segment found
+		const __m256d front = _mm256_set1_pd(aData[0]);
+		const __m256d back = _mm256_set1_pd(aData[aSize - 1]);
+		const bool extrapolate = (aBounds == LookupAxis::BoundPolicy::Extrapolate);
+		const bool error = (aBounds == LookupAxis::BoundPolicy::Error);
+		__m256d values[kGroup];
+		__m256d clamped[kGroup];
+		__m256i l[kGroup];
+		for (size_t g = 0; g < kGroup; g++) {
+			const __m256d value = _mm256_loadu_pd(aValues + 4 * g);
+			clamped[g] = _mm256_min_pd(_mm256_max_pd(value, front), back);
+			const __m256d accepted = error ? _mm256_cmp_pd(value, clamped[g], _CMP_EQ_OQ)
+				: _mm256_cmp_pd(value, value, _CMP_ORD_Q);
+			ioValid[g] = _mm256_and_pd(ioValid[g], accepted);
+			values[g] = extrapolate ? _mm256_blendv_pd(clamped[g], value, accepted) : clamped[g];
+			l[g] = _mm256_setzero_si256();
+		}
+
+		const __m256i lastSegment = _mm256_set1_epi64x(static_cast<long long>(aSize - 2));
+		if (aUniform) {
+			// Same direct estimate and single correction step as LookupAxis::FindSegment
+			const __m256d origin = _mm256_set1_pd(aOrigin);
+			const __m256d invStep = _mm256_set1_pd(aInvStep);
+			const __m256i zero = _mm256_setzero_si256();
+			const __m256i one = _mm256_set1_epi64x(1);
+			for (size_t g = 0; g < kGroup; g++) {
+				const __m256d estimate = _mm256_mul_pd(_mm256_sub_pd(clamped[g], origin), invStep);
+				__m256i est = _mm256_cvtepi32_epi64(_mm256_cvttpd_epi32(estimate));
+				est = _mm256_blendv_epi8(est, lastSegment, _mm256_cmpgt_epi64(est, lastSegment));
+				const __m256d dataL = _mm256_i64gather_pd(aData, est, 8);
+				const __m256i down = _mm256_and_si256(_mm256_cmpgt_epi64(est, zero),
+					_mm256_castpd_si256(_mm256_cmp_pd(dataL, clamped[g], _CMP_GT_OQ)));
+				est = _mm256_sub_epi64(est, _mm256_and_si256(down, one));
+				const __m256d dataR = _mm256_i64gather_pd(aData + 1, est, 8);
+				const __m256i up = _mm256_and_si256(_mm256_cmpgt_epi64(lastSegment, est),
+					_mm256_castpd_si256(_mm256_cmp_pd(dataR, clamped[g], _CMP_LE_OQ)));
+				l[g] = _mm256_add_epi64(est, _mm256_and_si256(up, one));
+			}
+		}
+
+		// Same branchless segment search as the scalar implementation.  The number of steps
+		// depends only on the size of the data, so every lane runs the same iterations.
+		for (size_t len = aUniform ? 1 : aSize - 1; len > 1; ) {
+			const size_t half = len / 2;
+			const __m256i halfV = _mm256_set1_epi64x(static_cast<long long>(half));
+			for (size_t g = 0; g < kGroup; g++) {
+				const __m256d probe = _mm256_i64gather_pd(aData, _mm256_add_epi64(l[g], halfV), 8);
+				const __m256i step = _mm256_castpd_si256(_mm256_cmp_pd(probe, clamped[g], _CMP_LE_OQ));
+				l[g] = _mm256_add_epi64(l[g], _mm256_and_si256(step, halfV));
+			}
+			len -= half;
+		}
+
+		for (size_t g = 0; g < kGroup; g++) {
+			// Snap to an approximately equal breakpoint, otherwise interpolate (see ILerp)
+			const __m256d value = values[g];
+			const __m256d dataL = _mm256_i64gather_pd(aData, l[g], 8);
+			const __m256d dataR = _mm256_i64gather_pd(aData + 1, l[g], 8);
+			const __m256d snapL = _mm256_and_pd(IsApproxEqual(value, dataL),
+				_mm256_castsi256_pd(_mm256_cmpgt_epi64(l[g], _mm256_setzero_si256())));
+			const __m256d snapR = _mm256_andnot_pd(snapL, IsApproxEqual(value, dataR));
+			__m256d perc = _mm256_div_pd(_mm256_sub_pd(value, dataL), _mm256_sub_pd(dataR, dataL));
+			perc = _mm256_andnot_pd(IsApproxEqual(dataL, dataR), perc);
+			const __m256d lowD = ToDouble(l[g]);
+			__m256d pos = _mm256_add_pd(lowD, perc);
+			pos = _mm256_blendv_pd(pos, lowD, snapL);
+			pos = _mm256_blendv_pd(pos, _mm256_add_pd(lowD, _mm256_set1_pd(1.0)), snapR);
+
+			// Low index and percent progress (see PositionFromApproxPos)
+			__m256d low = _mm256_round_pd(pos, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC);
+			low = _mm256_min_pd(_mm256_max_pd(low, _mm256_setzero_pd()),
+				_mm256_set1_pd(static_cast<double>(aSize - 2)));
+			outLowIdx[g] = _mm256_cvtepi32_epi64(_mm256_cvttpd_epi32(low));
+			outPercProgress[g] = _mm256_sub_pd(pos, low);
+		}
+	}
+
+	// Gathers 4 dependent values as doubles, converting them from their storage type in the
+	// same way as LookupStorage::ToDouble
+	ZJLD_TARGET_AVX2 inline __m256d GatherDepData(const double* aData,
+		const __m256i aIndices)
+	{
+		return _mm256_i64gather_pd(aData, aIndices, 8);
+	}
+	ZJLD_TARGET_AVX2 inline __m256d GatherDepData(const float* aData,
+		const __m256i aIndices)
+	{
+		return _mm256_cvtps_pd(_mm256_i64gather_ps(aData, aIndices, 4));
+	}
+	ZJLD_TARGET_AVX2 inline __m256d GatherDepData(const BFloat16* aData,
+		const __m256i aIndices)
+	{
+		// Each gather reads 32 bits starting at the wanted value, whose 16 bits end up as the
+		// lower half (little endian) and are shifted up into place as the upper half of a
+		// float.  The value after the last is always allocated (see LookupStorage::Data).
+		const __m128i pairs = _mm256_i64gather_epi32(reinterpret_cast<const int*>(aData),
+			aIndices, 2);
+		return _mm256_cvtps_pd(_mm_castsi128_ps(_mm_slli_epi32(pairs, 16)));
+	}
+
+	// Evaluates points 4 * kGroup at a time.  kFixedDims is the dimension count when known at
+	// compile time (allowing the loops to unroll), or 0 to use the count given by the layout.
+	// TStorage is the type the dependent data is stored as.
+	template<size_t kFixedDims, typename TStorage>
+	ZJLD_TARGET_AVX2 size_t EvaluateBatchAvx2(const simd::BatchLayout& aLayout,
+		const double* const* aDimValues,
+		const size_t aBegin,
+		const size_t aEnd,
+		double* outValues,
+		uint64_t* outValidMask,
+		size_t* outNext)
+	{
+		const size_t kDims = (kFixedDims > 0) ? kFixedDims : aLayout.dims;
+		const size_t kMaxDims = (kFixedDims > 0) ? kFixedDims : simd::kMaxDimensions;
+		const size_t comboCount = static_cast<size_t>(1) << kDims;
+		const __m256d nan = _mm256_set1_pd(std::numeric_limits<double>::quiet_NaN());
+		const TStorage* depData = static_cast<const TStorage*>(aLayout.depData);
+
+		__m256d valid[kGroup];
+		__m256i lowIdxs[kMaxDims][kGroup];
+		__m256d prcPrgs[kMaxDims][kGroup];
+		__m256i offsets[static_cast<size_t>(1) << kMaxDims];
+		__m256i steps[kMaxDims];
+		const bool tiled = (nullptr != aLayout.dimOffsets[0]);
+		__m256d vals[static_cast<size_t>(1) << kMaxDims];
+		size_t validCount = 0;
+		size_t i = aBegin;
+		for (; i + 4 * kGroup <= aEnd; i += 4 * kGroup) {
+			for (size_t g = 0; g < kGroup; g++) {
+				valid[g] = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+			}
+			for (size_t k = 0; k < kDims; k++) {
+				FindPositionInfo(aLayout.axes[k], aLayout.axisSizes[k], aLayout.uniform[k],
+					aLayout.origins[k], aLayout.invSteps[k], aLayout.bounds[k], aDimValues[k] + i,
+					valid, lowIdxs[k], prcPrgs[k]);
+			}
+
+			for (size_t g = 0; g < kGroup; g++) {
+				// Corner indices in the same order as LookupTableND::InterpolateCell (strides
+				// are known to fit in 32 bits, see simd::EvaluateBatch below), where tiled
+				// tables look up the offset and step of each dimension instead (see
+				// LookupTableND::LocateCell)
+				offsets[0] = _mm256_setzero_si256();
+				for (size_t k = 0; k < kDims; k++) {
+					if (tiled) {
+						const long long* dimOffsets =
+							reinterpret_cast<const long long*>(aLayout.dimOffsets[k]);
+						const __m256i low = _mm256_i64gather_epi64(dimOffsets, lowIdxs[k][g], 8);
+						const __m256i high = _mm256_i64gather_epi64(dimOffsets + 1, lowIdxs[k][g], 8);
+						offsets[0] = _mm256_add_epi64(offsets[0], low);
+						steps[k] = _mm256_sub_epi64(high, low);
+					}
+					else {
+						steps[k] = _mm256_set1_epi64x(static_cast<long long>(aLayout.strides[k]));
+						offsets[0] = _mm256_add_epi64(offsets[0],
+							_mm256_mul_epu32(lowIdxs[k][g], steps[k]));
+					}
+				}
+				for (size_t k = 0, bit = 1; k < kDims; k++, bit <<= 1) {
+					const __m256i step = steps[kDims - k - 1];
+					for (size_t j = 0; j < bit; j++) {
+						offsets[j | bit] = _mm256_add_epi64(offsets[j], step);
+					}
+				}
+				for (size_t c = 0; c < comboCount; c++) {
+					vals[c] = GatherDepData(depData, offsets[c]);
+				}
+				for (size_t k = 0, count = comboCount; k < kDims; k++, count >>= 1) {
+					const __m256d prc = prcPrgs[kDims - k - 1][g];
+					for (size_t j = 1; j < count; j += 2) {
+						vals[j / 2] = _mm256_add_pd(vals[j - 1],
+							_mm256_mul_pd(prc, _mm256_sub_pd(vals[j], vals[j - 1])));
+					}
+				}
+
+				const size_t p = i + 4 * g;
+				_mm256_storeu_pd(outValues + p, _mm256_blendv_pd(nan, vals[0], valid[g]));
+				const unsigned int bits = static_cast<unsigned int>(_mm256_movemask_pd(valid[g]));
+				outValidMask[p / 64] |= static_cast<uint64_t>(bits) << (p % 64);
+				validCount += (bits & 1) + ((bits >> 1) & 1) + ((bits >> 2) & 1) + (bits >> 3);
+			}
+		}
+		*outNext = i;
+		return validCount;
+	}
+
+	// Selects the kernel for the table's dimension count
+	template<typename TStorage>
+	ZJLD_TARGET_AVX2 size_t EvaluateBatchAvx2(const simd::BatchLayout& aLayout,
+		const double* const* aDimValues,
+		const size_t aBegin,
+		const size_t aEnd,
+		double* outValues,
+		uint64_t* outValidMask,
+		size_t* outNext)
+	{
+		switch (aLayout.dims) {
+		case 2:
+			return EvaluateBatchAvx2<2, TStorage>(aLayout, aDimValues, aBegin, aEnd, outValues, outValidMask, outNext);
+		case 3:
+			return EvaluateBatchAvx2<3, TStorage>(aLayout, aDimValues, aBegin, aEnd, outValues, outValidMask, outNext);
+		default:
+			return EvaluateBatchAvx2<0, TStorage>(aLayout, aDimValues, aBegin, aEnd, outValues, outValidMask, outNext);
+		}
+	}
+
+
+	// The AVX-512 kernels below are the same as the AVX2 ones above, step by step, on 8
+	// lanes instead of 4 and with mask registers in place of all-ones lanes, so their
+	// results are bit-identical as well.
+#if defined(__GNUC__) && !defined(__clang__)
+	// The AVX-512 intrinsics of GCC 12 initialize their undefined operands from themselves,
+	// which -Wuninitialized wrongly reports wherever they are inlined
+	#pragma GCC diagnostic push
+	#pragma GCC diagnostic ignored "-Wuninitialized"
+	#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+	ZJLD_TARGET_AVX512 inline __m512d ToDouble(const __m512i aValues)
+	{
+		return _mm512_cvtepi32_pd(_mm512_cvtepi64_epi32(aValues));
+	}
+
+	ZJLD_TARGET_AVX512 inline __mmask8 IsApproxEqual(const __m512d aA,
+		const __m512d aB)
+	{
+		const __m512d diff = _mm512_abs_pd(_mm512_sub_pd(aA, aB));
+		const __m512d max = _mm512_max_pd(_mm512_abs_pd(aA), _mm512_abs_pd(aB));
+		const __m512d eps = _mm512_mul_pd(
+			_mm512_mul_pd(max, _mm512_set1_pd(std::numeric_limits<double>::epsilon())),
+			_mm512_set1_pd(5.0));
+		return _mm512_cmp_pd_mask(diff, eps, _CMP_LE_OQ);
+	}
+
+	// Number of 8-lane vectors processed together (the same number of points as kGroup)
+	static const size_t kGroup512 = 4;
+
+	ZJLD_TARGET_AVX512 inline void FindPositionInfo(const double* aData,
+		const size_t aSize,
+		const bool aUniform,
+		const double aOrigin,
+		const double aInvStep,
+		const LookupAxis::BoundPolicy aBounds,
+		const double* aValues,
+		__mmask8* ioValid,
+		__m512i* outLowIdx,
+		__m512d* outPercProgress)
+	{
+		const __m512d front = _mm512_set1_pd(aData[0]);
+		const __m512d back = _mm512_set1_pd(aData[aSize - 1]);
+		const bool extrapolate = (aBounds == LookupAxis::BoundPolicy::Extrapolate);
+		const bool error = (aBounds == LookupAxis::BoundPolicy::Error);
+		__m512d values[kGroup512];
+		__m512d clamped[kGroup512];
+		__m512i l[kGroup512];
+		for (size_t g = 0; g < kGroup512; g++) {
+			const __m512d value = _mm512_loadu_pd(aValues + 8 * g);
+			clamped[g] = _mm512_min_pd(_mm512_max_pd(value, front), back);
+			const __mmask8 accepted = error ? _mm512_cmp_pd_mask(value, clamped[g], _CMP_EQ_OQ)
+				: _mm512_cmp_pd_mask(value, value, _CMP_ORD_Q);
+			ioValid[g] = ioValid[g] & accepted;
+			values[g] = extrapolate ? _mm512_mask_blend_pd(accepted, clamped[g], value) : clamped[g];
+			l[g] = _mm512_setzero_si512();
+		}
+
+		const __m512i lastSegment = _mm512_set1_epi64(static_cast<long long>(aSize - 2));
+		if (aUniform) {
+			const __m512d origin = _mm512_set1_pd(aOrigin);
+			const __m512d invStep = _mm512_set1_pd(aInvStep);
+			const __m512i zero = _mm512_setzero_si512();
+			const __m512i one = _mm512_set1_epi64(1);
+			for (size_t g = 0; g < kGroup512; g++) {
+				const __m512d estimate = _mm512_mul_pd(_mm512_sub_pd(clamped[g], origin), invStep);
+				__m512i est = _mm512_cvtepi32_epi64(_mm512_cvttpd_epi32(estimate));
+				est = _mm512_min_epi64(est, lastSegment);
+				const __m512d dataL = _mm512_i64gather_pd(est, aData, 8);
+				const __mmask8 down = _mm512_cmpgt_epi64_mask(est, zero)
+					& _mm512_cmp_pd_mask(dataL, clamped[g], _CMP_GT_OQ);
+				est = _mm512_mask_sub_epi64(est, down, est, one);
+				const __m512d dataR = _mm512_i64gather_pd(est, aData + 1, 8);
+				const __mmask8 up = _mm512_cmpgt_epi64_mask(lastSegment, est)
+					& _mm512_cmp_pd_mask(dataR, clamped[g], _CMP_LE_OQ);
+				l[g] = _mm512_mask_add_epi64(est, up, est, one);
+			}
+		}
+
+		for (size_t len = aUniform ? 1 : aSize - 1; len > 1; ) {
+			const size_t half = len / 2;
+			const __m512i halfV = _mm512_set1_epi64(static_cast<long long>(half));
+			for (size_t g = 0; g < kGroup512; g++) {
+				const __m512d probe = _mm512_i64gather_pd(_mm512_add_epi64(l[g], halfV), aData, 8);
+				const __mmask8 step = _mm512_cmp_pd_mask(probe, clamped[g], _CMP_LE_OQ);
+				l[g] = _mm512_mask_add_epi64(l[g], step, l[g], halfV);
+			}
+			len -= half;
+		}
+
+		for (size_t g = 0; g < kGroup512; g++) {
+			const __m512d value = values[g];
+			const __m512d dataL = _mm512_i64gather_pd(l[g], aData, 8);
+			const __m512d dataR = _mm512_i64gather_pd(l[g], aData + 1, 8);
+			const __mmask8 snapL = IsApproxEqual(value, dataL)
+				& _mm512_cmpgt_epi64_mask(l[g], _mm512_setzero_si512());
+			const __mmask8 snapR = static_cast<__mmask8>(~snapL) & IsApproxEqual(value, dataR);
+			__m512d perc = _mm512_div_pd(_mm512_sub_pd(value, dataL), _mm512_sub_pd(dataR, dataL));
+			perc = _mm512_maskz_mov_pd(static_cast<__mmask8>(~IsApproxEqual(dataL, dataR)), perc);
+			const __m512d lowD = ToDouble(l[g]);
+			__m512d pos = _mm512_add_pd(lowD, perc);
+			pos = _mm512_mask_blend_pd(snapL, pos, lowD);
+			pos = _mm512_mask_blend_pd(snapR, pos, _mm512_add_pd(lowD, _mm512_set1_pd(1.0)));
+
+			__m512d low = _mm512_roundscale_pd(pos, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC);
+			low = _mm512_min_pd(_mm512_max_pd(low, _mm512_setzero_pd()),
+				_mm512_set1_pd(static_cast<double>(aSize - 2)));
+			outLowIdx[g] = _mm512_cvtepi32_epi64(_mm512_cvttpd_epi32(low));
+			outPercProgress[g] = _mm512_sub_pd(pos, low);
+		}
+	}
+
+	ZJLD_TARGET_AVX512 inline __m512d GatherDepData(const double* aData,
+		const __m512i aIndices)
+	{
+		return _mm512_i64gather_pd(aIndices, aData, 8);
+	}
+	ZJLD_TARGET_AVX512 inline __m512d GatherDepData(const float* aData,
+		const __m512i aIndices)
+	{
+		return _mm512_cvtps_pd(_mm512_i64gather_ps(aIndices, aData, 4));
+	}
+	ZJLD_TARGET_AVX512 inline __m512d GatherDepData(const BFloat16* aData,
+		const __m512i aIndices)
+	{
+		const __m256i pairs = _mm512_i64gather_epi32(aIndices, aData, 2);
+		return _mm512_cvtps_pd(_mm256_castsi256_ps(_mm256_slli_epi32(pairs, 16)));
+	}
+
+	// Evaluates points 8 * kGroup512 at a time (see EvaluateBatchAvx2)
+	template<size_t kFixedDims, typename TStorage>
+	ZJLD_TARGET_AVX512 size_t EvaluateBatchAvx512(const simd::BatchLayout& aLayout,
+		const double* const* aDimValues,
+		const size_t aBegin,
+		const size_t aEnd,
+		double* outValues,
+		uint64_t* outValidMask,
+		size_t* outNext)
+	{
+		const size_t kDims = (kFixedDims > 0) ? kFixedDims : aLayout.dims;
+		const size_t kMaxDims = (kFixedDims > 0) ? kFixedDims : simd::kMaxDimensions;
+		const size_t comboCount = static_cast<size_t>(1) << kDims;
+		const __m512d nan = _mm512_set1_pd(std::numeric_limits<double>::quiet_NaN());
+		const TStorage* depData = static_cast<const TStorage*>(aLayout.depData);
+
+		__mmask8 valid[kGroup512];
+		__m512i lowIdxs[kMaxDims][kGroup512];
+		__m512d prcPrgs[kMaxDims][kGroup512];
+		__m512i offsets[static_cast<size_t>(1) << kMaxDims];
+		__m512i steps[kMaxDims];
+		const bool tiled = (nullptr != aLayout.dimOffsets[0]);
+		__m512d vals[static_cast<size_t>(1) << kMaxDims];
+		size_t validCount = 0;
+		size_t i = aBegin;
+		for (; i + 8 * kGroup512 <= aEnd; i += 8 * kGroup512) {
+			for (size_t g = 0; g < kGroup512; g++) {
+				valid[g] = 0xFF;
+			}
+			for (size_t k = 0; k < kDims; k++) {
+				FindPositionInfo(aLayout.axes[k], aLayout.axisSizes[k], aLayout.uniform[k],
+					aLayout.origins[k], aLayout.invSteps[k], aLayout.bounds[k], aDimValues[k] + i,
+					valid, lowIdxs[k], prcPrgs[k]);
+			}
+
+			for (size_t g = 0; g < kGroup512; g++) {
+				offsets[0] = _mm512_setzero_si512();
+				for (size_t k = 0; k < kDims; k++) {
+					if (tiled) {
+						const long long* dimOffsets =
+							reinterpret_cast<const long long*>(aLayout.dimOffsets[k]);
+						const __m512i low = _mm512_i64gather_epi64(lowIdxs[k][g], dimOffsets, 8);
+						const __m512i high = _mm512_i64gather_epi64(lowIdxs[k][g], dimOffsets + 1, 8);
+						offsets[0] = _mm512_add_epi64(offsets[0], low);
+						steps[k] = _mm512_sub_epi64(high, low);
+					}
+					else {
+						steps[k] = _mm512_set1_epi64(static_cast<long long>(aLayout.strides[k]));
+						offsets[0] = _mm512_add_epi64(offsets[0],
+							_mm512_mul_epu32(lowIdxs[k][g], steps[k]));
+					}
+				}
+				for (size_t k = 0, bit = 1; k < kDims; k++, bit <<= 1) {
+					const __m512i step = steps[kDims - k - 1];
+					for (size_t j = 0; j < bit; j++) {
+						offsets[j | bit] = _mm512_add_epi64(offsets[j], step);
+					}
+				}
+				for (size_t c = 0; c < comboCount; c++) {
+					vals[c] = GatherDepData(depData, offsets[c]);
+				}
+				for (size_t k = 0, count = comboCount; k < kDims; k++, count >>= 1) {
+					const __m512d prc = prcPrgs[kDims - k - 1][g];
+					for (size_t j = 1; j < count; j += 2) {
+						vals[j / 2] = _mm512_add_pd(vals[j - 1],
+							_mm512_mul_pd(prc, _mm512_sub_pd(vals[j], vals[j - 1])));
+					}
+				}
+
+				const size_t p = i + 8 * g;
+				_mm512_storeu_pd(outValues + p, _mm512_mask_blend_pd(valid[g], nan, vals[0]));
+				const unsigned int bits = valid[g];
+				outValidMask[p / 64] |= static_cast<uint64_t>(bits) << (p % 64);
+				for (unsigned int b = bits; b != 0; b &= b - 1) {
+					validCount++;
+				}
+			}
+		}
+		*outNext = i;
+		return validCount;
+	}
+
+	template<typename TStorage>
+	ZJLD_TARGET_AVX512 size_t EvaluateBatchAvx512(const simd::BatchLayout& aLayout,
+		const double* const* aDimValues,
+		const size_t aBegin,
+		const size_t aEnd,
+		double* outValues,
+		uint64_t* outValidMask,
+		size_t* outNext)
+	{
+		switch (aLayout.dims) {
+		case 2:
+			return EvaluateBatchAvx512<2, TStorage>(aLayout, aDimValues, aBegin, aEnd, outValues, outValidMask, outNext);
+		case 3:
+			return EvaluateBatchAvx512<3, TStorage>(aLayout, aDimValues, aBegin, aEnd, outValues, outValidMask, outNext);
+		default:
+			return EvaluateBatchAvx512<0, TStorage>(aLayout, aDimValues, aBegin, aEnd, outValues, outValidMask, outNext);
+		}
+	}
+
+#if defined(__GNUC__) && !defined(__clang__)
+	#pragma GCC diagnostic pop
+#endif
+
+	// Returns true if the AVX-512 kernels can be used on this machine (checked once)
+	bool Avx512Available()
+	{
+	#if defined(_MSC_VER)
+		static const bool kAvailable = []() {
+			int info[4];
+			__cpuid(info, 1);
+			if (!(info[2] & (1 << 27)) || (_xgetbv(0) & 0xE6) != 0xE6) // OSXSAVE, zmm state
+				return false;
+			__cpuidex(info, 7, 0);
+			return (info[1] & (1 << 16)) != 0; // AVX512F
+		}();
+	#else
+		static const bool kAvailable = __builtin_cpu_supports("avx512f");
+	#endif
+		return kAvailable;
+	}
+}
+#endif
+
+
+
+
+bool simd::Available()
+{
+#if defined(ZJLD_SIMD_AVX2) && defined(_MSC_VER)
+	static const bool kAvailable = []() {
+		int info[4];
+		__cpuid(info, 1);
+		const bool osAvx = (info[2] & (1 << 27)) && (info[2] & (1 << 28)); // OSXSAVE, AVX
+		if (!osAvx || (_xgetbv(0) & 6) != 6)
+			return false;
+		__cpuidex(info, 7, 0);
+		return (info[1] & (1 << 5)) != 0; // AVX2
+	}();
+	return kAvailable;
+#elif defined(ZJLD_SIMD_AVX2)
+	static const bool kAvailable = __builtin_cpu_supports("avx2");
+	return kAvailable;
+#else
+	return false;
+#endif
+}
+
+size_t simd::EvaluateBatch(const BatchLayout& aLayout,
+	const double* const* aDimValues,
+	const size_t aBegin,
+	const size_t aEnd,
+	double* outValues,
+	uint64_t* outValidMask,
+	size_t* outNext)
+{
+	*outNext = aBegin;
+#if defined(ZJLD_SIMD_AVX2)
+	// The corner index math multiplies 32-bit indices by 32-bit strides, and the search
+	// converts indices through 32-bit integers
+	const uint64_t k32BitLimit = static_cast<uint64_t>(1) << 31;
+	if (!Available() || aLayout.dims < 1 || aLayout.dims > kMaxDimensions
+		|| aLayout.depDataSize >= k32BitLimit)
+		return 0;
+	for (size_t k = 0; k < aLayout.dims; k++) {
+		if (aLayout.axisSizes[k] < 2)
+			return 0; // leave it to the scalar path to reject
+	}
+
+	if (Avx512Available()) {
+		switch (aLayout.depStorage) {
+		case StorageType::Float:
+			return EvaluateBatchAvx512<float>(aLayout, aDimValues, aBegin, aEnd, outValues, outValidMask, outNext);
+		case StorageType::BFloat16:
+			return EvaluateBatchAvx512<BFloat16>(aLayout, aDimValues, aBegin, aEnd, outValues, outValidMask, outNext);
+		default:
+			return EvaluateBatchAvx512<double>(aLayout, aDimValues, aBegin, aEnd, outValues, outValidMask, outNext);
+		}
+	}
+	switch (aLayout.depStorage) {
+	case StorageType::Float:
+		return EvaluateBatchAvx2<float>(aLayout, aDimValues, aBegin, aEnd, outValues, outValidMask, outNext);
+	case StorageType::BFloat16:
+		return EvaluateBatchAvx2<BFloat16>(aLayout, aDimValues, aBegin, aEnd, outValues, outValidMask, outNext);
+	default:
+		return EvaluateBatchAvx2<double>(aLayout, aDimValues, aBegin, aEnd, outValues, outValidMask, outNext);
+	}
+#else
+	(void)aLayout; (void)aDimValues; (void)aEnd; (void)outValues; (void)outValidMask;
+	return 0;
+#endif
+}
@@ -0,0 +1,83 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+// This file is part of LookupTable <https://github.com/zjldemers/LookupTable>.
+// 
+// MIT License
+// Copyright (c) 2022 Zachary J. L. Demers
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef _ZJLD_LOOKUP_SIMD_H_
+#define _ZJLD_LOOKUP_SIMD_H_
+
+#include <cstddef>
+#include <cstdint>
+#include "LookupAxis.h"
+#include "LookupStorage.h"
+
+namespace zjld // feel free to remove/rename as the license above allows
+{
+	namespace simd
+	{
+		// Maximum number of dimensions supported by the SIMD kernels (matches
+		// LookupTableND::kMaxFastDimensions)
+		static const size_t kMaxDimensions = 8;
+
+		// Flat description of a table's data used by the batch kernels, so that this
+		// header does not depend on any of the table classes.
+		struct BatchLayout {
+			size_t dims;                          // number of independent dimensions
+			const double* axes[kMaxDimensions];   // independent data per dimension
+			size_t axisSizes[kMaxDimensions];     // size of each independent data vector
+			size_t strides[kMaxDimensions];       // dependent data step per dimension
+			const size_t* dimOffsets[kMaxDimensions]; // dependent data offset per index
+			                                          // (all null if strides are used)
+			bool uniform[kMaxDimensions];         // true if evenly spaced (see LookupAxis)
+			double origins[kMaxDimensions];       // first value (uniform dimensions only)
+			double invSteps[kMaxDimensions];      // reciprocal spacing (uniform only)
+			LookupAxis::BoundPolicy bounds[kMaxDimensions]; // out of bounds handling
+			const void* depData;                  // dependent data (see LookupStorage::Data)
+			size_t depDataSize;                   // number of values in depData
+			StorageType depStorage;               // type of the values in depData
+		};
+
+		// Returns true if the SIMD batch kernels can be used on this machine (checked once
+		// at runtime, so a single binary can run on machines with and without support).
+		// The AVX-512 kernels are used where supported, otherwise the AVX2 ones (there are
+		// no NEON kernels yet).  Defining ZJLD_LOOKUP_NO_SIMD disables the kernels entirely.
+		bool Available();
+
+		// Evaluates as many points of [aBegin, aEnd) as the SIMD width allows, with the same
+		// semantics as LookupTableND::EvaluateBatch, and returns the number of valid points.
+		// outNext receives the index of the first point that was not evaluated (aBegin if
+		// the kernels are unavailable), which the caller should finish with the scalar path.
+		// The results are bit-identical to the scalar implementation: the branchless segment
+		// search runs the same steps for all lanes, and interpolation uses separate multiplies
+		// and adds (no fused multiply-add) so that rounding matches utils::Lerp.
+		size_t EvaluateBatch(const BatchLayout& aLayout,
+			const double* const* aDimValues,
+			const size_t aBegin,
+			const size_t aEnd,
+			double* outValues,
+			uint64_t* outValidMask,
+			size_t* outNext);
+	}
+}
+
+#endif // _ZJLD_LOOKUP_SIMD_H_
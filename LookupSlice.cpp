@@ -0,0 +1,176 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+// This file is part of LookupTable <https://github.com/zjldemers/LookupTable>.
+// 
+// MIT License
+// Copyright (c) 2022 Zachary J. L. Demers
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "LookupSlice.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include "LookupTableND.h"
+#include "LookupUtils.hpp"
+
+using namespace zjld; // feel free to remove/rename as the license above allows
+
+
+LookupSlice::LookupSlice()
+	: _table{ nullptr }
+	, _generation{ 0 }
+	, _dimension{ 0 }
+	, _inputs{}
+	, _breakpoints{}
+	, _values{}
+	, _order{ Order::None }
+{}
+
+void LookupSlice::Reset()
+{
+	_table = nullptr;
+	_generation = 0;
+	_dimension = 0;
+	_inputs.clear();
+	_breakpoints.clear();
+	_values.clear();
+	_order = Order::None;
+}
+
+
+bool LookupSlice::Valid() const
+{
+	return nullptr != _table;
+}
+size_t LookupSlice::Dimension() const
+{
+	return _dimension;
+}
+const TableData& LookupSlice::Inputs() const
+{
+	return _inputs;
+}
+const TableData& LookupSlice::Breakpoints() const
+{
+	return _breakpoints;
+}
+const TableData& LookupSlice::Values() const
+{
+	return _values;
+}
+LookupSlice::Order LookupSlice::Direction() const
+{
+	return _order;
+}
+
+
+bool LookupSlice::Matches(const LookupTableND* aTable,
+	const size_t& aDimension,
+	const double* aInputs,
+	const size_t& aCount) const
+{
+	if (nullptr == _table || aTable != _table || aTable->Generation() != _generation
+		|| aDimension != _dimension || aCount != _inputs.size())
+		return false;
+	for (size_t i = 0; i < aCount; i++) {
+		if (i != aDimension && aInputs[i] != _inputs[i])
+			return false;
+	}
+	return true;
+}
+
+
+size_t LookupSlice::FindRoots(const double& aTarget,
+	std::vector<double>* outRoots) const
+{
+	if (nullptr == outRoots || _values.size() < 2)
+		return 0;
+	const size_t initialSize = outRoots->size();
+	double root;
+	for (size_t i = 0; i + 1 < _values.size(); i++) {
+		if (SegmentRoot(i, aTarget, &root))
+			outRoots->push_back(root);
+	}
+	if (_values.back() == aTarget)
+		outRoots->push_back(_breakpoints.back());
+	return outRoots->size() - initialSize;
+}
+
+bool LookupSlice::FindFirstRoot(const double& aTarget,
+	double* outRoot) const
+{
+	if (nullptr == outRoot || _values.size() < 2)
+		return false;
+
+	// Monotonic values first reach aTarget at the breakpoint found by a binary search, so
+	// the first root is in the segment before it (or at it), while others must be scanned
+	size_t first = 0;
+	if (_order != Order::None) {
+		const std::vector<double>::const_iterator reached = (_order == Order::Increasing)
+			? std::lower_bound(_values.begin(), _values.end(), aTarget)
+			: std::lower_bound(_values.begin(), _values.end(), aTarget, std::greater<double>());
+		const size_t idx = static_cast<size_t>(reached - _values.begin());
+		first = (idx > 0) ? idx - 1 : 0;
+	}
+	for (size_t i = first; i + 1 < _values.size(); i++) {
+		if (SegmentRoot(i, aTarget, outRoot))
+			return true;
+	}
+	if (_values.back() == aTarget) {
+		*outRoot = _breakpoints.back();
+		return true;
+	}
+	return false;
+}
+
+
+void LookupSlice::FindOrder()
+{
+	bool increasing = true, decreasing = true;
+	for (size_t i = 1; i < _values.size(); i++) {
+		increasing = increasing && (_values[i - 1] <= _values[i]);
+		decreasing = decreasing && (_values[i - 1] >= _values[i]);
+	}
+	// Constant values are treated as Increasing, while NaN values are neither
+	_order = increasing ? Order::Increasing : (decreasing ? Order::Decreasing : Order::None);
+}
+
+bool LookupSlice::SegmentRoot(const size_t& aSegment,
+	const double& aTarget,
+	double* outRoot) const
+{
+	const double lowDiff = _values[aSegment] - aTarget;
+	const double highDiff = _values[aSegment + 1] - aTarget;
+	if (lowDiff == 0.0) {
+		*outRoot = _breakpoints[aSegment];
+		return true;
+	}
+	if (highDiff == 0.0 || (lowDiff < 0.0) == (highDiff < 0.0))
+		return false; // the upper breakpoint belongs to the next segment (or no crossing)
+	if (std::isnan(lowDiff) || std::isnan(highDiff))
+		return false; // NaN values or target
+
+	// Strictly within the segment, so invert the linear interpolation between its ends
+	// (kept within them despite any rounding, so that the root is never out of bounds)
+	const double percProgress = utils::ILerp(_values[aSegment], _values[aSegment + 1], aTarget);
+	const double root = utils::Lerp(_breakpoints[aSegment], _breakpoints[aSegment + 1], percProgress);
+	*outRoot = std::min(std::max(root, _breakpoints[aSegment]), _breakpoints[aSegment + 1]);
+	return true;
+}
@@ -0,0 +1,122 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+// This file is part of LookupTable <https://github.com/zjldemers/LookupTable>.
+// 
+// MIT License
+// Copyright (c) 2022 Zachary J. L. Demers
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef _ZJLD_LOOKUP_SLICE_H_
+#define _ZJLD_LOOKUP_SLICE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "LookupAxis.h"
+
+namespace zjld // feel free to remove/rename as the license above allows
+{
+
+	class LookupTableND;
+
+
+	// This holds a 1-dimensional slice of a table: the value of the table at each
+	// breakpoint of one dimension while every other input is held fixed.  As tables
+	// interpolate linearly along each dimension, the slice gives the table's values along
+	// that whole dimension, so it can be searched directly for the inputs that give a
+	// target value (an inverse lookup) without any further lookups into the table.
+	// Slices are filled by LookupTableND::QuerySlice (and the inverse lookup methods),
+	// which keep an existing slice as it is if it already holds the one asked for.  Like
+	// a LookupHint, a slice belongs to the caller, so const tables stay safe to share
+	// between threads as long as each thread uses its own slices.
+	class LookupSlice
+	{
+		friend class LookupTableND; // fills in the slice
+
+	public:
+		// The direction of a slice's values, where monotonic slices may contain flat
+		// segments (e.g. 1, 2, 2, 3 is Increasing)
+		enum class Order { None, Increasing, Decreasing };
+
+	private:
+		const LookupTableND* _table; // table the slice was taken from (null if empty)
+		uint64_t _generation;        // the table's Generation when it was taken
+		size_t _dimension;           // dimension of the table the slice runs along
+		TableData _inputs;           // inputs it was taken at (that of _dimension unused)
+		TableData _breakpoints;      // breakpoints of _dimension
+		TableData _values;           // table's value at each of the breakpoints
+		Order _order;                // direction of _values
+
+	public:
+		LookupSlice();
+
+		/* This empties the slice.  Slices of a table that has since been repopulated (or
+		* whose options have changed) never match it again (see Matches), so they need not
+		* be reset.
+		*/
+		void Reset();
+
+		bool Valid() const;                   // false until filled by a table
+		size_t Dimension() const;             // dimension of the table it runs along
+		const TableData& Inputs() const;      // inputs it was taken at
+		const TableData& Breakpoints() const; // breakpoints of that dimension
+		const TableData& Values() const;      // table's value at each breakpoint
+		Order Direction() const;              // direction of its values
+
+		/* Returns true if this holds the slice of aTable along aDimension at aInputs
+		* (aCount values, one per dimension of the table), ignoring the input of aDimension,
+		* as taken from the table's current data and options (see
+		* LookupTableND::Generation).
+		*/
+		bool Matches(const LookupTableND* aTable,
+			const size_t& aDimension,
+			const double* aInputs,
+			const size_t& aCount) const;
+
+		/* These search the slice for the inputs (of its dimension) where the table gives
+		* aTarget, within its breakpoints.  Within each segment the values are linear, so
+		* each crossing of aTarget is found by inverse interpolation, while a flat run of
+		* values equal to aTarget gives each of its breakpoints.  Every such input is
+		* appended to outRoots in increasing order and the number of them returned, where
+		* FindFirstRoot only finds the lowest one (returning false if there are none) using
+		* a binary search if the values are monotonic.
+		*/
+		size_t FindRoots(const double& aTarget,
+			std::vector<double>* outRoots) const;
+		bool FindFirstRoot(const double& aTarget,
+			double* outRoot) const;
+
+	private:
+		/* This finds _order from _values.
+		*/
+		void FindOrder();
+
+		/* Returns true with outRoot set to the root of segment aSegment, i.e. the input
+		* within [_breakpoints[aSegment], _breakpoints[aSegment + 1]) giving aTarget, if
+		* there is one (so the last breakpoint must be checked separately).
+		*/
+		bool SegmentRoot(const size_t& aSegment,
+			const double& aTarget,
+			double* outRoot) const;
+	};
+
+}
+
+#endif // _ZJLD_LOOKUP_SLICE_H_
@@ -0,0 +1,229 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+// This file is part of LookupTable <https://github.com/zjldemers/LookupTable>.
+// 
+// MIT License
+// Copyright (c) 2022 Zachary J. L. Demers
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "LookupStats.h"
+#include <algorithm>
+#include <mutex>
+#include <type_traits>
+
+using namespace zjld; // feel free to remove/rename as the license above allows
+
+
+#if defined(ZJLD_LOOKUP_STATS)
+namespace
+{
+	// Blocks of the running threads along with the sum of those that have exited
+	struct Registry
+	{
+		std::mutex mutex;
+		std::vector<stats::ThreadBlock*> blocks;
+		LookupStats retired;
+	};
+
+	Registry& GetRegistry()
+	{
+		static Registry* registry = new Registry(); // never destroyed, as threads may
+		return *registry;                           // still exit after static destruction
+	}
+
+	// Adds the counts of aBlock to ioStats
+	void Accumulate(const stats::ThreadBlock& aBlock,
+		LookupStats* ioStats)
+	{
+		uint64_t* counters[stats::kCounterCount] = { &ioStats->queries, &ioStats->outOfBounds,
+			&ioStats->exactHits, &ioStats->searches, &ioStats->searchSteps };
+		for (size_t i = 0; i < stats::kCounterCount; i++) {
+			*counters[i] += aBlock.counters[i].load(std::memory_order_relaxed);
+		}
+		for (size_t b = 0; b < LookupStats::kLatencyBuckets; b++) {
+			ioStats->latency[b] += aBlock.latency[b].load(std::memory_order_relaxed);
+		}
+	}
+
+	// Set once the calling thread's block has been retired
+	thread_local bool tExited = false;
+
+	// Moves the calling thread's counts into the retired sum when it exits
+	struct ThreadRetirer
+	{
+		stats::ThreadBlock* block = nullptr; // set when the thread registers
+
+		~ThreadRetirer()
+		{
+			tExited = true;
+			if (nullptr == block)
+				return;
+			Registry& registry = GetRegistry();
+			{
+				std::lock_guard<std::mutex> lock(registry.mutex);
+				Accumulate(*block, &registry.retired);
+				registry.blocks.erase(std::find(registry.blocks.begin(), registry.blocks.end(), block));
+			}
+			stats::tBlock = nullptr;
+			delete block;
+		}
+	};
+	thread_local ThreadRetirer tRetirer;
+
+	// Written by lookups made by thread_local destructors after the thread's own block was
+	// retired, which are not counted.  Each thread has its own so that they never race,
+	// and it needs no destructor, so it stays usable during those destructors.
+	thread_local stats::ThreadBlock tDiscarded;
+	static_assert(std::is_trivially_destructible<stats::ThreadBlock>::value,
+		"Discarded blocks must stay usable while thread_local objects are destroyed.");
+}
+
+
+stats::ThreadBlock* stats::RegisterThread()
+{
+	if (tExited)
+		return &tDiscarded;
+	ThreadBlock* block = new ThreadBlock();
+	for (std::atomic<uint64_t>& count : block->counters) {
+		count.store(0, std::memory_order_relaxed);
+	}
+	for (std::atomic<uint64_t>& count : block->latency) {
+		count.store(0, std::memory_order_relaxed);
+	}
+	block->countdown = kLatencySampleInterval;
+
+	Registry& registry = GetRegistry();
+	std::lock_guard<std::mutex> lock(registry.mutex);
+	registry.blocks.push_back(block);
+	tRetirer.block = block;
+	tBlock = block;
+	return block;
+}
+
+void stats::AddLatency(ThreadBlock& ioBlock,
+	const uint64_t aNanoseconds)
+{
+	size_t bucket = 0;
+	for (uint64_t ns = aNanoseconds; ns > 1 && bucket < LookupStats::kLatencyBuckets - 1; ns >>= 1) {
+		bucket++;
+	}
+	std::atomic<uint64_t>& count = ioBlock.latency[bucket];
+	count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+#endif
+
+
+
+
+// ==== Begin Section: LookupStats (Public) ==== //
+LookupStats::LookupStats()
+	: queries{ 0 }
+	, outOfBounds{ 0 }
+	, exactHits{ 0 }
+	, searches{ 0 }
+	, searchSteps{ 0 }
+	, latency{}
+	, threads{ 0 }
+{}
+
+LookupStats& LookupStats::operator+=(const LookupStats& aOther)
+{
+	queries += aOther.queries;
+	outOfBounds += aOther.outOfBounds;
+	exactHits += aOther.exactHits;
+	searches += aOther.searches;
+	searchSteps += aOther.searchSteps;
+	for (size_t b = 0; b < kLatencyBuckets; b++) {
+		latency[b] += aOther.latency[b];
+	}
+	threads += aOther.threads;
+	return *this;
+}
+
+uint64_t LookupStats::LatencySamples() const
+{
+	uint64_t samples = 0;
+	for (const uint64_t& count : latency) {
+		samples += count;
+	}
+	return samples;
+}
+
+double LookupStats::LatencyQuantile(const double& aQuantile) const
+{
+	const uint64_t samples = LatencySamples();
+	if (samples == 0)
+		return 0.0;
+	// Find the first bucket at or beyond the rank of the quantile
+	const double rank = std::min(std::max(aQuantile, 0.0), 1.0) * static_cast<double>(samples);
+	uint64_t seen = 0;
+	size_t b = 0;
+	for (; b < kLatencyBuckets - 1; b++) {
+		seen += latency[b];
+		if (static_cast<double>(seen) >= rank && seen > 0)
+			break;
+	}
+	return static_cast<double>(static_cast<uint64_t>(1) << (b + 1));
+}
+// ==== End Section: LookupStats (Public) ==== //
+
+
+
+
+// ==== Begin Section: Snapshots (Public) ==== //
+bool stats::Enabled()
+{
+#if defined(ZJLD_LOOKUP_STATS)
+	return true;
+#else
+	return false;
+#endif
+}
+
+LookupStats stats::TakeSnapshot()
+{
+	LookupStats snapshot;
+#if defined(ZJLD_LOOKUP_STATS)
+	Registry& registry = GetRegistry();
+	std::lock_guard<std::mutex> lock(registry.mutex);
+	snapshot = registry.retired;
+	for (const ThreadBlock* block : registry.blocks) {
+		Accumulate(*block, &snapshot);
+	}
+	snapshot.threads = registry.blocks.size();
+#endif
+	return snapshot;
+}
+
+std::vector<LookupStats> stats::TakeThreadSnapshots()
+{
+	std::vector<LookupStats> snapshots;
+#if defined(ZJLD_LOOKUP_STATS)
+	Registry& registry = GetRegistry();
+	std::lock_guard<std::mutex> lock(registry.mutex);
+	for (const ThreadBlock* block : registry.blocks) {
+		snapshots.emplace_back();
+		Accumulate(*block, &snapshots.back());
+		snapshots.back().threads = 1;
+	}
+#endif
+	return snapshots;
+}
+// ==== End Section: Snapshots (Public) ==== //
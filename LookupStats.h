@@ -0,0 +1,192 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+// This file is part of LookupTable <https://github.com/zjldemers/LookupTable>.
+// 
+// MIT License
+// Copyright (c) 2022 Zachary J. L. Demers
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef _ZJLD_LOOKUP_STATS_H_
+#define _ZJLD_LOOKUP_STATS_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Instrumentation of the lookup hot paths is opt-in: it is only compiled in when
+// ZJLD_LOOKUP_STATS is defined (for every file including the LookupTable headers, e.g.
+// through the ZJLD_LOOKUP_STATS option of the CMake project).  Otherwise the hooks below
+// compile to nothing and every snapshot is empty.
+#if defined(ZJLD_LOOKUP_STATS)
+	#define ZJLD_LOOKUP_STATS_ONLY(...) __VA_ARGS__
+#else
+	#define ZJLD_LOOKUP_STATS_ONLY(...)
+#endif
+
+namespace zjld // feel free to remove/rename as the license above allows
+{
+
+	// This holds the lookup statistics of one thread, or the sum over many (see
+	// stats::TakeSnapshot).  Every count only ever grows, so rates are found by
+	// subtracting consecutive snapshots, as metrics systems usually expect of counters.
+	struct LookupStats
+	{
+		// Latencies are kept in power of two buckets of nanoseconds: bucket b counts the
+		// lookups taking [2^b, 2^(b+1)) ns (bucket 0 also those under 1 ns), while the last
+		// bucket counts everything longer.
+		static const size_t kLatencyBuckets = 32;
+
+		uint64_t queries;     // lookups by indices or values, plus every point of a batch
+		uint64_t outOfBounds; // of those, rejected as out of bounds (or NaN)
+		uint64_t exactHits;   // dimensions found (approximately) at a breakpoint, needing no
+		                      // interpolation along them
+		uint64_t searches;    // dimensions whose segment was searched for
+		uint64_t searchSteps; // iterations of those searches (binary search steps, Eytzinger
+		                      // levels and hinted galloping), so searchSteps / searches is
+		                      // the mean search depth
+		uint64_t latency[kLatencyBuckets]; // sampled single lookups (see above)
+		size_t threads;       // threads included (those that exited are summed, not counted)
+
+		LookupStats();
+		LookupStats& operator+=(const LookupStats& aOther);
+
+		/* This returns the number of latency samples, i.e. the sum of all buckets.
+		*/
+		uint64_t LatencySamples() const;
+
+		/* This returns the upper bound in nanoseconds of the bucket holding the given
+		* quantile of the latency samples (e.g. 0.99 for the 99th percentile), or 0 if
+		* there are none.
+		*/
+		double LatencyQuantile(const double& aQuantile) const;
+	};
+
+
+	namespace stats
+	{
+		// Every single lookup is counted, but only one in this many (per thread) is timed,
+		// as reading the clock costs far more than the rest of the instrumentation
+		static const uint32_t kLatencySampleInterval = 64;
+
+		/* This returns true if the instrumentation is compiled in (see ZJLD_LOOKUP_STATS).
+		*/
+		bool Enabled();
+
+		/* These return the statistics summed over every thread that has done lookups (the
+		* first, including threads that have since exited) or those of each thread still
+		* running (the second).  Both may be called at any time from any thread, and only
+		* block threads doing their first lookup (or exiting) while collecting.
+		*/
+		LookupStats TakeSnapshot();
+		std::vector<LookupStats> TakeThreadSnapshots();
+
+
+#if defined(ZJLD_LOOKUP_STATS)
+		// The counts of each thread are only written by that thread, using plain (relaxed)
+		// loads and stores rather than read-modify-writes, and read by the snapshots above.
+		enum class Counter : uint8_t { Queries, OutOfBounds, ExactHits, Searches, SearchSteps };
+		static const size_t kCounterCount = 5;
+
+		struct alignas(64) ThreadBlock
+		{
+			std::atomic<uint64_t> counters[kCounterCount];
+			std::atomic<uint64_t> latency[LookupStats::kLatencyBuckets];
+			uint32_t countdown; // lookups until the next latency sample (own thread only)
+		};
+
+		/* This registers the calling thread on its first lookup, returning its block.
+		*/
+		ThreadBlock* RegisterThread();
+
+		// The calling thread's block (null until registered)
+		inline thread_local ThreadBlock* tBlock = nullptr;
+
+		inline ThreadBlock& Block()
+		{
+			ThreadBlock* block = tBlock;
+			return block ? *block : *RegisterThread();
+		}
+
+		inline void Add(const Counter aCounter,
+			const uint64_t aAmount)
+		{
+			std::atomic<uint64_t>& count = Block().counters[static_cast<size_t>(aCounter)];
+			count.store(count.load(std::memory_order_relaxed) + aAmount, std::memory_order_relaxed);
+		}
+
+		/* This adds a latency sample of aNanoseconds to the calling thread's histogram.
+		*/
+		void AddLatency(ThreadBlock& ioBlock,
+			const uint64_t aNanoseconds);
+
+		// Counts a single lookup for as long as it is in scope, timing one in every
+		// kLatencySampleInterval of them.  The rest of its counts are added through the
+		// timer so that the thread's block is only looked up once per lookup.
+		class QueryTimer
+		{
+			ThreadBlock& _block;
+			bool _sampled;
+			std::chrono::steady_clock::time_point _start;
+
+			void Add(const Counter aCounter,
+				const uint64_t aAmount)
+			{
+				std::atomic<uint64_t>& count = _block.counters[static_cast<size_t>(aCounter)];
+				count.store(count.load(std::memory_order_relaxed) + aAmount, std::memory_order_relaxed);
+			}
+
+		public:
+			QueryTimer()
+				: _block{ Block() }
+				, _sampled{ --_block.countdown == 0 }
+				, _start{}
+			{
+				Add(Counter::Queries, 1);
+				if (_sampled) {
+					_block.countdown = kLatencySampleInterval;
+					_start = std::chrono::steady_clock::now();
+				}
+			}
+			~QueryTimer()
+			{
+				if (_sampled) {
+					const auto elapsed = std::chrono::steady_clock::now() - _start;
+					AddLatency(_block, static_cast<uint64_t>(
+						std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+				}
+			}
+			QueryTimer(const QueryTimer&) = delete;
+			QueryTimer& operator=(const QueryTimer&) = delete;
+
+			void OutOfBounds() { Add(Counter::OutOfBounds, 1); }
+			void Searched(const uint64_t aSearches,
+				const uint64_t aSteps)
+			{
+				Add(Counter::Searches, aSearches);
+				Add(Counter::SearchSteps, aSteps);
+			}
+		};
+#endif
+	}
+}
+
+#endif // _ZJLD_LOOKUP_STATS_H_
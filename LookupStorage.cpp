@@ -0,0 +1,181 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+// This file is part of LookupTable <https://github.com/zjldemers/LookupTable>.
+// 
+// MIT License
+// Copyright (c) 2022 Zachary J. L. Demers
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "LookupStorage.h"
+#include <cstring>
+
+using namespace zjld; // feel free to remove/rename as the license above allows
+
+
+BFloat16 BFloat16::FromDouble(const double& aValue)
+{
+	const float value = static_cast<float>(aValue);
+	uint32_t bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	BFloat16 result;
+	if ((bits & 0x7fffffffu) > 0x7f800000u) {
+		result.bits = static_cast<uint16_t>((bits >> 16) | 0x0040u); // keep NaN a (quiet) NaN
+		return result;
+	}
+	bits += 0x7fffu + ((bits >> 16) & 1); // round to nearest, ties to even
+	result.bits = static_cast<uint16_t>(bits >> 16);
+	return result;
+}
+
+double BFloat16::ToDouble() const
+{
+	const uint32_t upper = static_cast<uint32_t>(bits) << 16;
+	float value;
+	std::memcpy(&value, &upper, sizeof(value));
+	return static_cast<double>(value);
+}
+
+
+
+
+LookupStorage::LookupStorage()
+	: _type{ StorageType::Double }
+	, _doubles{}
+	, _floats{}
+	, _bfloats{}
+	, _view{ nullptr }
+	, _viewSize{ 0 }
+	, _viewOwner{}
+{}
+
+LookupStorage::LookupStorage(const std::vector<double>& aValues,
+	const StorageType& aType)
+	: LookupStorage(aValues.data(), aValues.size(), aType)
+{}
+
+LookupStorage::LookupStorage(std::vector<double>&& aValues,
+	const StorageType& aType)
+	: LookupStorage()
+{
+	if (aType == StorageType::Float || aType == StorageType::BFloat16) {
+		*this = LookupStorage(aValues.data(), aValues.size(), aType);
+	}
+	else {
+		_doubles = std::move(aValues);
+	}
+}
+
+LookupStorage::LookupStorage(const double* aValues,
+	const size_t& aSize,
+	const StorageType& aType)
+	: _type{ aType }
+	, _doubles{}
+	, _floats{}
+	, _bfloats{}
+	, _view{ nullptr }
+	, _viewSize{ 0 }
+	, _viewOwner{}
+{
+	switch (_type) {
+	case StorageType::Float:
+		_floats = std::vector<float>(aSize);
+		for (size_t i = 0; i < aSize; i++) {
+			_floats[i] = static_cast<float>(aValues[i]);
+		}
+		break;
+	case StorageType::BFloat16:
+		_bfloats = std::vector<BFloat16>(aSize + 1, BFloat16{ 0 });
+		for (size_t i = 0; i < aSize; i++) {
+			_bfloats[i] = BFloat16::FromDouble(aValues[i]);
+		}
+		break;
+	default:
+		_type = StorageType::Double;
+		_doubles = std::vector<double>(aValues, aValues + aSize);
+		break;
+	}
+}
+
+
+LookupStorage::LookupStorage(const void* aData,
+	const size_t& aSize,
+	const StorageType& aType,
+	const std::shared_ptr<const void>& aOwner)
+	: _type{ aType }
+	, _doubles{}
+	, _floats{}
+	, _bfloats{}
+	, _view{ aData }
+	, _viewSize{ aSize }
+	, _viewOwner{ aOwner }
+{}
+
+
+size_t LookupStorage::ValueBytes(const StorageType& aType)
+{
+	switch (aType) {
+	case StorageType::Float:
+		return sizeof(float);
+	case StorageType::BFloat16:
+		return sizeof(BFloat16);
+	default:
+		return sizeof(double);
+	}
+}
+
+StorageType LookupStorage::Type() const
+{
+	return _type;
+}
+size_t LookupStorage::Size() const
+{
+	if (_view)
+		return _viewSize;
+	switch (_type) {
+	case StorageType::Float:
+		return _floats.size();
+	case StorageType::BFloat16:
+		return _bfloats.empty() ? 0 : _bfloats.size() - 1;
+	default:
+		return _doubles.size();
+	}
+}
+size_t LookupStorage::ByteSize() const
+{
+	return Size() * ValueBytes(_type);
+}
+bool LookupStorage::Empty() const
+{
+	return Size() == 0;
+}
+bool LookupStorage::IsView() const
+{
+	return nullptr != _view;
+}
+
+double LookupStorage::At(const size_t& aIndex) const
+{
+	return Visit([&](const auto* aData) { return ToDouble(aData[aIndex]); });
+}
+
+const void* LookupStorage::Data() const
+{
+	return Visit([](const auto* aData) { return static_cast<const void*>(aData); });
+}
@@ -0,0 +1,178 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+// This file is part of LookupTable <https://github.com/zjldemers/LookupTable>.
+// 
+// MIT License
+// Copyright (c) 2022 Zachary J. L. Demers
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef _ZJLD_LOOKUP_STORAGE_H_
+#define _ZJLD_LOOKUP_STORAGE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace zjld // feel free to remove/rename as the license above allows
+{
+
+	// The types that dependent data may be stored as (see LookupStorage).  Lookups always
+	// interpolate in double, so these only trade precision for memory and bandwidth:
+	// - Double: 8 bytes per value, exactly as given
+	// - Float: 4 bytes per value, about 7 significant digits
+	// - BFloat16: 2 bytes per value, about 2-3 significant digits (the upper half of a float,
+	//   so the same range as Float with less precision)
+	enum class StorageType { Double, Float, BFloat16 };
+
+
+	// 16-bit brain floating point value, stored as the upper 16 bits of a float
+	struct BFloat16
+	{
+		uint16_t bits;
+
+		/* These convert to and from double (through float), rounding to the nearest value
+		* (ties to even).  Values outside the range of float become infinite.
+		*/
+		static BFloat16 FromDouble(const double& aValue);
+		double ToDouble() const;
+	};
+
+
+	// This class holds the dependent data of a table as one of the StorageType types, either
+	// in its own memory or as a view of memory owned elsewhere (e.g. a memory mapped file).
+	// Values are read back as double, either one at a time with At, or with Visit, which
+	// calls a function with a typed pointer to the data so that hot loops only check the
+	// type once.  For example:
+	//   storage.Visit([&](const auto* aData) { ... LookupStorage::ToDouble(aData[i]) ... });
+	class LookupStorage
+	{
+		StorageType _type;
+		std::vector<double>   _doubles;  // values if Double
+		std::vector<float>    _floats;   // values if Float
+		std::vector<BFloat16> _bfloats;  // values if BFloat16 (plus one unused, see below)
+		const void* _view;               // values if viewing other memory (else null)
+		size_t _viewSize;                // number of values at _view
+		std::shared_ptr<const void> _viewOwner; // keeps the memory at _view alive
+
+	public:
+		LookupStorage();
+		LookupStorage(const std::vector<double>& aValues,
+			const StorageType& aType);
+
+		/* These are the same as the above, but the first takes over aValues' memory when
+		* aType is Double (converting otherwise), and the second copies aSize values.
+		*/
+		LookupStorage(std::vector<double>&& aValues,
+			const StorageType& aType);
+		LookupStorage(const double* aValues,
+			const size_t& aSize,
+			const StorageType& aType);
+
+		/* This views aSize values of type aType at aData without copying them, keeping
+		* aOwner (which may be null) alive for as long as any copy of this storage exists.
+		* BFloat16 values must be followed by at least one more readable value (see Data).
+		*/
+		LookupStorage(const void* aData,
+			const size_t& aSize,
+			const StorageType& aType,
+			const std::shared_ptr<const void>& aOwner);
+
+		/* This returns the number of bytes per value of the given type.
+		*/
+		static size_t ValueBytes(const StorageType& aType);
+
+		StorageType Type() const;
+		size_t Size() const;      // number of values
+		size_t ByteSize() const;  // memory used by the values (Size() * ValueBytes)
+		bool Empty() const;
+		bool IsView() const;      // true if viewing memory owned elsewhere
+
+		/* This returns the value at aIndex converted to double (no bounds checking).
+		*/
+		double At(const size_t& aIndex) const;
+
+		/* This returns a pointer to the first value, for use along with Type().  BFloat16
+		* data is followed by one unused value so that it can be safely read two values
+		* (32 bits) at a time.
+		*/
+		const void* Data() const;
+
+		/* This calls aFunc with a pointer to the values as their stored type (const double*,
+		* const float* or const BFloat16*) and returns its result.
+		*/
+		template<typename TFunc>
+		decltype(auto) Visit(TFunc&& aFunc) const
+		{
+			switch (_type) {
+			case StorageType::Float:
+				return aFunc(_view ? static_cast<const float*>(_view) : _floats.data());
+			case StorageType::BFloat16:
+				return aFunc(_view ? static_cast<const BFloat16*>(_view) : _bfloats.data());
+			default:
+				return aFunc(_view ? static_cast<const double*>(_view) : _doubles.data());
+			}
+		}
+
+		/* These convert any stored value to double.
+		*/
+		static double ToDouble(const double& aValue) { return aValue; }
+		static double ToDouble(const float& aValue) { return static_cast<double>(aValue); }
+		static double ToDouble(const BFloat16& aValue) { return aValue.ToDouble(); }
+	};
+
+
+	// This is the interface of dependent data that is not held in a LookupStorage but read
+	// through calls instead (see PageCache and LazyTiles), at the same positions as the
+	// table's storage layout would put them in a LookupStorage.  Every method may be called
+	// by any number of threads at once.
+	class DepDataReader
+	{
+	public:
+		virtual ~DepDataReader() {}
+
+		/* These return the values at the given positions (which are not bounds checked).
+		* The first returns true if the data around those positions is worth prefetching
+		* (see Prefetch), i.e. if reading them had to wait for data not held in memory.
+		*/
+		virtual bool Read(const size_t* aPositions,
+			const size_t& aCount,
+			double* outValues) = 0;
+		double At(const size_t& aPosition)
+		{
+			double value;
+			Read(&aPosition, 1, &value);
+			return value;
+		}
+
+		/* These ask for the data holding the given positions to be brought into memory in
+		* the background, where supported (Prefetching is then true).
+		*/
+		virtual void Prefetch(const size_t* /*aPositions*/,
+			const size_t& /*aCount*/) {}
+		virtual bool Prefetching() const { return false; }
+
+		/* This returns the memory the data currently uses.
+		*/
+		virtual size_t MemoryBytes() const = 0;
+	};
+}
+
+#endif // _ZJLD_LOOKUP_STORAGE_H_
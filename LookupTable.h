@@ -27,8 +27,13 @@
 #define _ZJLD_LOOKUP_TABLE_H_
 
 #include "LookupTableND.h"
+#include "LookupTableFixed.h"
 #include "LookupTable2D.h"
 #include "LookupTable3D.h"
+#include "LookupTableHandle.h"
+#include "LookupTableMulti.h"
+#include "LookupTableStatic.h"
+#include "LookupTableVariant.h"
 
 #endif // !_ZJLD_LOOKUP_TABLE_H_
 
@@ -0,0 +1,653 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+// This file is part of LookupTable <https://github.com/zjldemers/LookupTable>.
+// 
+// MIT License
+// Copyright (c) 2022 Zachary J. L. Demers
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef _ZJLD_LOOKUP_TABLE_FIXED_H_
+#define _ZJLD_LOOKUP_TABLE_FIXED_H_
+
+#include <array>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include "LookupTableND.h"
+
+namespace zjld // feel free to remove/rename as the license above allows
+{
+	// This class template is a specific implementation of the LookupTableND class with the
+	// number of dimensions fixed at compile time (N independent data vectors along with one
+	// corresponding/resultant dependent data vector).
+	// Knowing N at compile time allows the position search for each dimension and the 2^N
+	// corner interpolation to be fully unrolled, without the loops, vectors, and repeated
+	// bounds checks used by the ND variation.  Results are identical to LookupTableND.
+	// LookupTable2D and LookupTable3D are aliases of this template, but any N >= 2 may be
+	// used directly (e.g. LookupTable<4> for a 4-dimensional table).
+	// Since this is just a subset implementation of the broader ND table, most methods use
+	// the base class' implementation while the few below provide restricted options for the
+	// N-dimensional case.  With that in mind, view that class for more documentation.
+	template<size_t N, typename TIndices = std::make_index_sequence<N>>
+	class LookupTable;
+
+	template<size_t N, size_t... Is>
+	class LookupTable<N, std::index_sequence<Is...>> : public LookupTableND {
+		static_assert(N >= 2, "1-dimensional tables are not implemented.");
+		static_assert(N <= LookupTableND::kMaxFastDimensions, "Too many dimensions.");
+		static_assert(N <= LookupHint::kMaxDimensions, "Too many dimensions.");
+
+		template<size_t I> using Index = typename detail::Repeat<I, const size_t&>::type;
+		template<size_t I> using Value = typename detail::Repeat<I, const double&>::type;
+
+	public:
+		typedef std::array<size_t, N> IndexInputs;
+		typedef std::array<double, N> ValueInputs;
+
+		/* These mirror the LookupTableND constructors, but populate the data from here so
+		* that the N-dimensional IsValidSourceData check below is the one that is used.
+		*/
+		LookupTable();
+		LookupTable(const TableDataSet& aFullDataSet);
+		LookupTable(const TableDataSet& aIndepDataSet,
+			const TableData& aDepData);
+		LookupTable(TableDataSet&& aFullDataSet);
+		LookupTable(TableDataSet&& aIndepDataSet,
+			TableData&& aDepData);
+		LookupTable(const TableDataSet& aFullDataSet,
+			const TableOptions& aOptions);
+		LookupTable(TableDataSet&& aFullDataSet,
+			const TableOptions& aOptions);
+
+		bool IsValidSourceData(const TableDataSet& aFullDataSet) const override;
+		bool IsValidDimensionCount(const size_t& aDimensions) const override;
+
+		size_t LookupIndexAt(Index<Is>... aIndices) const;
+		bool QueryIndexAt(Index<Is>... aIndices,
+			size_t* outIndex,
+			std::string* outErrMsg) const;
+		utils::Result<size_t> QueryIndexAt(Index<Is>... aIndices) const;
+
+		double LookupByIndices(Index<Is>... aIndices) const;
+		bool QueryByIndices(Index<Is>... aIndices,
+			double* outValue,
+			std::string* outErrMsg) const;
+		utils::Result<double> QueryByIndices(Index<Is>... aIndices) const;
+
+		/* The std::array overload is a template only so that a braced list of values,
+		* e.g. LookupByValues({v0, v1}), still resolves to the (non-template) vector
+		* overload rather than being ambiguous between the two.
+		*/
+		double LookupByValues(Value<Is>... aValues) const;
+		template<typename TInputs = ValueInputs>
+		double LookupByValues(const std::array<double, N>& aValueInputs) const;
+		double LookupByValues(const std::vector<double>& aValueInputs) const override;
+		bool QueryByValues(Value<Is>... aValues,
+			double* outValue,
+			std::string* outErrMsg) const;
+		bool QueryByValues(const std::vector<double>& aValueInputs,
+			double* outValue,
+			std::string* outErrMsg) const override;
+		utils::Result<double> QueryByValues(Value<Is>... aValues) const;
+		utils::Result<double> QueryByValues(const std::vector<double>& aValueInputs) const override;
+
+		/* Hinted variations (see LookupTableND and LookupHint).
+		*/
+		double LookupByValues(Value<Is>... aValues,
+			LookupHint* ioHint) const;
+		bool QueryByValues(Value<Is>... aValues,
+			LookupHint* ioHint,
+			double* outValue,
+			std::string* outErrMsg) const;
+		utils::Result<double> QueryByValues(Value<Is>... aValues,
+			LookupHint* ioHint) const;
+
+		/* Unpacked variations of the gradient methods (see LookupTableND), where
+		* outGradient must hold N values.
+		*/
+		double LookupValueAndGradient(Value<Is>... aValues,
+			double* outGradient) const;
+		bool QueryValueAndGradient(Value<Is>... aValues,
+			double* outValue,
+			double* outGradient,
+			std::string* outErrMsg) const;
+		utils::Result<double> QueryValueAndGradient(Value<Is>... aValues,
+			double* outGradient) const;
+
+		// These are not available after defining methods with same name above, so re-include
+		using LookupTableND::IsValidSourceData; // allow separate indep/dep inputs
+		using LookupTableND::LookupIndexAt;     // allow vector inputs
+		using LookupTableND::QueryIndexAt;      // allow vector inputs
+		using LookupTableND::LookupByIndices;   // allow vector inputs
+		using LookupTableND::QueryByIndices;    // allow vector inputs
+		using LookupTableND::LookupByValues;    // allow vector inputs
+		using LookupTableND::QueryByValues;     // allow vector inputs
+		using LookupTableND::LookupValueAndGradient; // allow vector inputs
+		using LookupTableND::QueryValueAndGradient;  // allow vector inputs
+
+	protected:
+		/* Unrolled equivalents of LookupTableND::FindByIndices and FindByValues, the
+		* non-throwing cores of the lookup methods above.
+		*/
+		utils::ErrorCode FindByIndicesFixed(Index<Is>... aIndices,
+			double* outValue,
+			size_t* outDimension) const;
+		utils::ErrorCode FindByValuesFixed(Value<Is>... aValues,
+			size_t* ioSegments,
+			double* outValue) const;
+
+		/* Unrolled equivalent of LookupTableND::EvaluateBatch (see that for more details).
+		*/
+		size_t EvaluateBatch(const double* const* aDimValues,
+			const size_t& aBegin,
+			const size_t& aEnd,
+			double* outValues,
+			uint64_t* outValidMask) const override;
+
+		/* Returns the offset in _depData from the lowest corner of a cell to the corner
+		* identified by aCorner, using the same corner numbering as InterpolateCell (the
+		* last dimension is the least significant bit), given the step along each
+		* dimension from the lowest corner (see LocateCell).
+		*/
+		static size_t CornerOffset(const size_t aCorner,
+			const size_t* aSteps);
+
+		/* Unrolled equivalent of InterpolateCell, where Cs enumerates all 2^N corners
+		* (also reading from _cellData when it has been built).
+		*/
+		template<size_t... Cs>
+		double InterpolateFixed(const size_t* aLowIdxs,
+			const double* aPercProgresses,
+			std::index_sequence<Cs...>) const;
+
+		/* Interpolates pairs of aVals down one dimension at a time until aVals[0] holds
+		* the final value, where kDims is the number of dimensions left to interpolate
+		* (i.e. aVals holds 2^kDims values).
+		*/
+		template<size_t kDims>
+		static void Reduce(double* aVals,
+			const double* aPercProgresses);
+	};
+
+
+
+
+	// ==== Begin Section: Construction (Public) ==== //
+	template<size_t N, size_t... Is>
+	LookupTable<N, std::index_sequence<Is...>>::LookupTable()
+		: LookupTableND()
+	{}
+
+	template<size_t N, size_t... Is>
+	LookupTable<N, std::index_sequence<Is...>>::LookupTable(const TableDataSet& aFullDataSet)
+		: LookupTableND()
+	{
+		PopulateData(aFullDataSet);
+	}
+
+	template<size_t N, size_t... Is>
+	LookupTable<N, std::index_sequence<Is...>>::LookupTable(const TableDataSet& aIndepDataSet,
+		const TableData& aDepData)
+		: LookupTableND()
+	{
+		PopulateData(aIndepDataSet, aDepData);
+	}
+
+	template<size_t N, size_t... Is>
+	LookupTable<N, std::index_sequence<Is...>>::LookupTable(TableDataSet&& aFullDataSet)
+		: LookupTableND()
+	{
+		PopulateData(std::move(aFullDataSet));
+	}
+
+	template<size_t N, size_t... Is>
+	LookupTable<N, std::index_sequence<Is...>>::LookupTable(TableDataSet&& aIndepDataSet,
+		TableData&& aDepData)
+		: LookupTableND()
+	{
+		PopulateData(std::move(aIndepDataSet), std::move(aDepData));
+	}
+
+	template<size_t N, size_t... Is>
+	LookupTable<N, std::index_sequence<Is...>>::LookupTable(const TableDataSet& aFullDataSet,
+		const TableOptions& aOptions)
+		: LookupTableND()
+	{
+		SetOptions(aOptions); // only stored, as the table is not populated yet
+		PopulateData(aFullDataSet);
+	}
+
+	template<size_t N, size_t... Is>
+	LookupTable<N, std::index_sequence<Is...>>::LookupTable(TableDataSet&& aFullDataSet,
+		const TableOptions& aOptions)
+		: LookupTableND()
+	{
+		SetOptions(aOptions);
+		PopulateData(std::move(aFullDataSet));
+	}
+
+	template<size_t N, size_t... Is>
+	bool LookupTable<N, std::index_sequence<Is...>>::IsValidSourceData(
+		const TableDataSet& aFullDataSet) const
+	{
+		if (aFullDataSet.size() != N + 1)
+			return false; // must have N indep data and 1 dep data
+		return LookupTableND::IsValidSourceData(aFullDataSet);
+	}
+
+	template<size_t N, size_t... Is>
+	bool LookupTable<N, std::index_sequence<Is...>>::IsValidDimensionCount(
+		const size_t& aDimensions) const
+	{
+		return aDimensions == N;
+	}
+	// ==== End Section: Construction (Public) ==== //
+
+
+
+
+	// ==== Begin Section: Lookup Methods (Public) ==== //
+	template<size_t N, size_t... Is>
+	size_t LookupTable<N, std::index_sequence<Is...>>::LookupIndexAt(
+		Index<Is>... aIndices) const
+	{
+		const size_t inputs[N] = { aIndices... };
+		size_t idx, dim = 0;
+		const utils::ErrorCode error = FindIndexAt(inputs, N, &idx, &dim);
+		if (error != utils::ErrorCode::None)
+			ThrowError(error, inputs, dim);
+		return idx;
+	}
+	template<size_t N, size_t... Is>
+	bool LookupTable<N, std::index_sequence<Is...>>::QueryIndexAt(Index<Is>... aIndices,
+		size_t* outIndex,
+		std::string* outErrMsg) const
+	{
+		if (nullptr == outIndex || nullptr == outErrMsg)
+			return false;
+		const size_t inputs[N] = { aIndices... };
+		size_t dim = 0;
+		const utils::ErrorCode error = FindIndexAt(inputs, N, outIndex, &dim);
+		if (error != utils::ErrorCode::None) {
+			*outErrMsg = ErrorMessage(error, inputs, dim);
+			return false;
+		}
+		return true;
+	}
+	template<size_t N, size_t... Is>
+	utils::Result<size_t> LookupTable<N, std::index_sequence<Is...>>::QueryIndexAt(
+		Index<Is>... aIndices) const
+	{
+		const size_t inputs[N] = { aIndices... };
+		size_t idx;
+		const utils::ErrorCode error = FindIndexAt(inputs, N, &idx, nullptr);
+		return (error == utils::ErrorCode::None)
+			? utils::Result<size_t>(idx) : utils::Result<size_t>(error);
+	}
+
+
+	template<size_t N, size_t... Is>
+	double LookupTable<N, std::index_sequence<Is...>>::LookupByIndices(
+		Index<Is>... aIndices) const
+	{
+		double value;
+		size_t dim = 0;
+		const utils::ErrorCode error = FindByIndicesFixed(aIndices..., &value, &dim);
+		if (error != utils::ErrorCode::None) {
+			const size_t inputs[N] = { aIndices... };
+			ThrowError(error, inputs, dim);
+		}
+		return value;
+	}
+	template<size_t N, size_t... Is>
+	bool LookupTable<N, std::index_sequence<Is...>>::QueryByIndices(Index<Is>... aIndices,
+		double* outValue,
+		std::string* outErrMsg) const
+	{
+		if (nullptr == outValue || nullptr == outErrMsg)
+			return false;
+		size_t dim = 0;
+		const utils::ErrorCode error = FindByIndicesFixed(aIndices..., outValue, &dim);
+		if (error != utils::ErrorCode::None) {
+			const size_t inputs[N] = { aIndices... };
+			*outErrMsg = ErrorMessage(error, inputs, dim);
+			return false;
+		}
+		return true;
+	}
+	template<size_t N, size_t... Is>
+	utils::Result<double> LookupTable<N, std::index_sequence<Is...>>::QueryByIndices(
+		Index<Is>... aIndices) const
+	{
+		double value;
+		const utils::ErrorCode error = FindByIndicesFixed(aIndices..., &value, nullptr);
+		return (error == utils::ErrorCode::None)
+			? utils::Result<double>(value) : utils::Result<double>(error);
+	}
+
+
+	template<size_t N, size_t... Is>
+	double LookupTable<N, std::index_sequence<Is...>>::LookupByValues(
+		Value<Is>... aValues) const
+	{
+		double value;
+		const utils::ErrorCode error = FindByValuesFixed(aValues..., nullptr, &value);
+		if (error != utils::ErrorCode::None)
+			ThrowError(error, nullptr, 0);
+		return value;
+	}
+	template<size_t N, size_t... Is>
+	template<typename TInputs>
+	double LookupTable<N, std::index_sequence<Is...>>::LookupByValues(
+		const std::array<double, N>& aValueInputs) const
+	{
+		return LookupByValues(aValueInputs[Is]...);
+	}
+	template<size_t N, size_t... Is>
+	double LookupTable<N, std::index_sequence<Is...>>::LookupByValues(
+		const std::vector<double>& aValueInputs) const
+	{
+		if (aValueInputs.size() != N)
+			ThrowError(utils::ErrorCode::WrongInputCount, nullptr, 0);
+		return LookupByValues(aValueInputs[Is]...);
+	}
+	template<size_t N, size_t... Is>
+	bool LookupTable<N, std::index_sequence<Is...>>::QueryByValues(Value<Is>... aValues,
+		double* outValue,
+		std::string* outErrMsg) const
+	{
+		if (nullptr == outValue || nullptr == outErrMsg)
+			return false;
+		const utils::ErrorCode error = FindByValuesFixed(aValues..., nullptr, outValue);
+		if (error != utils::ErrorCode::None) {
+			*outErrMsg = utils::ErrorCodeMessage(error);
+			return false;
+		}
+		return true;
+	}
+	template<size_t N, size_t... Is>
+	bool LookupTable<N, std::index_sequence<Is...>>::QueryByValues(
+		const std::vector<double>& aValueInputs,
+		double* outValue,
+		std::string* outErrMsg) const
+	{
+		if (nullptr == outValue || nullptr == outErrMsg)
+			return false;
+		if (aValueInputs.size() != N) {
+			*outErrMsg = utils::ErrorCodeMessage(utils::ErrorCode::WrongInputCount);
+			return false;
+		}
+		return QueryByValues(aValueInputs[Is]..., outValue, outErrMsg);
+	}
+	template<size_t N, size_t... Is>
+	utils::Result<double> LookupTable<N, std::index_sequence<Is...>>::QueryByValues(
+		Value<Is>... aValues) const
+	{
+		double value;
+		const utils::ErrorCode error = FindByValuesFixed(aValues..., nullptr, &value);
+		return (error == utils::ErrorCode::None)
+			? utils::Result<double>(value) : utils::Result<double>(error);
+	}
+	template<size_t N, size_t... Is>
+	utils::Result<double> LookupTable<N, std::index_sequence<Is...>>::QueryByValues(
+		const std::vector<double>& aValueInputs) const
+	{
+		if (aValueInputs.size() != N)
+			return utils::Result<double>(utils::ErrorCode::WrongInputCount);
+		return QueryByValues(aValueInputs[Is]...);
+	}
+
+
+	template<size_t N, size_t... Is>
+	double LookupTable<N, std::index_sequence<Is...>>::LookupByValues(Value<Is>... aValues,
+		LookupHint* ioHint) const
+	{
+		double value;
+		const utils::ErrorCode error = (_valid && nullptr == ioHint) ? utils::ErrorCode::NullPointer
+			: FindByValuesFixed(aValues..., (ioHint ? ioHint->segments : nullptr), &value);
+		if (error != utils::ErrorCode::None)
+			ThrowError(error, nullptr, 0);
+		return value;
+	}
+	template<size_t N, size_t... Is>
+	bool LookupTable<N, std::index_sequence<Is...>>::QueryByValues(Value<Is>... aValues,
+		LookupHint* ioHint,
+		double* outValue,
+		std::string* outErrMsg) const
+	{
+		if (nullptr == outValue || nullptr == outErrMsg)
+			return false;
+		const utils::ErrorCode error = (_valid && nullptr == ioHint) ? utils::ErrorCode::NullPointer
+			: FindByValuesFixed(aValues..., (ioHint ? ioHint->segments : nullptr), outValue);
+		if (error != utils::ErrorCode::None) {
+			*outErrMsg = utils::ErrorCodeMessage(error);
+			return false;
+		}
+		return true;
+	}
+	template<size_t N, size_t... Is>
+	utils::Result<double> LookupTable<N, std::index_sequence<Is...>>::QueryByValues(
+		Value<Is>... aValues,
+		LookupHint* ioHint) const
+	{
+		double value;
+		const utils::ErrorCode error = (_valid && nullptr == ioHint) ? utils::ErrorCode::NullPointer
+			: FindByValuesFixed(aValues..., (ioHint ? ioHint->segments : nullptr), &value);
+		return (error == utils::ErrorCode::None)
+			? utils::Result<double>(value) : utils::Result<double>(error);
+	}
+	// ==== End Section: Lookup Methods (Public) ==== //
+
+
+
+
+	// ==== Begin Section: Gradient Methods (Public) ==== //
+	template<size_t N, size_t... Is>
+	double LookupTable<N, std::index_sequence<Is...>>::LookupValueAndGradient(
+		Value<Is>... aValues,
+		double* outGradient) const
+	{
+		const double inputs[N] = { aValues... };
+		double value;
+		const utils::ErrorCode error = FindValueAndGradient(inputs, N, &value, outGradient);
+		if (error != utils::ErrorCode::None)
+			ThrowError(error, nullptr, 0);
+		return value;
+	}
+	template<size_t N, size_t... Is>
+	bool LookupTable<N, std::index_sequence<Is...>>::QueryValueAndGradient(
+		Value<Is>... aValues,
+		double* outValue,
+		double* outGradient,
+		std::string* outErrMsg) const
+	{
+		if (nullptr == outValue || nullptr == outErrMsg)
+			return false;
+		const double inputs[N] = { aValues... };
+		const utils::ErrorCode error = FindValueAndGradient(inputs, N, outValue, outGradient);
+		if (error != utils::ErrorCode::None) {
+			*outErrMsg = utils::ErrorCodeMessage(error);
+			return false;
+		}
+		return true;
+	}
+	template<size_t N, size_t... Is>
+	utils::Result<double> LookupTable<N, std::index_sequence<Is...>>::QueryValueAndGradient(
+		Value<Is>... aValues,
+		double* outGradient) const
+	{
+		const double inputs[N] = { aValues... };
+		double value;
+		const utils::ErrorCode error = FindValueAndGradient(inputs, N, &value, outGradient);
+		return (error == utils::ErrorCode::None)
+			? utils::Result<double>(value) : utils::Result<double>(error);
+	}
+	// ==== End Section: Gradient Methods (Public) ==== //
+
+
+
+
+	// ==== Begin Section: Lookup Helpers (Protected) ==== //
+	template<size_t N, size_t... Is>
+	utils::ErrorCode LookupTable<N, std::index_sequence<Is...>>::FindByIndicesFixed(
+		Index<Is>... aIndices,
+		double* outValue,
+		size_t* outDimension) const
+	{
+		ZJLD_LOOKUP_STATS_ONLY(stats::QueryTimer timer);
+		const size_t inputs[N] = { aIndices... };
+		size_t idx;
+		const utils::ErrorCode error = FindIndexAt(inputs, N, &idx, outDimension);
+		if (error == utils::ErrorCode::None) {
+			*outValue = StoredValue(_dimOffsets.empty() ? idx
+				: ((_dimOffsets[Is][aIndices]) + ...));
+		}
+		ZJLD_LOOKUP_STATS_ONLY(if (error == utils::ErrorCode::IndexOutOfBounds) timer.OutOfBounds());
+		return error;
+	}
+
+	template<size_t N, size_t... Is>
+	utils::ErrorCode LookupTable<N, std::index_sequence<Is...>>::FindByValuesFixed(
+		Value<Is>... aValues,
+		size_t* ioSegments,
+		double* outValue) const
+	{
+		ZJLD_LOOKUP_STATS_ONLY(stats::QueryTimer timer);
+		if (!_valid)
+			return utils::ErrorCode::InvalidTable;
+		ZJLD_LOOKUP_TRACE_ONLY(if (_trace) {
+			const double values[N] = { aValues... };
+			_trace->Record(values);
+		})
+
+		// Retrieve the low index and percent progress data corresponding to the query and
+		// store for later use during interpolation (one call per dimension, unrolled).
+		size_t lowIdxs[N];
+		double prcPrgs[N];
+		const bool found = ioSegments
+			? (FindPositionInfo(Is, aValues, &ioSegments[Is], &lowIdxs[Is], &prcPrgs[Is]) && ...)
+			: (FindPositionInfo(Is, aValues, &lowIdxs[Is], &prcPrgs[Is]) && ...);
+		if (!found) {
+			ZJLD_LOOKUP_STATS_ONLY(timer.OutOfBounds());
+			return utils::ErrorCode::ValueOutOfBounds;
+		}
+		ZJLD_LOOKUP_STATS_ONLY(timer.Searched(N, ioSegments ? 0 : _searchDepth));
+		*outValue = InterpolateFixed(lowIdxs, prcPrgs,
+			std::make_index_sequence<static_cast<size_t>(1) << N>());
+		return utils::ErrorCode::None;
+	}
+	// ==== End Section: Lookup Helpers (Protected) ==== //
+
+
+
+
+	// ==== Begin Section: Interpolation Helpers (Protected) ==== //
+	template<size_t N, size_t... Is>
+	size_t LookupTable<N, std::index_sequence<Is...>>::EvaluateBatch(
+		const double* const* aDimValues,
+		const size_t& aBegin,
+		const size_t& aEnd,
+		double* outValues,
+		uint64_t* outValidMask) const
+	{
+		size_t next;
+		size_t validCount = EvaluateBatchSimd(aDimValues, aBegin, aEnd, outValues,
+			outValidMask, &next);
+
+		size_t lowIdxs[N];
+		double prcPrgs[N];
+		for (size_t i = next; i < aEnd; i++) {
+			if ((FindPositionInfo(Is, aDimValues[Is][i], &lowIdxs[Is], &prcPrgs[Is]) && ...)) {
+				outValues[i] = InterpolateFixed(lowIdxs, prcPrgs,
+					std::make_index_sequence<static_cast<size_t>(1) << N>());
+				outValidMask[i / 64] |= static_cast<uint64_t>(1) << (i % 64);
+				validCount++;
+			}
+			else {
+				outValues[i] = std::numeric_limits<double>::quiet_NaN();
+			}
+		}
+		return validCount;
+	}
+
+	template<size_t N, size_t... Is>
+	size_t LookupTable<N, std::index_sequence<Is...>>::CornerOffset(const size_t aCorner,
+		const size_t* aSteps)
+	{
+		// Dimension i is represented by bit (N - i - 1) of the corner number
+		return ((((aCorner >> (N - Is - 1)) & 1) * aSteps[Is]) + ...);
+	}
+
+	template<size_t N, size_t... Is>
+	template<size_t... Cs>
+	double LookupTable<N, std::index_sequence<Is...>>::InterpolateFixed(
+		const size_t* aLowIdxs,
+		const double* aPercProgresses,
+		std::index_sequence<Cs...>) const
+	{
+		// Fetch all surrounding values to interpolate between (packed together if cells are
+		// precomputed, or found through the offset tables if tiled, and converted from their
+		// storage type), then interpolate between them in the same order as LookupTableND
+		// (last dimension first)
+		if (!_cellData.empty()) {
+			const double* cell = _cellData.data()
+				+ (((aLowIdxs[Is] * _cellStrides[Is]) + ...) << N);
+			double vals[sizeof...(Cs)] = { cell[Cs]... };
+			Reduce<N>(vals, aPercProgresses);
+			return vals[0];
+		}
+		// (InterpolateCell reads through the index or pages, and interpolates cubic kernels)
+		if (!_tiles.empty() || _reader || !_derivData.empty())
+			return InterpolateCell(aLowIdxs, aPercProgresses);
+		size_t base, tiledSteps[N];
+		const size_t* steps = _strides.data();
+		if (_dimOffsets.empty()) {
+			base = ((aLowIdxs[Is] * _strides[Is]) + ...);
+		}
+		else {
+			base = ((_dimOffsets[Is][aLowIdxs[Is]]) + ...);
+			((tiledSteps[Is] = _dimOffsets[Is][aLowIdxs[Is] + 1] - _dimOffsets[Is][aLowIdxs[Is]]), ...);
+			steps = tiledSteps;
+		}
+		return _depData.Visit([&](const auto* aDepData) {
+			double vals[sizeof...(Cs)] = {
+				LookupStorage::ToDouble(aDepData[base + CornerOffset(Cs, steps)])... };
+			Reduce<N>(vals, aPercProgresses);
+			return vals[0];
+		});
+	}
+
+	template<size_t N, size_t... Is>
+	template<size_t kDims>
+	void LookupTable<N, std::index_sequence<Is...>>::Reduce(double* aVals,
+		const double* aPercProgresses)
+	{
+		if constexpr (kDims > 0) {
+			const double prc = aPercProgresses[kDims - 1];
+			for (size_t j = 1; j < (static_cast<size_t>(1) << kDims); j += 2) {
+				aVals[j / 2] = utils::Lerp(aVals[j - 1], aVals[j], prc);
+			}
+			Reduce<kDims - 1>(aVals, aPercProgresses);
+		}
+	}
+	// ==== End Section: Interpolation Helpers (Protected) ==== //
+}
+
+#endif // _ZJLD_LOOKUP_TABLE_FIXED_H_
@@ -0,0 +1,395 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+// This file is part of LookupTable <https://github.com/zjldemers/LookupTable>.
+// 
+// MIT License
+// Copyright (c) 2022 Zachary J. L. Demers
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef _ZJLD_LOOKUP_TABLE_HANDLE_H_
+#define _ZJLD_LOOKUP_TABLE_HANDLE_H_
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "LookupTableND.h"
+
+namespace zjld // feel free to remove/rename as the license above allows
+{
+
+	// Statistics on the snapshots published to a LookupTableHandle (see Stats).
+	struct SnapshotStats
+	{
+		size_t swaps;            // number of snapshots published
+		size_t pending;          // replaced snapshots still waiting for their readers
+		double lastSwapSeconds;  // time the last Publish took to swap in its snapshot
+		double maxSwapSeconds;   // longest time any Publish took to swap in its snapshot
+		double lastDrainSeconds; // time from replacing the last reclaimed snapshot to
+		                         // reclaiming it (which happens in Publish, Reclaim or
+		                         // Synchronize once its readers have finished)
+		double maxDrainSeconds;  // longest such time for any reclaimed snapshot
+
+		SnapshotStats()
+			: swaps{ 0 }
+			, pending{ 0 }
+			, lastSwapSeconds{ 0.0 }
+			, maxSwapSeconds{ 0.0 }
+			, lastDrainSeconds{ 0.0 }
+			, maxDrainSeconds{ 0.0 }
+		{}
+	};
+
+
+	// This class template shares a table between threads while allowing it to be replaced
+	// at any time, e.g. to recalibrate a live service.  Tables themselves are not safe to
+	// repopulate while other threads query them, so instead each table is an immutable
+	// snapshot: a writer builds and validates a new table on its own, then publishes it,
+	// while readers keep using whichever snapshot was current when they started.
+	// Reclamation is epoch based (a form of RCU):
+	// - Each reader thread owns a Reader, which holds a slot of its own (on its own cache
+	//   line).  Acquiring a snapshot stores the current epoch in the slot and loads the
+	//   current table; releasing it clears the slot.  Readers never wait, lock, or touch
+	//   a shared reference count.
+	// - Publishing swaps in the new table, advances the epoch and retires the old table,
+	//   which is deleted once no slot holds an epoch from before it was replaced.
+	// For example:
+	//   LookupTableHandle<LookupTable2D> handle;
+	//   // reader threads
+	//   LookupTableHandle<LookupTable2D>::Reader reader(handle);
+	//   double value = reader.Read([&](const LookupTable2D& aTable) {
+	//       return aTable.LookupByValues(x, y); });
+	//   // writer thread
+	//   std::unique_ptr<LookupTable2D> table(new LookupTable2D(dataSet));
+	//   handle.Publish(std::move(table));
+	template<typename TTable = LookupTableND>
+	class LookupTableHandle
+	{
+		struct alignas(64) ReaderSlot
+		{
+			std::atomic<uint64_t> epoch; // epoch of the snapshot in use, 0 if none
+			std::atomic<bool> claimed;   // true while owned by a Reader
+		};
+		struct RetiredTable
+		{
+			const TTable* table;
+			uint64_t epoch; // first epoch in which the table was no longer current
+			std::chrono::steady_clock::time_point time; // when it was replaced
+		};
+
+		std::atomic<const TTable*> _current; // current snapshot (never null)
+		std::atomic<uint64_t> _epoch;        // current epoch (starting at 1)
+		std::unique_ptr<ReaderSlot[]> _slots;
+		size_t _slotCount;
+		std::mutex _writerMutex;             // guards everything below
+		std::vector<RetiredTable> _retired;
+		SnapshotStats _stats;
+
+	public:
+		static const size_t kDefaultMaxReaders = 64;
+
+		class Reader;
+
+		// A snapshot in use by a Reader, which keeps the table alive until destroyed.
+		class Snapshot
+		{
+			Reader* _reader;
+			const TTable* _table;
+
+			friend class Reader;
+			Snapshot(Reader* aReader, const TTable* aTable)
+				: _reader{ aReader }, _table{ aTable } {}
+
+		public:
+			Snapshot(Snapshot&& aOther) noexcept
+				: _reader{ aOther._reader }, _table{ aOther._table } { aOther._reader = nullptr; }
+			Snapshot(const Snapshot&) = delete;
+			Snapshot& operator=(const Snapshot&) = delete;
+			Snapshot& operator=(Snapshot&&) = delete;
+			~Snapshot() { if (_reader) _reader->Release(); }
+
+			const TTable& operator*() const { return *_table; }
+			const TTable* operator->() const { return _table; }
+		};
+
+		// A reader of a handle's snapshots, which must only be used by one thread at a time
+		// and destroyed (along with its snapshots) before the handle.  Snapshots may be
+		// nested, but a Reader must not be moved while any of its snapshots exist.
+		class Reader
+		{
+			LookupTableHandle* _handle;
+			ReaderSlot* _slot;
+			size_t _depth; // number of snapshots currently in use
+
+			friend class Snapshot;
+			void Release()
+			{
+				if (--_depth == 0)
+					_slot->epoch.store(0, std::memory_order_release);
+			}
+
+		public:
+			/* This claims one of aHandle's reader slots, throwing std::runtime_error if all
+			* of them are already claimed (see the LookupTableHandle constructor).
+			*/
+			explicit Reader(LookupTableHandle& aHandle);
+			Reader(Reader&& aOther) noexcept
+				: _handle{ aOther._handle }, _slot{ aOther._slot }, _depth{ aOther._depth }
+			{
+				aOther._slot = nullptr;
+			}
+			Reader(const Reader&) = delete;
+			Reader& operator=(const Reader&) = delete;
+			Reader& operator=(Reader&&) = delete;
+			~Reader()
+			{
+				if (_slot)
+					_slot->claimed.store(false, std::memory_order_release);
+			}
+
+			/* This returns the current snapshot, which stays usable (and unchanged) for as
+			* long as the returned object exists, regardless of any later Publish.
+			*/
+			Snapshot Acquire();
+
+			/* This calls aFunc with the current snapshot (as a const TTable&) and returns
+			* its result.
+			*/
+			template<typename TFunc>
+			decltype(auto) Read(TFunc&& aFunc)
+			{
+				const Snapshot snapshot = Acquire();
+				return aFunc(*snapshot);
+			}
+		};
+
+		/* This creates a handle whose current snapshot is an empty (invalid) table, with
+		* room for up to aMaxReaders Readers at a time.
+		*/
+		explicit LookupTableHandle(const size_t& aMaxReaders = kDefaultMaxReaders);
+		LookupTableHandle(const LookupTableHandle&) = delete;
+		LookupTableHandle& operator=(const LookupTableHandle&) = delete;
+
+		/* All Readers must have been destroyed beforehand.
+		*/
+		~LookupTableHandle();
+
+		/* This makes aTable the current snapshot, returning false (and leaving the current
+		* snapshot in place) if aTable is null or invalid.  The previous snapshot is retired
+		* and deleted once its readers have finished.  Publishing never waits for readers,
+		* only for other writers.
+		*/
+		bool Publish(std::unique_ptr<const TTable> aTable);
+
+		/* This replaces the current snapshot with an empty (invalid) table, which is what
+		* ResetData on a table shared this way would otherwise do.
+		*/
+		void Reset();
+
+		/* This deletes every retired snapshot that no reader uses anymore, returning the
+		* number still waiting (Publish also does this).
+		*/
+		size_t Reclaim();
+
+		/* This waits until every snapshot retired so far has been deleted, which requires
+		* the threads using them to release them (so never call it while holding one).
+		*/
+		void Synchronize();
+
+		SnapshotStats Stats();
+		size_t MaxReaders() const;
+
+	protected:
+		/* This deletes the retired snapshots that are no longer in use.  _writerMutex must
+		* be held.
+		*/
+		void ReclaimRetired();
+	};
+
+
+
+
+	// ==== Begin Section: Reader (Public) ==== //
+	template<typename TTable>
+	LookupTableHandle<TTable>::Reader::Reader(LookupTableHandle& aHandle)
+		: _handle{ &aHandle }
+		, _slot{ nullptr }
+		, _depth{ 0 }
+	{
+		for (size_t i = 0; i < aHandle._slotCount; i++) {
+			bool claimed = false;
+			if (aHandle._slots[i].claimed.compare_exchange_strong(claimed, true,
+				std::memory_order_acquire)) {
+				_slot = &aHandle._slots[i];
+				return;
+			}
+		}
+		throw std::runtime_error("Too many readers for this table handle.");
+	}
+
+	template<typename TTable>
+	typename LookupTableHandle<TTable>::Snapshot LookupTableHandle<TTable>::Reader::Acquire()
+	{
+		// The slot is published before loading the table (both sequentially consistent),
+		// so any writer that replaces the table after this load sees the slot, while one
+		// that replaced it before has already advanced the epoch stored here.
+		if (_depth++ == 0)
+			_slot->epoch.store(_handle->_epoch.load(std::memory_order_acquire));
+		return Snapshot(this, _handle->_current.load());
+	}
+	// ==== End Section: Reader (Public) ==== //
+
+
+
+
+	// ==== Begin Section: Construction/Destruction (Public) ==== //
+	template<typename TTable>
+	LookupTableHandle<TTable>::LookupTableHandle(const size_t& aMaxReaders)
+		: _current{ new TTable() }
+		, _epoch{ 1 }
+		, _slots{ new ReaderSlot[aMaxReaders] }
+		, _slotCount{ aMaxReaders }
+		, _writerMutex{}
+		, _retired{}
+		, _stats{}
+	{
+		for (size_t i = 0; i < _slotCount; i++) {
+			_slots[i].epoch.store(0);
+			_slots[i].claimed.store(false);
+		}
+	}
+
+	template<typename TTable>
+	LookupTableHandle<TTable>::~LookupTableHandle()
+	{
+		for (const RetiredTable& retired : _retired) {
+			delete retired.table;
+		}
+		delete _current.load();
+	}
+	// ==== End Section: Construction/Destruction (Public) ==== //
+
+
+
+
+	// ==== Begin Section: Snapshots (Public) ==== //
+	template<typename TTable>
+	bool LookupTableHandle<TTable>::Publish(std::unique_ptr<const TTable> aTable)
+	{
+		if (!aTable || !aTable->Valid())
+			return false;
+		const auto start = std::chrono::steady_clock::now();
+		std::lock_guard<std::mutex> lock(_writerMutex);
+		const TTable* previous = _current.exchange(aTable.release());
+		const uint64_t epoch = _epoch.fetch_add(1) + 1;
+		const auto now = std::chrono::steady_clock::now();
+		_retired.push_back({ previous, epoch, now });
+
+		const double seconds = std::chrono::duration<double>(now - start).count();
+		_stats.swaps++;
+		_stats.lastSwapSeconds = seconds;
+		_stats.maxSwapSeconds = std::max(_stats.maxSwapSeconds, seconds);
+		ReclaimRetired();
+		return true;
+	}
+
+	template<typename TTable>
+	void LookupTableHandle<TTable>::Reset()
+	{
+		std::lock_guard<std::mutex> lock(_writerMutex);
+		const TTable* previous = _current.exchange(new TTable());
+		const uint64_t epoch = _epoch.fetch_add(1) + 1;
+		_retired.push_back({ previous, epoch, std::chrono::steady_clock::now() });
+		ReclaimRetired();
+	}
+
+	template<typename TTable>
+	size_t LookupTableHandle<TTable>::Reclaim()
+	{
+		std::lock_guard<std::mutex> lock(_writerMutex);
+		ReclaimRetired();
+		return _retired.size();
+	}
+
+	template<typename TTable>
+	void LookupTableHandle<TTable>::Synchronize()
+	{
+		while (Reclaim() != 0) {
+			std::this_thread::yield();
+		}
+	}
+
+	template<typename TTable>
+	SnapshotStats LookupTableHandle<TTable>::Stats()
+	{
+		std::lock_guard<std::mutex> lock(_writerMutex);
+		SnapshotStats stats = _stats;
+		stats.pending = _retired.size();
+		return stats;
+	}
+
+	template<typename TTable>
+	size_t LookupTableHandle<TTable>::MaxReaders() const
+	{
+		return _slotCount;
+	}
+	// ==== End Section: Snapshots (Public) ==== //
+
+
+
+
+	// ==== Begin Section: Helpers (Protected) ==== //
+	template<typename TTable>
+	void LookupTableHandle<TTable>::ReclaimRetired()
+	{
+		if (_retired.empty())
+			return;
+
+		// A table retired in epoch E may still be used by readers that started before E
+		uint64_t oldestInUse = UINT64_MAX;
+		for (size_t i = 0; i < _slotCount; i++) {
+			const uint64_t epoch = _slots[i].epoch.load();
+			if (epoch != 0 && epoch < oldestInUse)
+				oldestInUse = epoch;
+		}
+		const auto now = std::chrono::steady_clock::now();
+		size_t kept = 0;
+		for (size_t i = 0; i < _retired.size(); i++) {
+			if (_retired[i].epoch <= oldestInUse) {
+				delete _retired[i].table;
+				const double seconds = std::chrono::duration<double>(now - _retired[i].time).count();
+				_stats.lastDrainSeconds = seconds;
+				_stats.maxDrainSeconds = std::max(_stats.maxDrainSeconds, seconds);
+			}
+			else {
+				_retired[kept++] = _retired[i];
+			}
+		}
+		_retired.resize(kept);
+	}
+	// ==== End Section: Helpers (Protected) ==== //
+}
+
+#endif // _ZJLD_LOOKUP_TABLE_HANDLE_H_
@@ -0,0 +1,564 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+// This file is part of LookupTable <https://github.com/zjldemers/LookupTable>.
+// 
+// MIT License
+// Copyright (c) 2022 Zachary J. L. Demers
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "LookupTableMulti.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+using namespace zjld; // feel free to remove/rename as the license above allows
+using std::string;
+using std::vector;
+using utils::ErrorCode;
+using utils::Result;
+using utils::Scratch;
+
+
+// ==== Begin Section: Construction/Destruction (Public) ==== //
+LookupTableMulti::LookupTableMulti()
+{
+	ResetData();
+}
+
+LookupTableMulti::LookupTableMulti(const TableDataSet& aIndepDataSet,
+	const TableDataSet& aDepDataSets)
+{
+	PopulateData(aIndepDataSet, aDepDataSets);
+}
+
+LookupTableMulti::LookupTableMulti(const TableDataSet& aIndepDataSet,
+	const TableDataSet& aDepDataSets,
+	const TableOptions& aOptions)
+	: _options{ aOptions }
+{
+	PopulateData(aIndepDataSet, aDepDataSets);
+}
+// ==== End Section: Construction/Destruction (Public) ==== //
+
+
+
+
+// ==== Begin Section: Data Population (Public) ==== //
+void LookupTableMulti::ResetData()
+{
+	_indepData = {};
+	_depData = {};
+	_strides = {};
+	_axes = {};
+	_outputs = 0;
+	_searchDepth = 0;
+	_valid = false;
+}
+
+bool LookupTableMulti::IsValidSourceData(const TableDataSet& aIndepDataSet,
+	const TableDataSet& aDepDataSets) const
+{
+	if (aDepDataSets.empty())
+		return false;
+	for (const TableData& depData : aDepDataSets) {
+		if (depData.size() != aDepDataSets.front().size())
+			return false;
+	}
+	// The product cannot overflow here, since each output's values already exist
+	return CheckSourceData(aIndepDataSet, aDepDataSets.front().size() * aDepDataSets.size(),
+		aDepDataSets.size());
+}
+
+bool LookupTableMulti::IsValidSourceData(const TableDataSet& aIndepDataSet,
+	const TableData& aInterleavedData,
+	const size_t& aOutputs) const
+{
+	return CheckSourceData(aIndepDataSet, aInterleavedData.size(), aOutputs);
+}
+
+bool LookupTableMulti::PopulateData(const TableDataSet& aIndepDataSet,
+	const TableDataSet& aDepDataSets)
+{
+	if (IsValidSourceData(aIndepDataSet, aDepDataSets)) {
+		const size_t outputs = aDepDataSets.size();
+		const size_t points = aDepDataSets.front().size();
+		_indepData = aIndepDataSet;
+		_outputs = outputs;
+		_depData.resize(points * outputs);
+		for (size_t k = 0; k < outputs; k++) {
+			const double* values = aDepDataSets[k].data(); // shorthand
+			for (size_t p = 0; p < points; p++) {
+				_depData[p * outputs + k] = values[p];
+			}
+		}
+		BuildStrides();
+		BuildAxes();
+		_valid = true;
+	}
+	else {
+		ResetData();
+	}
+	return _valid;
+}
+
+bool LookupTableMulti::PopulateData(const TableDataSet& aIndepDataSet,
+	const TableData& aInterleavedData,
+	const size_t& aOutputs)
+{
+	if (IsValidSourceData(aIndepDataSet, aInterleavedData, aOutputs)) {
+		_indepData = aIndepDataSet;
+		_depData = aInterleavedData;
+		_outputs = aOutputs;
+		BuildStrides();
+		BuildAxes();
+		_valid = true;
+	}
+	else {
+		ResetData();
+	}
+	return _valid;
+}
+
+bool LookupTableMulti::PopulateData(TableDataSet&& aIndepDataSet,
+	TableData&& aInterleavedData,
+	const size_t& aOutputs)
+{
+	if (IsValidSourceData(aIndepDataSet, aInterleavedData, aOutputs)) {
+		_indepData = std::move(aIndepDataSet);
+		_depData = std::move(aInterleavedData);
+		aIndepDataSet.clear();
+		aInterleavedData.clear();
+		_outputs = aOutputs;
+		BuildStrides();
+		BuildAxes();
+		_valid = true;
+	}
+	else {
+		ResetData();
+	}
+	return _valid;
+}
+// ==== End Section: Data Population (Public) ==== //
+
+
+
+
+// ==== Begin Section: Options (Public) ==== //
+void LookupTableMulti::SetOptions(const TableOptions& aOptions)
+{
+	_options = aOptions;
+	if (_valid)
+		BuildAxes();
+}
+
+const TableOptions& LookupTableMulti::Options() const
+{
+	return _options;
+}
+// ==== End Section: Options (Public) ==== //
+
+
+
+
+// ==== Begin Section: Lookup Methods (Public) ==== //
+void LookupTableMulti::LookupByIndices(const vector<size_t>& aIndexInputs,
+	double* outValues) const
+{
+	size_t dim = 0;
+	const ErrorCode error = FindByIndices(aIndexInputs.data(), aIndexInputs.size(), outValues, &dim);
+	if (error != ErrorCode::None)
+		ThrowError(error, aIndexInputs.data(), dim);
+}
+bool LookupTableMulti::QueryByIndices(const vector<size_t>& aIndexInputs,
+	double* outValues,
+	string* outErrMsg) const
+{
+	if (nullptr == outValues || nullptr == outErrMsg)
+		return false;
+	size_t dim = 0;
+	const ErrorCode error = FindByIndices(aIndexInputs.data(), aIndexInputs.size(), outValues, &dim);
+	if (error != ErrorCode::None) {
+		*outErrMsg = ErrorMessage(error, aIndexInputs.data(), dim);
+		return false;
+	}
+	return true;
+}
+Result<vector<double>> LookupTableMulti::QueryByIndices(const vector<size_t>& aIndexInputs) const
+{
+	vector<double> values(_outputs);
+	const ErrorCode error = FindByIndices(aIndexInputs.data(), aIndexInputs.size(), values.data(), nullptr);
+	return (error == ErrorCode::None) ? Result<vector<double>>(values) : Result<vector<double>>(error);
+}
+
+
+void LookupTableMulti::LookupByValues(const vector<double>& aValueInputs,
+	double* outValues) const
+{
+	const ErrorCode error = FindByValues(aValueInputs.data(), aValueInputs.size(), nullptr, outValues);
+	if (error != ErrorCode::None)
+		ThrowError(error, nullptr, 0);
+}
+bool LookupTableMulti::QueryByValues(const vector<double>& aValueInputs,
+	double* outValues,
+	string* outErrMsg) const
+{
+	if (nullptr == outValues || nullptr == outErrMsg)
+		return false;
+	const ErrorCode error = FindByValues(aValueInputs.data(), aValueInputs.size(), nullptr, outValues);
+	if (error != ErrorCode::None) {
+		*outErrMsg = ErrorCodeMessage(error);
+		return false;
+	}
+	return true;
+}
+Result<vector<double>> LookupTableMulti::QueryByValues(const vector<double>& aValueInputs) const
+{
+	vector<double> values(_outputs);
+	const ErrorCode error = FindByValues(aValueInputs.data(), aValueInputs.size(), nullptr, values.data());
+	return (error == ErrorCode::None) ? Result<vector<double>>(values) : Result<vector<double>>(error);
+}
+
+void LookupTableMulti::LookupByValues(const vector<double>& aValueInputs,
+	LookupHint* ioHint,
+	double* outValues) const
+{
+	const ErrorCode error = (_valid && nullptr == ioHint) ? ErrorCode::NullPointer
+		: FindByValues(aValueInputs.data(), aValueInputs.size(), (ioHint ? ioHint->segments : nullptr), outValues);
+	if (error != ErrorCode::None)
+		ThrowError(error, nullptr, 0);
+}
+bool LookupTableMulti::QueryByValues(const vector<double>& aValueInputs,
+	LookupHint* ioHint,
+	double* outValues,
+	string* outErrMsg) const
+{
+	if (nullptr == outValues || nullptr == outErrMsg)
+		return false;
+	const ErrorCode error = (_valid && nullptr == ioHint) ? ErrorCode::NullPointer
+		: FindByValues(aValueInputs.data(), aValueInputs.size(), (ioHint ? ioHint->segments : nullptr), outValues);
+	if (error != ErrorCode::None) {
+		*outErrMsg = ErrorCodeMessage(error);
+		return false;
+	}
+	return true;
+}
+Result<vector<double>> LookupTableMulti::QueryByValues(const vector<double>& aValueInputs,
+	LookupHint* ioHint) const
+{
+	vector<double> values(_outputs);
+	const ErrorCode error = (_valid && nullptr == ioHint) ? ErrorCode::NullPointer
+		: FindByValues(aValueInputs.data(), aValueInputs.size(), (ioHint ? ioHint->segments : nullptr), values.data());
+	return (error == ErrorCode::None) ? Result<vector<double>>(values) : Result<vector<double>>(error);
+}
+// ==== End Section: Lookup Methods (Public) ==== //
+
+
+
+
+// ==== Begin Section: Batch Lookup Methods (Public) ==== //
+size_t LookupTableMulti::QueryBatchByValues(const vector<const double*>& aDimValues,
+	const size_t& aCount,
+	double* outValues,
+	uint64_t* outValidMask) const
+{
+	if (nullptr == outValues || nullptr == outValidMask)
+		return 0;
+	std::fill(outValidMask, outValidMask + utils::BatchMaskWords(aCount), 0);
+
+	const size_t kInSize = _indepData.size(); // shorthand
+	bool batchValid = _valid && aDimValues.size() == kInSize;
+	for (size_t i = 0; batchValid && i < kInSize; i++) {
+		batchValid = (nullptr != aDimValues[i]);
+	}
+	if (!batchValid) {
+		std::fill(outValues, outValues + aCount * _outputs, std::numeric_limits<double>::quiet_NaN());
+		return 0;
+	}
+
+	size_t validCount = 0;
+	Scratch<double, LookupTableND::kMaxFastDimensions> inputs(kInSize);
+	for (size_t i = 0; i < aCount; i++) {
+		for (size_t d = 0; d < kInSize; d++) {
+			inputs.Data()[d] = aDimValues[d][i];
+		}
+		double* values = &outValues[i * _outputs];
+		if (FindByValues(inputs.Data(), kInSize, nullptr, values) == ErrorCode::None) {
+			outValidMask[i / 64] |= static_cast<uint64_t>(1) << (i % 64);
+			validCount++;
+		}
+		else {
+			std::fill(values, values + _outputs, std::numeric_limits<double>::quiet_NaN());
+		}
+	}
+	return validCount;
+}
+// ==== End Section: Batch Lookup Methods (Public) ==== //
+
+
+
+
+// ==== Begin Section: Metadata (Public) ==== //
+bool LookupTableMulti::Valid() const
+{
+	return _valid;
+}
+size_t LookupTableMulti::Dimensions() const
+{
+	return _indepData.size();
+}
+size_t LookupTableMulti::Outputs() const
+{
+	return _outputs;
+}
+size_t LookupTableMulti::PointCount() const
+{
+	return _valid ? _depData.size() / _outputs : 0;
+}
+size_t LookupTableMulti::DepDataSize() const
+{
+	return _depData.size();
+}
+size_t LookupTableMulti::DepDataBytes() const
+{
+	return _depData.size() * sizeof(double);
+}
+size_t LookupTableMulti::IndepDataSize(const size_t& aDimension) const
+{
+	if (aDimension >= Dimensions())
+		throw std::invalid_argument("Invalid dimension provided: " + std::to_string(aDimension));
+	return _indepData.at(aDimension).size();
+}
+const LookupAxis& LookupTableMulti::Axis(const size_t& aDimension) const
+{
+	if (aDimension >= Dimensions())
+		throw std::invalid_argument("Invalid dimension provided: " + std::to_string(aDimension));
+	return _axes.at(aDimension);
+}
+TableData LookupTableMulti::OutputData(const size_t& aOutput) const
+{
+	if (aOutput >= _outputs)
+		throw std::invalid_argument("Invalid output provided: " + std::to_string(aOutput));
+	TableData values(PointCount());
+	for (size_t p = 0; p < values.size(); p++) {
+		values[p] = _depData[p * _outputs + aOutput];
+	}
+	return values;
+}
+// ==== End Section: Metadata (Public) ==== //
+
+
+
+
+// ==== Begin Section: Helpers (Protected) ==== //
+ErrorCode LookupTableMulti::FindByIndices(const size_t* aIndexInputs,
+	const size_t& aCount,
+	double* outValues,
+	size_t* outDimension) const
+{
+	ZJLD_LOOKUP_STATS_ONLY(stats::QueryTimer timer);
+	if (!_valid)
+		return ErrorCode::InvalidTable;
+	if (nullptr == outValues)
+		return ErrorCode::NullPointer;
+	if (aCount != _indepData.size())
+		return ErrorCode::WrongInputCount;
+	size_t idx = 0;
+	for (size_t i = 0; i < aCount; i++) {
+		if (aIndexInputs[i] >= _indepData[i].size()) {
+			if (outDimension)
+				*outDimension = i;
+			ZJLD_LOOKUP_STATS_ONLY(timer.OutOfBounds());
+			return ErrorCode::IndexOutOfBounds;
+		}
+		idx += aIndexInputs[i] * _strides[i];
+	}
+	std::copy_n(&_depData[idx], _outputs, outValues);
+	return ErrorCode::None;
+}
+
+ErrorCode LookupTableMulti::FindByValues(const double* aValueInputs,
+	const size_t& aCount,
+	size_t* ioSegments,
+	double* outValues) const
+{
+	ZJLD_LOOKUP_STATS_ONLY(stats::QueryTimer timer);
+	if (!_valid)
+		return ErrorCode::InvalidTable;
+	if (nullptr == outValues)
+		return ErrorCode::NullPointer;
+	const size_t kInSize = _indepData.size(); // shorthand
+	if (aCount != kInSize)
+		return ErrorCode::WrongInputCount;
+
+	// Dimensions beyond those of a LookupHint are simply searched without one
+	Scratch<size_t, LookupTableND::kMaxFastDimensions> lowIdxs(kInSize);
+	Scratch<double, LookupTableND::kMaxFastDimensions> prcPrgs(kInSize);
+	for (size_t i = 0; i < kInSize; i++) {
+		size_t* segment = (ioSegments && i < LookupHint::kMaxDimensions) ? &ioSegments[i] : nullptr;
+		if (!FindPositionInfo(i, aValueInputs[i], segment, &lowIdxs.Data()[i], &prcPrgs.Data()[i])) {
+			ZJLD_LOOKUP_STATS_ONLY(timer.OutOfBounds());
+			return ErrorCode::ValueOutOfBounds;
+		}
+	}
+	ZJLD_LOOKUP_STATS_ONLY(timer.Searched(kInSize, ioSegments ? 0 : _searchDepth));
+	InterpolateCell(lowIdxs.Data(), prcPrgs.Data(), outValues);
+	return ErrorCode::None;
+}
+
+bool LookupTableMulti::FindPositionInfo(const size_t& aDimension,
+	const double& aValue,
+	size_t* ioSegment,
+	size_t* outLowIdx,
+	double* outPercProgress) const
+{
+	double pos;
+	const bool found = ioSegment ? _axes[aDimension].FindApproxPos(aValue, ioSegment, &pos)
+		: _axes[aDimension].FindApproxPos(aValue, &pos);
+	if (!found)
+		return false;
+	LookupAxis::CellFromPosition(pos, _indepData[aDimension].size(), outLowIdx,
+		outPercProgress);
+	return true;
+}
+
+void LookupTableMulti::InterpolateCell(const size_t* aLowIdxs,
+	const double* aPercProgresses,
+	double* outValues) const
+{
+	const size_t kInSize = _indepData.size(); // shorthand
+	const size_t kOutputs = _outputs;         // shorthand
+	const size_t comboCount = static_cast<size_t>(1) << kInSize;
+
+	// Offsets of the first output of every corner, ordered as in LookupTableND (the last
+	// dimension being the least significant bit) so that the interpolation below operates
+	// in the exact same order and gives bit-identical results for every output
+	Scratch<size_t, static_cast<size_t>(1) << LookupTableND::kMaxFastDimensions> offsetsScratch(comboCount);
+	size_t* offsets = offsetsScratch.Data();
+	offsets[0] = 0;
+	for (size_t i = 0; i < kInSize; i++) {
+		offsets[0] += aLowIdxs[i] * _strides[i];
+	}
+	for (size_t i = 0, bit = 1; i < kInSize; i++, bit <<= 1) {
+		const size_t step = _strides[kInSize - i - 1];
+		for (size_t j = 0; j < bit; j++) {
+			offsets[j | bit] = offsets[j] + step;
+		}
+	}
+
+	// The first pass interpolates each pair of corners (along the last dimension) straight
+	// from _depData, where the outputs of each corner are contiguous, and each later one
+	// halves the remaining corners.  The inner loops run over the outputs of a pair with
+	// the same weight, so they vectorize.
+	Scratch<double, kMaxFastValues> valsScratch((comboCount / 2) * kOutputs);
+	double* vals = valsScratch.Data();
+	const double* depData = _depData.data();
+	const double firstPrc = aPercProgresses[kInSize - 1];
+	for (size_t j = 1; j < comboCount; j += 2) {
+		const double* low = &depData[offsets[j - 1]];
+		const double* high = &depData[offsets[j]];
+		double* out = &vals[(j / 2) * kOutputs];
+		for (size_t k = 0; k < kOutputs; k++) {
+			out[k] = utils::Lerp(low[k], high[k], firstPrc);
+		}
+	}
+	for (size_t i = 1, count = comboCount / 2; i < kInSize; i++, count >>= 1) {
+		const double prc = aPercProgresses[kInSize - i - 1];
+		for (size_t j = 1; j < count; j += 2) {
+			const double* low = &vals[(j - 1) * kOutputs];
+			const double* high = &vals[j * kOutputs];
+			double* out = &vals[(j / 2) * kOutputs];
+			for (size_t k = 0; k < kOutputs; k++) {
+				out[k] = utils::Lerp(low[k], high[k], prc);
+			}
+		}
+	}
+	std::copy_n(vals, kOutputs, outValues);
+}
+
+string LookupTableMulti::ErrorMessage(const ErrorCode& aError,
+	const size_t* aIndexInputs,
+	const size_t& aDimension) const
+{
+	if (aError == ErrorCode::IndexOutOfBounds && nullptr != aIndexInputs) {
+		return "Input " + std::to_string(aDimension) + " of value "
+			+ std::to_string(aIndexInputs[aDimension]) + " out of bounds[0, "
+			+ std::to_string(_indepData[aDimension].size() - 1) + "].";
+	}
+	return utils::ErrorCodeMessage(aError);
+}
+
+void LookupTableMulti::ThrowError(const ErrorCode& aError,
+	const size_t* aIndexInputs,
+	const size_t& aDimension) const
+{
+	if (aError == ErrorCode::InvalidTable)
+		throw std::runtime_error(utils::ErrorCodeMessage(aError));
+	throw std::invalid_argument(ErrorMessage(aError, aIndexInputs, aDimension));
+}
+
+bool LookupTableMulti::CheckSourceData(const TableDataSet& aIndepDataSet,
+	const size_t& aDepSize,
+	const size_t& aOutputs) const
+{
+	// Valid only if there are aOutputs values for every combination of the independent
+	//   data (e.g. a 2x3x4 grid of 5 outputs needs 120 values)
+	if (aIndepDataSet.size() < 2 || aOutputs == 0)
+		return false; // 1D tables are not implemented
+	size_t reqSize = aOutputs;
+	for (const TableData& breakpoints : aIndepDataSet) {
+		const size_t size = breakpoints.size();
+		if (size != 0 && reqSize > std::numeric_limits<size_t>::max() / size)
+			return false; // far too large to be stored anyway
+		reqSize *= size;
+	}
+	if (reqSize != aDepSize)
+		return false; // dimensions must lineup
+	for (const TableData& breakpoints : aIndepDataSet) {
+		for (size_t j = 1; j < breakpoints.size(); j++) {
+			if (breakpoints[j - 1] >= breakpoints[j])
+				return false;
+		}
+	}
+	return true;
+}
+
+void LookupTableMulti::BuildStrides()
+{
+	_strides = vector<size_t>(_indepData.size());
+	size_t stride = _outputs;
+	for (size_t i = 0; i < _indepData.size(); i++) {
+		_strides[i] = stride;
+		stride *= _indepData[i].size();
+	}
+}
+
+void LookupTableMulti::BuildAxes()
+{
+	_axes = vector<LookupAxis>();
+	_axes.reserve(_indepData.size());
+	_searchDepth = 0;
+	for (size_t i = 0; i < _indepData.size(); i++) {
+		_axes.emplace_back(_indepData.at(i), _options.searchLayout, _options.Bounds(i));
+		_searchDepth += _axes.back().SearchDepth();
+	}
+}
+// ==== End Section: Helpers (Protected) ==== //
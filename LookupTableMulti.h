@@ -0,0 +1,263 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+// This file is part of LookupTable <https://github.com/zjldemers/LookupTable>.
+// 
+// MIT License
+// Copyright (c) 2022 Zachary J. L. Demers
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef _ZJLD_LOOKUP_TABLE_MULTI_H_
+#define _ZJLD_LOOKUP_TABLE_MULTI_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "LookupTableND.h"
+
+
+namespace zjld // feel free to remove/rename as the license above allows
+{
+
+	// This class is a table of 2 to N dimensions holding several dependent values (its
+	// outputs) at every point of one grid, e.g. the thrust, fuel flow and temperatures of
+	// an engine deck sharing the same breakpoints.  The values of each grid point are
+	// stored next to each other (all outputs of point 0, then of point 1, ...), so a
+	// lookup searches each dimension once, finds the corners of the cell once, and then
+	// interpolates all of the outputs together with the same weights, reading one short
+	// contiguous run of values per corner.  Each output is bit-identical to looking it up
+	// in its own LookupTableND with the same breakpoints and options, which this replaces
+	// at a fraction of the searching (and, since the breakpoints and their searches are
+	// only stored once, of the memory).
+	// Of the TableOptions, only the search layout and the bound policies apply: the
+	// dependent data is always stored Linear as Double, and cells are never precomputed.
+	// Thread safety is the same as that of LookupTableND (any number of threads may call
+	// the const methods at once).
+	class LookupTableMulti
+	{
+	protected:
+		TableDataSet _indepData;        // vector of vectors of independent variable data
+		std::vector<double> _depData;   // every output of each grid point, point by point
+		std::vector<size_t> _strides;   // _depData step per dimension (in values)
+		std::vector<LookupAxis> _axes;  // search structures for each _indepData vector
+		TableOptions _options;          // how the searches above are built
+		size_t _outputs;                // number of dependent values per grid point
+		size_t _searchDepth;            // sum of the axes' SearchDepth (for LookupStats)
+		bool _valid;                    // current validity status of the table
+
+	public:
+		// Lookups keep the outputs of half of the corners of a cell on the stack for up to
+		// this many values (e.g. 4 corners of 3 dimensions with 256 outputs), allocating
+		// only beyond that
+		static const size_t kMaxFastValues = 1024;
+
+	// ==== Begin Section: Construction/Destruction (Public) ==== //
+		/* - Provided a valid data set, these will initialize the table appropriately and
+		* set _valid (accessed with Valid()) to true
+		* - Provided no arguments or an invalid dataset, these will set _valid to false
+		* - Note: a valid data set has 2 or more independent data vectors and at least one
+		* dependent data vector, each laid out as that of a LookupTableND with the same
+		* independent data (e.g. indep[0].size=2, indep[1].size=3 -> each dep.size=6)
+		*/
+		LookupTableMulti();
+		LookupTableMulti(const TableDataSet& aIndepDataSet,
+			const TableDataSet& aDepDataSets);
+		LookupTableMulti(const TableDataSet& aIndepDataSet,
+			const TableDataSet& aDepDataSets,
+			const TableOptions& aOptions);
+		virtual ~LookupTableMulti(){}
+	// ==== End Section: Construction/Destruction (Public) ==== //
+
+
+	// ==== Begin Section: Data Population (Public) ==== //
+		/* These check if a given data set is valid to supply the source for this table,
+		* return true if true, false otherwise.  The interleaved form holds aOutputs values
+		* per grid point, point by point (the order the table stores them in).
+		*/
+		bool IsValidSourceData(const TableDataSet& aIndepDataSet,
+			const TableDataSet& aDepDataSets) const;
+		bool IsValidSourceData(const TableDataSet& aIndepDataSet,
+			const TableData& aInterleavedData,
+			const size_t& aOutputs) const;
+
+		/* These attempt to populate the table with the given data, one dependent data
+		* vector per output or already interleaved as described above.  If unable to, the
+		* table is reset using ResetData, resulting in the Valid flag being false.
+		*/
+		bool PopulateData(const TableDataSet& aIndepDataSet,
+			const TableDataSet& aDepDataSets);
+		bool PopulateData(const TableDataSet& aIndepDataSet,
+			const TableData& aInterleavedData,
+			const size_t& aOutputs);
+
+		/* This is the same as the above, but takes over the memory of the given data instead
+		* of copying it.  The given data is left empty if the table is populated, or
+		* unchanged otherwise.
+		*/
+		bool PopulateData(TableDataSet&& aIndepDataSet,
+			TableData&& aInterleavedData,
+			const size_t& aOutputs);
+
+		/* This empties all data in the table and sets the Valid flag to be false.
+		*/
+		void ResetData();
+	// ==== End Section: Data Population (Public) ==== //
+
+
+	// ==== Begin Section: Options (Public) ==== //
+		/* These set and return the options used to build the table's searches (see the
+		* class description for those that apply).  ResetData keeps the options.
+		*/
+		void SetOptions(const TableOptions& aOptions);
+		const TableOptions& Options() const;
+	// ==== End Section: Options (Public) ==== //
+
+
+	// ==== Begin Section: Lookup Methods (Public) ==== //
+		/* These write the exact values stored at the given independent data indices, one
+		* per output, to outValues (which must hold Outputs() values).
+		*/
+		void LookupByIndices(const std::vector<size_t>& aIndexInputs,
+			double* outValues) const;
+		bool QueryByIndices(const std::vector<size_t>& aIndexInputs,
+			double* outValues,
+			std::string* outErrMsg) const;
+		utils::Result<std::vector<double>> QueryByIndices(const std::vector<size_t>& aIndexInputs) const;
+
+		/* These write the value of every output interpolated at the given values to
+		* outValues (which must hold Outputs() values), exactly as LookupTableND's
+		* LookupByValues would for each of them.  Nothing is written to outValues on failure.
+		* The Result form allocates its vector, so prefer the others in hot loops.
+		*/
+		void LookupByValues(const std::vector<double>& aValueInputs,
+			double* outValues) const;
+		bool QueryByValues(const std::vector<double>& aValueInputs,
+			double* outValues,
+			std::string* outErrMsg) const;
+		utils::Result<std::vector<double>> QueryByValues(const std::vector<double>& aValueInputs) const;
+
+		/* These are the same as the above, but each dimension's search starts from the
+		* segment stored in ioHint, which is then updated with the segment that was found
+		* (see LookupHint).
+		*/
+		void LookupByValues(const std::vector<double>& aValueInputs,
+			LookupHint* ioHint,
+			double* outValues) const;
+		bool QueryByValues(const std::vector<double>& aValueInputs,
+			LookupHint* ioHint,
+			double* outValues,
+			std::string* outErrMsg) const;
+		utils::Result<std::vector<double>> QueryByValues(const std::vector<double>& aValueInputs,
+			LookupHint* ioHint) const;
+	// ==== End Section: Lookup Methods (Public) ==== //
+
+
+	// ==== Begin Section: Batch Lookup Methods (Public) ==== //
+		/* This is the equivalent of LookupByValues for many points at once, with the inputs
+		* given as a structure of arrays as for LookupTableND::QueryBatchByValues.
+		* - outValues must hold aCount * Outputs() values and receives the outputs of each
+		* point next to each other (output k of point i at i * Outputs() + k), or NaN for
+		* every output of a point that could not be evaluated (e.g. out of bounds)
+		* - outValidMask must hold utils::BatchMaskWords(aCount) words, with bit (i % 64)
+		* of word (i / 64) set if point i is valid
+		* The number of valid points is returned (0 if the batch itself is invalid).
+		*/
+		size_t QueryBatchByValues(const std::vector<const double*>& aDimValues,
+			const size_t& aCount,
+			double* outValues,
+			uint64_t* outValidMask) const;
+	// ==== End Section: Batch Lookup Methods (Public) ==== //
+
+
+	// ==== Begin Section: Metadata (Public) ==== //
+		bool Valid() const;
+		size_t Dimensions() const;  // _indepData.size (vector of vectors)
+		size_t Outputs() const;     // number of dependent values per grid point
+		size_t PointCount() const;  // number of grid points
+		size_t DepDataSize() const; // number of dependent data values (all outputs)
+		size_t DepDataBytes() const; // memory used to store them
+		size_t IndepDataSize(const size_t& aDimension) const; // _indepData[aDimension].size
+		const LookupAxis& Axis(const size_t& aDimension) const; // search info for a dimension
+
+		/* This returns the values of output aOutput alone, laid out as the dependent data of
+		* a LookupTableND with the same independent data.
+		*/
+		TableData OutputData(const size_t& aOutput) const;
+	// ==== End Section: Metadata (Public) ==== //
+
+
+	protected:
+
+	// ==== Begin Section: Helpers (Protected) ==== //
+		/* These are the non-throwing cores of the lookup methods above, writing every output
+		* to outValues.  FindByIndices reports the dimension of an index out of bounds in
+		* outDimension (if not null), and FindByValues starts the search of each dimension
+		* d from ioSegments[d] and updates it (if not null, see LookupHint).
+		*/
+		utils::ErrorCode FindByIndices(const size_t* aIndexInputs,
+			const size_t& aCount,
+			double* outValues,
+			size_t* outDimension) const;
+		utils::ErrorCode FindByValues(const double* aValueInputs,
+			const size_t& aCount,
+			size_t* ioSegments,
+			double* outValues) const;
+
+		/* This finds the index beneath aValue along aDimension and the percent progress from
+		* it to the next one, as LookupTableND::FindPositionInfo does (so that the weights,
+		* and thus the results, match those of LookupTableND), returning false if aValue is
+		* out of bounds and the dimension's bound policy is Error.
+		*/
+		bool FindPositionInfo(const size_t& aDimension,
+			const double& aValue,
+			size_t* ioSegment,
+			size_t* outLowIdx,
+			double* outPercProgress) const;
+
+		/* This interpolates every output within the cell at aLowIdxs, working down through
+		* its corners in the same order as LookupTableND::InterpolateCell, with the outputs
+		* of each pair of corners interpolated together in one pass.
+		*/
+		void InterpolateCell(const size_t* aLowIdxs,
+			const double* aPercProgresses,
+			double* outValues) const;
+
+		/* These return the message of aError (naming the index out of bounds along
+		* aDimension if given aIndexInputs) and throw it, respectively.
+		*/
+		std::string ErrorMessage(const utils::ErrorCode& aError,
+			const size_t* aIndexInputs,
+			const size_t& aDimension) const;
+		void ThrowError(const utils::ErrorCode& aError,
+			const size_t* aIndexInputs,
+			const size_t& aDimension) const;
+
+		/* These check the independent data and the number of dependent values given, and
+		* build the strides and searches of populated data, respectively.
+		*/
+		bool CheckSourceData(const TableDataSet& aIndepDataSet,
+			const size_t& aDepSize,
+			const size_t& aOutputs) const;
+		void BuildStrides();
+		void BuildAxes();
+	// ==== End Section: Helpers (Protected) ==== //
+	};
+}
+
+#endif // !_ZJLD_LOOKUP_TABLE_MULTI_H_
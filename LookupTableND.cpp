@@ -24,12 +24,219 @@
 /////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "LookupTableND.h"
+#include "LookupSimd.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
 #include <stdexcept>
 
 using namespace zjld; // feel free to remove/rename as the license above allows
 using std::string;
 using std::vector;
+using utils::ErrorCode;
 using utils::Result;
+using utils::Scratch;
+
+
+namespace
+{
+	const size_t kStreamChunkValues = 1 << 16; // requested from a DepDataSource at a time
+	const size_t kCubicFastValues = 1024; // corner values and derivatives interpolated by
+	                                      // InterpolateCubic without allocating
+
+	// Returns a generation never returned before in this process (see Generation), where
+	// 0 is left for slices and partials that were never filled
+	uint64_t NewGeneration()
+	{
+		static std::atomic<uint64_t> next{ 1 };
+		return next.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	// Reads and checks the header of a (mapped or read) binary table file
+	bool ReadHeader(const file::MappedFile& aFile,
+		file::Header* outHeader,
+		string* outErrMsg)
+	{
+		if (aFile.Size() < file::kHeaderBytes) {
+			*outErrMsg = "Not a binary lookup table file (too small).";
+			return false;
+		}
+		std::memcpy(outHeader, aFile.Data(), sizeof(*outHeader));
+		*outErrMsg = file::CheckHeader(*outHeader, aFile.Size());
+		return outErrMsg->empty();
+	}
+
+	// Computes the checksum of a binary table file whose header has been checked
+	uint64_t FileChecksum(const file::MappedFile& aFile,
+		const file::Header& aHeader)
+	{
+		uint64_t hash = file::Checksum(aFile.Data() + aHeader.axesOffset,
+			static_cast<size_t>(aHeader.axesBytes), file::kChecksumSeed);
+		return file::Checksum(aFile.Data() + aHeader.depOffset,
+			static_cast<size_t>(aHeader.depBytes), hash);
+	}
+
+	// Returns the number of points in the grid of aIndepData, or 0 if any dimension is
+	// empty or there are too many to count
+	size_t GridSize(const TableDataSet& aIndepData)
+	{
+		size_t size = 1;
+		for (const TableData& breakpoints : aIndepData) {
+			if (!breakpoints.empty() && size > std::numeric_limits<size_t>::max() / breakpoints.size())
+				return 0;
+			size *= breakpoints.size();
+		}
+		return size;
+	}
+
+	// Builds the axes block of a binary table file (see LookupFile.h): the size of every
+	// dimension, then all of their breakpoints
+	vector<unsigned char> AxesBlock(const TableDataSet& aIndepData)
+	{
+		size_t axesValues = aIndepData.size();
+		for (const TableData& breakpoints : aIndepData) {
+			axesValues += breakpoints.size();
+		}
+		vector<unsigned char> axes(file::AlignUp(axesValues * sizeof(uint64_t)), 0);
+		unsigned char* pos = axes.data();
+		for (const TableData& breakpoints : aIndepData) {
+			const uint64_t size = breakpoints.size();
+			std::memcpy(pos, &size, sizeof(size));
+			pos += sizeof(uint64_t);
+		}
+		for (const TableData& breakpoints : aIndepData) {
+			std::memcpy(pos, breakpoints.data(), breakpoints.size() * sizeof(double));
+			pos += breakpoints.size() * sizeof(double);
+		}
+		return axes;
+	}
+
+	// Returns -1, 0 or 1 for negative, zero (or NaN) and positive values
+	int Sign(const double aValue)
+	{
+		return (aValue > 0.0) - (aValue < 0.0);
+	}
+
+	// Returns the slope of a monotone cubic at the end of a line of at least 3 points,
+	// given the widths and slopes of its end segment (aWidth0, aSlope0) and of the one
+	// next to it, from a three point estimate pulled back so as not to overshoot
+	double PchipEndSlope(const double aWidth0,
+		const double aWidth1,
+		const double aSlope0,
+		const double aSlope1)
+	{
+		const double slope = ((2.0 * aWidth0 + aWidth1) * aSlope0 - aWidth0 * aSlope1)
+			/ (aWidth0 + aWidth1);
+		if (Sign(slope) != Sign(aSlope0))
+			return 0.0;
+		if (Sign(aSlope0) != Sign(aSlope1) && std::abs(slope) > std::abs(3.0 * aSlope0))
+			return 3.0 * aSlope0;
+		return slope;
+	}
+
+	// Fills outSlopes with the slope of the cubic Hermite spline of aKernel (see
+	// TableOptions::Interpolation) through the aSize points (aX[i], aY[i]) at each of them
+	void KernelSlopes(const TableOptions::Interpolation aKernel,
+		const double* aX,
+		const double* aY,
+		const size_t aSize,
+		double* outSlopes)
+	{
+		if (aSize < 2) {
+			std::fill(outSlopes, outSlopes + aSize, 0.0);
+			return;
+		}
+		vector<double> widths(aSize - 1), slopes(aSize - 1); // of each segment
+		for (size_t i = 0; i + 1 < aSize; i++) {
+			widths[i] = aX[i + 1] - aX[i];
+			slopes[i] = (aY[i + 1] - aY[i]) / widths[i];
+		}
+		if (aSize == 2) {
+			outSlopes[0] = outSlopes[1] = slopes[0];
+			return;
+		}
+
+		const size_t last = aSize - 1; // shorthand
+		switch (aKernel) {
+		case TableOptions::Interpolation::Linear:
+		case TableOptions::Interpolation::CatmullRom:
+			// The slope across both neighbours, or of the end segments at the ends
+			outSlopes[0] = slopes[0];
+			for (size_t i = 1; i < last; i++) {
+				outSlopes[i] = (aY[i + 1] - aY[i - 1]) / (aX[i + 1] - aX[i - 1]);
+			}
+			outSlopes[last] = slopes[last - 1];
+			break;
+		case TableOptions::Interpolation::Pchip:
+			// Flat at local extrema, otherwise a weighted harmonic mean of the slopes on
+			// either side (Fritsch and Carlson)
+			outSlopes[0] = PchipEndSlope(widths[0], widths[1], slopes[0], slopes[1]);
+			for (size_t i = 1; i < last; i++) {
+				if (Sign(slopes[i - 1]) * Sign(slopes[i]) <= 0) {
+					outSlopes[i] = 0.0;
+					continue;
+				}
+				const double w1 = 2.0 * widths[i] + widths[i - 1];
+				const double w2 = widths[i] + 2.0 * widths[i - 1];
+				outSlopes[i] = (w1 + w2) / (w1 / slopes[i - 1] + w2 / slopes[i]);
+			}
+			outSlopes[last] = PchipEndSlope(widths[last - 1], widths[last - 2],
+				slopes[last - 1], slopes[last - 2]);
+			break;
+		case TableOptions::Interpolation::Akima: {
+			// Each point weights the segments on either side by how much the slopes change
+			// on the other side, with the slopes extended by two segments past each end
+			vector<double> ext(aSize + 3); // ext[i + 2] is the slope of segment i
+			std::copy(slopes.begin(), slopes.end(), ext.begin() + 2);
+			ext[1] = 2.0 * ext[2] - ext[3];
+			ext[0] = 2.0 * ext[1] - ext[2];
+			ext[aSize + 1] = 2.0 * ext[aSize] - ext[aSize - 1];
+			ext[aSize + 2] = 2.0 * ext[aSize + 1] - ext[aSize];
+			for (size_t i = 0; i < aSize; i++) {
+				const double wLeft = std::abs(ext[i + 3] - ext[i + 2]);
+				const double wRight = std::abs(ext[i + 1] - ext[i]);
+				outSlopes[i] = (wLeft + wRight == 0.0) ? 0.5 * (ext[i + 1] + ext[i + 2])
+					: (wLeft * ext[i + 1] + wRight * ext[i + 2]) / (wLeft + wRight);
+			}
+			break;
+		}
+		}
+	}
+
+	// Fills outWeights with the weights of the low value, low slope, high value and high
+	// slope of a segment of aWidth in the cubic Hermite interpolation aPercProgress along
+	// it, which continues along the slope of the nearest end outside of [0, 1]
+	void HermiteWeights(const double aPercProgress,
+		const double aWidth,
+		double* outWeights)
+	{
+		const double t = aPercProgress; // shorthand
+		if (t < 0.0) {
+			outWeights[0] = 1.0;
+			outWeights[1] = t * aWidth;
+			outWeights[2] = 0.0;
+			outWeights[3] = 0.0;
+		}
+		else if (t > 1.0) {
+			outWeights[0] = 0.0;
+			outWeights[1] = 0.0;
+			outWeights[2] = 1.0;
+			outWeights[3] = (t - 1.0) * aWidth;
+		}
+		else {
+			const double t2 = t * t;
+			const double t3 = t2 * t;
+			outWeights[0] = 2.0 * t3 - 3.0 * t2 + 1.0;
+			outWeights[1] = (t3 - 2.0 * t2 + t) * aWidth;
+			outWeights[2] = 3.0 * t2 - 2.0 * t3;
+			outWeights[3] = (t3 - t2) * aWidth;
+		}
+	}
+}
 
 
 // ==== Begin Section: Construction/Destruction (Public) ==== //
@@ -48,6 +255,31 @@ LookupTableND::LookupTableND(const TableDataSet& aIndepDataSet,
 {
 	PopulateData(aIndepDataSet, aDepData);
 }
+
+LookupTableND::LookupTableND(TableDataSet&& aFullDataSet)
+{
+	PopulateData(std::move(aFullDataSet));
+}
+
+LookupTableND::LookupTableND(TableDataSet&& aIndepDataSet,
+	TableData&& aDepData)
+{
+	PopulateData(std::move(aIndepDataSet), std::move(aDepData));
+}
+
+LookupTableND::LookupTableND(const TableDataSet& aFullDataSet,
+	const TableOptions& aOptions)
+	: _options{ aOptions }
+{
+	PopulateData(aFullDataSet);
+}
+
+LookupTableND::LookupTableND(TableDataSet&& aFullDataSet,
+	const TableOptions& aOptions)
+	: _options{ aOptions }
+{
+	PopulateData(std::move(aFullDataSet));
+}
 // ==== End Section: Construction/Destruction (Public) ==== //
 
 
@@ -57,40 +289,50 @@ LookupTableND::LookupTableND(const TableDataSet& aIndepDataSet,
 void LookupTableND::ResetData()
 {
 	_indepData = {};
-	_depData = {};
+	_depData = LookupStorage();
+	_strides = {};
+	_dimOffsets = {};
+	_tiles = {};
+	_reader = nullptr;
+	_axes = {};
+	_cellData = {};
+	_cellStrides = {};
+	_derivData = {};
+	_kernelBits = {};
+	_derivBlock = 1;
+	_searchDepth = 0;
+	_generation = NewGeneration();
 	_valid = false;
 }
 
 bool LookupTableND::IsValidSourceData(const TableDataSet& aFullDataSet) const
 {
-	// Valid only if the last element (dependent data) has a size equal to the size of each
-	//   independent data array multiplied together (e.g. a 2x3x4 needs a size 24 dep data)
-	if (aFullDataSet.size() < 3)
-		return false; // 1D tables are not implemented (1 indep, 1 dep -> size=2)
-	size_t reqSize = 1;
-	for (size_t i = 0; i < aFullDataSet.size() - 1; i++) {
-		reqSize *= aFullDataSet.at(i).size();
-	}
-	if (reqSize != aFullDataSet.back().size())
-		return false; // dimensions must lineup
-	return CheckMonotonicallyIncreasing(aFullDataSet);
+	if (aFullDataSet.empty())
+		return false;
+	return CheckSourceData(aFullDataSet.data(), aFullDataSet.size() - 1, aFullDataSet.back().size());
 }
 
 bool LookupTableND::IsValidSourceData(const TableDataSet& aIndepDataSet,
 	const TableData& aDepData) const
 {
-	if (aIndepDataSet.size() < 2)
-		return false; // 1D tables are not implemented
-	TableDataSet fullData = aIndepDataSet;
-	fullData.push_back(aDepData);
-	return IsValidSourceData(fullData);
+	return CheckSourceData(aIndepDataSet.data(), aIndepDataSet.size(), aDepData.size());
+}
+
+bool LookupTableND::IsValidDimensionCount(const size_t& aDimensions) const
+{
+	return aDimensions >= 2; // 1D tables are not implemented
 }
 
 bool LookupTableND::PopulateData(const TableDataSet& aFullDataSet)
 {
 	if (IsValidSourceData(aFullDataSet)) {
 		_indepData = TableDataSet(aFullDataSet.begin(), aFullDataSet.end() - 1);
-		_depData = aFullDataSet.back();
+		_reader = nullptr; // (no longer paged or lazy, if it was)
+		BuildStrides();
+		BuildStorage(aFullDataSet.back());
+		BuildAxes();
+		BuildDerivatives();
+		BuildCells();
 		_valid = true;
 	}
 	else {
@@ -102,34 +344,437 @@ bool LookupTableND::PopulateData(const TableDataSet& aFullDataSet)
 bool LookupTableND::PopulateData(const TableDataSet& aIndepDataSet,
 	const TableData& aDepData)
 {
-	TableDataSet fullData = aIndepDataSet;
-	fullData.push_back(aDepData);
-	return PopulateData(fullData);
+	if (IsValidSourceData(aIndepDataSet, aDepData)) {
+		_indepData = aIndepDataSet;
+		_reader = nullptr; // (no longer paged or lazy, if it was)
+		BuildStrides();
+		BuildStorage(aDepData);
+		BuildAxes();
+		BuildDerivatives();
+		BuildCells();
+		_valid = true;
+	}
+	else {
+		ResetData();
+	}
+	return _valid;
+}
+
+bool LookupTableND::PopulateData(TableDataSet&& aFullDataSet)
+{
+	if (IsValidSourceData(aFullDataSet)) {
+		TableData depData = std::move(aFullDataSet.back());
+		aFullDataSet.pop_back();
+		_indepData = std::move(aFullDataSet);
+		aFullDataSet.clear(); // moved from, so make sure it is left empty
+		_reader = nullptr; // (no longer paged or lazy, if it was)
+		BuildStrides();
+		BuildStorage(std::move(depData));
+		BuildAxes();
+		BuildDerivatives();
+		BuildCells();
+		_valid = true;
+	}
+	else {
+		ResetData();
+	}
+	return _valid;
+}
+
+bool LookupTableND::PopulateData(TableDataSet&& aIndepDataSet,
+	TableData&& aDepData)
+{
+	if (IsValidSourceData(aIndepDataSet, aDepData)) {
+		_indepData = std::move(aIndepDataSet);
+		aIndepDataSet.clear();
+		_reader = nullptr; // (no longer paged or lazy, if it was)
+		BuildStrides();
+		BuildStorage(std::move(aDepData));
+		aDepData.clear();
+		BuildAxes();
+		BuildDerivatives();
+		BuildCells();
+		_valid = true;
+	}
+	else {
+		ResetData();
+	}
+	return _valid;
+}
+
+bool LookupTableND::PopulateDataView(const TableDataSet& aIndepDataSet,
+	const double* aDepData,
+	const size_t& aDepSize)
+{
+	if (nullptr != aDepData
+		&& CheckSourceData(aIndepDataSet.data(), aIndepDataSet.size(), aDepSize)) {
+		_indepData = aIndepDataSet;
+		_reader = nullptr; // (no longer paged or lazy, if it was)
+		BuildStrides();
+		if (_options.storageType == StorageType::Double && BuildDimOffsets() == aDepSize
+			&& _dimOffsets.empty()) {
+			_depData = LookupStorage(aDepData, aDepSize, StorageType::Double, nullptr);
+		}
+		else {
+			BuildStorage(aDepData, aDepSize);
+		}
+		BuildAxes();
+		BuildDerivatives();
+		BuildCells();
+		_valid = true;
+	}
+	else {
+		ResetData();
+	}
+	return _valid;
+}
+
+bool LookupTableND::PopulateLazy(const TableDataSet& aIndepDataSet,
+	const DepDataGenerator& aGenerator,
+	const LazyOptions& aLazy,
+	string* outErrMsg)
+{
+	ResetData();
+	string errMsg;
+	const size_t depCount = GridSize(aIndepDataSet);
+	if (depCount == 0 || aIndepDataSet.size() > kMaxFastDimensions
+		|| !CheckSourceData(aIndepDataSet.data(), aIndepDataSet.size(), depCount)) {
+		errMsg = "Invalid independent data (see IsValidSourceData).";
+	}
+	else if (!aGenerator) {
+		errMsg = "No dependent data generator provided.";
+	}
+	else if (_options.tileSize < 2) {
+		errMsg = "Lazy tables need a tile size of at least 2.";
+	}
+	else {
+		_indepData = aIndepDataSet;
+		_options.storageType = StorageType::Double;
+		_options.dataLayout = TableOptions::DataLayout::Tiled;
+		BuildStrides();
+		BuildDimOffsets();
+		_reader = LazyTiles::Create(_indepData, _options.tileSize, aGenerator, aLazy, &errMsg);
+		if (_reader) {
+			BuildAxes();
+			_valid = true;
+			return true;
+		}
+	}
+	ResetData();
+	if (outErrMsg) {
+		*outErrMsg = errMsg;
+	}
+	return false;
 }
 // ==== End Section: Data Population (Public) ==== //
 
 
 
+
+// ==== Begin Section: Options (Public) ==== //
+void LookupTableND::SetOptions(const TableOptions& aOptions)
+{
+	if (_valid && _reader) {
+		// The dependent data stays as it is read (see LoadBinary and PopulateLazy)
+		const TableOptions fileOptions = _options;
+		_options = aOptions;
+		_options.storageType = fileOptions.storageType;
+		_options.dataLayout = fileOptions.dataLayout;
+		_options.tileSize = fileOptions.tileSize;
+		BuildAxes();
+	}
+	else if (_valid) {
+		const TableData depData = LogicalDepData();
+		_options = aOptions;
+		BuildStorage(depData);
+		BuildAxes();
+		BuildDerivatives();
+		BuildCells();
+	}
+	else {
+		_options = aOptions;
+	}
+}
+
+const TableOptions& LookupTableND::Options() const
+{
+	return _options;
+}
+// ==== End Section: Options (Public) ==== //
+
+
+
+
+// ==== Begin Section: Binary Files (Public) ==== //
+bool LookupTableND::SaveBinary(const string& aPath,
+	string* outErrMsg) const
+{
+	if (_valid && !_tiles.empty()) {
+		// Files hold the dependent data as it is stored, which they have no format for
+		// when Compressed, so save it as Tiled instead (see TableOptions::DataLayout)
+		LookupTableND tiled(*this);
+		TableOptions options = _options;
+		options.dataLayout = TableOptions::DataLayout::Tiled;
+		tiled.SetOptions(options);
+		return tiled.SaveBinary(aPath, outErrMsg);
+	}
+
+	string errMsg;
+	if (!_valid) {
+		errMsg = "Unable to save invalid table.";
+	}
+	else if (_reader) {
+		errMsg = "Unable to save a paged or lazy table (a paged table's file can be copied instead).";
+	}
+	else {
+		const vector<unsigned char> axes = AxesBlock(_indepData);
+
+		// Dependent block: the values as stored, followed by at least one value of padding
+		const size_t valueBytes = LookupStorage::ValueBytes(_depData.Type());
+		const size_t depDataBytes = _depData.Size() * valueBytes;
+		file::Header header = file::EmptyHeader();
+		header.dimensions = static_cast<uint32_t>(_indepData.size());
+		header.storageType = static_cast<uint32_t>(_depData.Type());
+		header.dataLayout = static_cast<uint32_t>(_dimOffsets.empty()
+			? TableOptions::DataLayout::Linear : TableOptions::DataLayout::Tiled);
+		header.tileSize = _options.tileSize;
+		header.axesOffset = file::kHeaderBytes;
+		header.axesBytes = axes.size();
+		header.depOffset = file::kHeaderBytes + axes.size();
+		header.depCount = _depData.Size();
+		header.depBytes = file::AlignUp(depDataBytes + valueBytes);
+		const size_t depWordBytes = (depDataBytes + 7) / 8 * 8; // checksummed as whole words
+		header.checksum = file::Checksum(axes.data(), axes.size(), file::kChecksumSeed);
+		header.checksum = file::Checksum(_depData.Data(), depDataBytes, header.checksum);
+		header.checksum = file::Checksum(nullptr,
+			static_cast<size_t>(header.depBytes) - depWordBytes, header.checksum);
+
+		std::ofstream stream{ aPath, std::ios::binary | std::ios::trunc };
+		const char zeros[file::kAlignment] = {};
+		stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		stream.write(reinterpret_cast<const char*>(axes.data()), axes.size());
+		stream.write(static_cast<const char*>(_depData.Data()), depDataBytes);
+		for (size_t padding = static_cast<size_t>(header.depBytes) - depDataBytes; padding > 0;) {
+			const size_t count = std::min(padding, sizeof(zeros));
+			stream.write(zeros, count);
+			padding -= count;
+		}
+		stream.close();
+		if (!stream) {
+			errMsg = "Unable to write " + aPath + ".";
+		}
+	}
+	if (!errMsg.empty() && outErrMsg) {
+		*outErrMsg = errMsg;
+	}
+	return errMsg.empty();
+}
+
+bool LookupTableND::LoadBinary(const string& aPath,
+	const FileMode& aMode,
+	string* outErrMsg)
+{
+	ResetData();
+	string errMsg;
+	auto fail = [&](const string& aErrMsg) {
+		ResetData();
+		if (outErrMsg) {
+			*outErrMsg = aErrMsg;
+		}
+		return false;
+	};
+
+	// Copy also reads the file into memory, which is then owned by _depData rather than
+	// copied a second time
+	const std::shared_ptr<file::MappedFile> mapped
+		= file::MappedFile::Open(aPath, aMode == FileMode::Map, &errMsg);
+	file::Header header;
+	if (!mapped || !ReadHeader(*mapped, &header, &errMsg))
+		return fail(errMsg);
+	if (aMode == FileMode::Copy && FileChecksum(*mapped, header) != header.checksum)
+		return fail("The file's checksum does not match its contents.");
+	errMsg = LoadLayout(header, mapped->Data() + header.axesOffset);
+	if (!errMsg.empty())
+		return fail(errMsg);
+	_depData = LookupStorage(mapped->Data() + header.depOffset,
+		static_cast<size_t>(header.depCount), _options.storageType, mapped);
+	BuildAxes();
+	BuildDerivatives();
+	BuildCells();
+	_valid = true;
+	return true;
+}
+
+bool LookupTableND::LoadBinary(const string& aPath,
+	const PageOptions& aPages,
+	string* outErrMsg)
+{
+	ResetData();
+	string errMsg;
+	auto fail = [&](const string& aErrMsg) {
+		ResetData();
+		if (outErrMsg) {
+			*outErrMsg = aErrMsg;
+		}
+		return false;
+	};
+
+	// Only the header and axes are read here, through the same positional reads the
+	// pages of the dependent block use later
+	const std::shared_ptr<PageCache> pages = PageCache::Open(aPath, aPages, &errMsg);
+	if (!pages)
+		return fail(errMsg);
+	file::Header header;
+	if (!pages->ReadBytes(0, sizeof(header), &header))
+		return fail("Not a binary lookup table file (too small).");
+	errMsg = file::CheckHeader(header, static_cast<size_t>(pages->FileBytes()));
+	if (!errMsg.empty())
+		return fail(errMsg);
+	vector<uint64_t> axes(static_cast<size_t>(header.axesBytes) / sizeof(uint64_t));
+	if (!pages->ReadBytes(header.axesOffset, static_cast<size_t>(header.axesBytes), axes.data()))
+		return fail("Unable to read " + aPath + ".");
+	errMsg = LoadLayout(header, reinterpret_cast<const unsigned char*>(axes.data()));
+	if (!errMsg.empty())
+		return fail(errMsg);
+	pages->Attach(header.depOffset, static_cast<size_t>(header.depCount), _options.storageType);
+	_reader = pages;
+	BuildAxes();
+	_valid = true;
+	return true;
+}
+
+bool LookupTableND::PopulateStream(const string& aPath,
+	const TableDataSet& aIndepDataSet,
+	const DepDataSource& aSource,
+	const PageOptions& aPages,
+	string* outErrMsg)
+{
+	ResetData();
+	bool created = false;
+	auto fail = [&](const string& aErrMsg) {
+		if (created) {
+			std::remove(aPath.c_str());
+		}
+		ResetData();
+		if (outErrMsg) {
+			*outErrMsg = aErrMsg;
+		}
+		return false;
+	};
+
+	const size_t depCount = GridSize(aIndepDataSet);
+	if (depCount == 0 || !CheckSourceData(aIndepDataSet.data(), aIndepDataSet.size(), depCount))
+		return fail("Invalid independent data (see IsValidSourceData).");
+	if (!aSource)
+		return fail("No dependent data source provided.");
+
+	// The header is written first with no checksum, then again once it is known
+	const StorageType type = _options.storageType;
+	const size_t valueBytes = LookupStorage::ValueBytes(type);
+	const size_t depDataBytes = depCount * valueBytes;
+	const vector<unsigned char> axes = AxesBlock(aIndepDataSet);
+	file::Header header = file::EmptyHeader();
+	header.dimensions = static_cast<uint32_t>(aIndepDataSet.size());
+	header.storageType = static_cast<uint32_t>(type);
+	header.dataLayout = static_cast<uint32_t>(TableOptions::DataLayout::Linear);
+	header.tileSize = _options.tileSize;
+	header.axesOffset = file::kHeaderBytes;
+	header.axesBytes = axes.size();
+	header.depOffset = file::kHeaderBytes + axes.size();
+	header.depCount = depCount;
+	header.depBytes = file::AlignUp(depDataBytes + valueBytes);
+	std::ofstream stream{ aPath, std::ios::binary | std::ios::trunc };
+	if (!stream)
+		return fail("Unable to write " + aPath + ".");
+	created = true;
+	stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	stream.write(reinterpret_cast<const char*>(axes.data()), axes.size());
+	uint64_t checksum = file::Checksum(axes.data(), axes.size(), file::kChecksumSeed);
+
+	// Dependent block, converted and checksummed a chunk at a time, carrying any partial
+	// word over to the next chunk so that the checksum matches that of SaveBinary
+	vector<double> chunk(kStreamChunkValues);
+	unsigned char tail[sizeof(uint64_t)];
+	size_t tailBytes = 0, supplied = 0;
+	for (size_t count; (count = aSource(chunk.data(), chunk.size())) > 0;) {
+		if (count > chunk.size() || count > depCount - supplied)
+			return fail("The source supplied more than the " + std::to_string(depCount)
+				+ " dependent values the independent data needs.");
+		supplied += count;
+		const LookupStorage values(chunk.data(), count, type);
+		const unsigned char* bytes = static_cast<const unsigned char*>(values.Data());
+		const size_t byteCount = count * valueBytes;
+		stream.write(reinterpret_cast<const char*>(bytes), byteCount);
+		size_t used = 0;
+		if (tailBytes > 0) {
+			used = std::min(sizeof(tail) - tailBytes, byteCount);
+			std::memcpy(tail + tailBytes, bytes, used);
+			tailBytes += used;
+			if (tailBytes == sizeof(tail)) {
+				checksum = file::Checksum(tail, sizeof(tail), checksum);
+				tailBytes = 0;
+			}
+		}
+		const size_t wordBytes = (byteCount - used) / sizeof(uint64_t) * sizeof(uint64_t);
+		checksum = file::Checksum(bytes + used, wordBytes, checksum);
+		used += wordBytes;
+		std::memcpy(tail + tailBytes, bytes + used, byteCount - used);
+		tailBytes += byteCount - used;
+		if (!stream)
+			return fail("Unable to write " + aPath + ".");
+	}
+	if (supplied != depCount)
+		return fail("The source supplied " + std::to_string(supplied) + " of the "
+			+ std::to_string(depCount) + " dependent values the independent data needs.");
+	checksum = file::Checksum(tail, tailBytes, checksum);
+	const size_t depWordBytes = (depDataBytes + 7) / 8 * 8;
+	header.checksum = file::Checksum(nullptr,
+		static_cast<size_t>(header.depBytes) - depWordBytes, checksum);
+
+	const char zeros[file::kAlignment] = {};
+	for (size_t padding = static_cast<size_t>(header.depBytes) - depDataBytes; padding > 0;) {
+		const size_t count = std::min(padding, sizeof(zeros));
+		stream.write(zeros, count);
+		padding -= count;
+	}
+	stream.seekp(0);
+	stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	stream.close();
+	if (!stream)
+		return fail("Unable to write " + aPath + ".");
+	string errMsg;
+	if (!LoadBinary(aPath, aPages, &errMsg))
+		return fail(errMsg);
+	return true;
+}
+
+bool LookupTableND::VerifyBinary(const string& aPath,
+	string* outErrMsg)
+{
+	string errMsg;
+	const std::shared_ptr<file::MappedFile> mapped = file::MappedFile::Open(aPath, false, &errMsg);
+	file::Header header;
+	if (mapped && ReadHeader(*mapped, &header, &errMsg)
+		&& FileChecksum(*mapped, header) != header.checksum) {
+		errMsg = "The file's checksum does not match its contents.";
+	}
+	if (!errMsg.empty() && outErrMsg) {
+		*outErrMsg = errMsg;
+	}
+	return errMsg.empty();
+}
+// ==== End Section: Binary Files (Public) ==== //
+
+
+
+
 // ==== Begin Section: Lookup Methods (Public) ==== //
 size_t LookupTableND::LookupIndexAt(const std::vector<size_t>& aInputs) const
 {
-	if (!_valid)
-		throw std::exception("Unable to operate on invalid table.");
-	if (aInputs.size() != _indepData.size())
-		throw std::invalid_argument("Must provide one input per independent variable.");
-	size_t idx = 0, prod = 1, tmpSize;
-	for (size_t i = 0; i < aInputs.size(); i++) {
-		tmpSize = _indepData.at(i).size();
-		if (aInputs.at(i) >= tmpSize)
-			throw std::invalid_argument("Input " + std::to_string(i) + " of value " 
-				+ std::to_string(aInputs.at(i)) + " out of bounds[0, " 
-				+ std::to_string(tmpSize-1) + "].");
-		idx += aInputs.at(i) * prod;
-		prod *= tmpSize;
-	}
-	// Index calculation follows the pattern: i + j*ni + k*nj*ni + l*nk*nj*ni + ...
-	if (idx >= _depData.size()) // double check just in case, but shouldn't ever happen
-		throw std::exception("Calculated index out of bounds.");
+	size_t idx, dim = 0;
+	const ErrorCode error = FindIndexAt(aInputs.data(), aInputs.size(), &idx, &dim);
+	if (error != ErrorCode::None)
+		ThrowError(error, aInputs.data(), dim);
 	return idx;
 }
 
@@ -139,31 +784,30 @@ bool LookupTableND::QueryIndexAt(const vector<size_t>& aInputs,
 {
 	if(nullptr == outIndex || nullptr == outErrMsg)
 		return false;
-	try {
-		*outIndex = LookupIndexAt(aInputs);
-	}
-	catch(std::exception& e) {
-		*outErrMsg = e.what();
+	size_t dim = 0;
+	const ErrorCode error = FindIndexAt(aInputs.data(), aInputs.size(), outIndex, &dim);
+	if (error != ErrorCode::None) {
+		*outErrMsg = ErrorMessage(error, aInputs.data(), dim);
 		return false;
 	}
 	return true;
 }
 Result<size_t> LookupTableND::QueryIndexAt(const vector<size_t>& aInputs) const
 {
-	try {
-		return Result<size_t>(LookupIndexAt(aInputs));
-	}
-	catch(std::exception& e) {
-		return e.what();
-	}
+	size_t idx;
+	const ErrorCode error = FindIndexAt(aInputs.data(), aInputs.size(), &idx, nullptr);
+	return (error == ErrorCode::None) ? Result<size_t>(idx) : Result<size_t>(error);
 }
 
 
 double LookupTableND::LookupByIndices(const vector<size_t>& aIndexInputs) const
 {
-	if (!_valid)
-		throw std::exception("Unable to operate on invalid table.");
-	return _depData.at(LookupIndexAt(aIndexInputs));
+	double value;
+	size_t dim = 0;
+	const ErrorCode error = FindByIndices(aIndexInputs.data(), aIndexInputs.size(), &value, &dim);
+	if (error != ErrorCode::None)
+		ThrowError(error, aIndexInputs.data(), dim);
+	return value;
 }
 bool LookupTableND::QueryByIndices(const vector<size_t>& aIndexInputs,
 	double* outValue,
@@ -171,71 +815,29 @@ bool LookupTableND::QueryByIndices(const vector<size_t>& aIndexInputs,
 {
 	if(nullptr == outValue || nullptr == outErrMsg)
 		return false;
-	try {
-		*outValue = LookupByIndices(aIndexInputs);
-	}
-	catch(std::exception& e) {
-		*outErrMsg = e.what();
+	size_t dim = 0;
+	const ErrorCode error = FindByIndices(aIndexInputs.data(), aIndexInputs.size(), outValue, &dim);
+	if (error != ErrorCode::None) {
+		*outErrMsg = ErrorMessage(error, aIndexInputs.data(), dim);
 		return false;
 	}
 	return true;
 }
 Result<double> LookupTableND::QueryByIndices(const vector<size_t>& aIndexInputs) const
 {
-	try {
-		return Result<double>(LookupByIndices(aIndexInputs));
-	}
-	catch(std::exception& e) {
-		return e.what();
-	}
+	double value;
+	const ErrorCode error = FindByIndices(aIndexInputs.data(), aIndexInputs.size(), &value, nullptr);
+	return (error == ErrorCode::None) ? Result<double>(value) : Result<double>(error);
 }
 
 
 double LookupTableND::LookupByValues(const vector<double>& aValueInputs) const
 {
-	if (!_valid)
-		throw std::exception("Unable to operate on invalid table.");
-
-	const size_t kInSize = _indepData.size(); // shorthand
-	vector<size_t> lowIdxs = vector<size_t>(kInSize);
-	vector<double> prcPrgs = vector<double>(kInSize);
-	size_t comboCount = 1; // number of value combinations required for interpolation later
-	for (size_t i = 0; i < kInSize; i++) {
-		GetPositionInfo(i, aValueInputs.at(i), &lowIdxs.at(i), &prcPrgs.at(i));
-		comboCount <<= 1; // number of combinations increases by power of two per input
-	}
-
-	vector<size_t> inps = vector<size_t>(lowIdxs);	  // inputs for each interpolation
-	vector<bool> bits = vector<bool>(kInSize, false); // used to modify inps programatically
-	vector<double> vals = vector<double>(comboCount); // will hold all interpolated values
-	for (size_t i = 0; i < comboCount; i++) {
-		vals.at(i) = LookupByIndices(inps);
-
-		// Vary inputs programmatically, following a binary counter flipping between the low
-		//	index value found above, and the index immediately following that one
-		// e.g. for 3 inputs: low,low,low; low,low,low+1; low,low+1,low; low,low+1,low+1; ...
-		bool flipped = false;
-		for (int k = kInSize - 1; k >= 0; k--) {
-			if (!flipped) {
-				bits.at(k) = !bits.at(k);
-				flipped = bits.at(k);
-			}
-			inps.at(k) = lowIdxs.at(k) + static_cast<size_t>(bits.at(k));
-		}
-	}
-
-	// Work down through the inputs above, interpolating their results together
-	for (size_t i = 0; i < kInSize; i++) {
-		for (size_t j = 1; j < comboCount; j += 2) {
-			vals.at(j / 2) = utils::Lerp(vals.at(j - 1), vals.at(j),
-										 prcPrgs.at(prcPrgs.size() - i - 1));
-		}
-		comboCount >>= 1;
-		// This process interpolates all combinations of intermediate interpoloations of any
-		// number of dimensions by condensing the vals vector from back to front until the 
-		// final interpolated value is calculated and stored at vals[0]
-	}
-	return vals.front();
+	double value;
+	const ErrorCode error = FindByValues(aValueInputs.data(), aValueInputs.size(), nullptr, &value);
+	if (error != ErrorCode::None)
+		ThrowError(error, nullptr, 0);
+	return value;
 }
 bool LookupTableND::QueryByValues(const vector<double>& aValueInputs,
 	double* outValue,
@@ -243,84 +845,713 @@ bool LookupTableND::QueryByValues(const vector<double>& aValueInputs,
 {
 	if (nullptr == outValue || nullptr == outErrMsg)
 		return false;
-	try {
-		*outValue = LookupByValues(aValueInputs);
-	}
-	catch(std::exception& e) {
-		*outErrMsg = e.what();
+	const ErrorCode error = FindByValues(aValueInputs.data(), aValueInputs.size(), nullptr, outValue);
+	if (error != ErrorCode::None) {
+		*outErrMsg = ErrorCodeMessage(error);
 		return false;
 	}
 	return true;
 }
 Result<double> LookupTableND::QueryByValues(const vector<double>& aValueInputs) const
 {
-	try {
-		return Result<double>(LookupByValues(aValueInputs));
-	}
-	catch(std::exception& e) {
-		return e.what();
+	double value;
+	const ErrorCode error = FindByValues(aValueInputs.data(), aValueInputs.size(), nullptr, &value);
+	return (error == ErrorCode::None) ? Result<double>(value) : Result<double>(error);
+}
+
+double LookupTableND::LookupByValues(const vector<double>& aValueInputs,
+	LookupHint* ioHint) const
+{
+	static_assert(LookupHint::kMaxDimensions == kMaxFastDimensions,
+		"Hints must cover every dimension of the fast path.");
+	double value;
+	const ErrorCode error = (_valid && nullptr == ioHint) ? ErrorCode::NullPointer
+		: FindByValues(aValueInputs.data(), aValueInputs.size(), (ioHint ? ioHint->segments : nullptr), &value);
+	if (error != ErrorCode::None)
+		ThrowError(error, nullptr, 0);
+	return value;
+}
+bool LookupTableND::QueryByValues(const vector<double>& aValueInputs,
+	LookupHint* ioHint,
+	double* outValue,
+	string* outErrMsg) const
+{
+	if (nullptr == outValue || nullptr == outErrMsg)
+		return false;
+	const ErrorCode error = (_valid && nullptr == ioHint) ? ErrorCode::NullPointer
+		: FindByValues(aValueInputs.data(), aValueInputs.size(), (ioHint ? ioHint->segments : nullptr), outValue);
+	if (error != ErrorCode::None) {
+		*outErrMsg = ErrorCodeMessage(error);
+		return false;
 	}
+	return true;
+}
+Result<double> LookupTableND::QueryByValues(const vector<double>& aValueInputs,
+	LookupHint* ioHint) const
+{
+	double value;
+	const ErrorCode error = (_valid && nullptr == ioHint) ? ErrorCode::NullPointer
+		: FindByValues(aValueInputs.data(), aValueInputs.size(), (ioHint ? ioHint->segments : nullptr), &value);
+	return (error == ErrorCode::None) ? Result<double>(value) : Result<double>(error);
 }
 // ==== End Section: Lookup Methods (Public) ==== //
 
 
 
-// ==== Begin Section: Metadata (Public) ==== //
-bool LookupTableND::Valid() const 
-{ 
-	return _valid; 
-};
-size_t LookupTableND::Dimensions() const 
-{ 
-	return _indepData.size(); 
+
+// ==== Begin Section: Gradient Methods (Public) ==== //
+double LookupTableND::LookupValueAndGradient(const vector<double>& aValueInputs,
+	double* outGradient) const
+{
+	double value;
+	const ErrorCode error = FindValueAndGradient(aValueInputs.data(), aValueInputs.size(),
+		&value, outGradient);
+	if (error != ErrorCode::None)
+		ThrowError(error, nullptr, 0);
+	return value;
 }
-size_t LookupTableND::DepDataSize() const 
+bool LookupTableND::QueryValueAndGradient(const vector<double>& aValueInputs,
+	double* outValue,
+	double* outGradient,
+	string* outErrMsg) const
+{
+	if (nullptr == outValue || nullptr == outErrMsg)
+		return false;
+	const ErrorCode error = FindValueAndGradient(aValueInputs.data(), aValueInputs.size(),
+		outValue, outGradient);
+	if (error != ErrorCode::None) {
+		*outErrMsg = ErrorCodeMessage(error);
+		return false;
+	}
+	return true;
+}
+Result<double> LookupTableND::QueryValueAndGradient(const vector<double>& aValueInputs,
+	double* outGradient) const
+{
+	double value;
+	const ErrorCode error = FindValueAndGradient(aValueInputs.data(), aValueInputs.size(),
+		&value, outGradient);
+	return (error == ErrorCode::None) ? Result<double>(value) : Result<double>(error);
+}
+// ==== End Section: Gradient Methods (Public) ==== //
+
+
+
+
+// ==== Begin Section: Inverse Lookup Methods (Public) ==== //
+double LookupTableND::LookupInverse(const size_t& aDimension,
+	const vector<double>& aInputs,
+	const double& aTarget) const
+{
+	LookupSlice slice;
+	return LookupInverse(aDimension, aInputs, aTarget, &slice);
+}
+bool LookupTableND::QueryInverse(const size_t& aDimension,
+	const vector<double>& aInputs,
+	const double& aTarget,
+	double* outValue,
+	string* outErrMsg) const
+{
+	LookupSlice slice;
+	return QueryInverse(aDimension, aInputs, aTarget, &slice, outValue, outErrMsg);
+}
+Result<double> LookupTableND::QueryInverse(const size_t& aDimension,
+	const vector<double>& aInputs,
+	const double& aTarget) const
+{
+	LookupSlice slice;
+	return QueryInverse(aDimension, aInputs, aTarget, &slice);
+}
+
+double LookupTableND::LookupInverse(const size_t& aDimension,
+	const vector<double>& aInputs,
+	const double& aTarget,
+	LookupSlice* ioSlice) const
+{
+	double value;
+	const ErrorCode error = FindInverse(aDimension, aInputs.data(), aInputs.size(), aTarget,
+		ioSlice, &value);
+	if (error != ErrorCode::None)
+		ThrowError(error, nullptr, 0);
+	return value;
+}
+bool LookupTableND::QueryInverse(const size_t& aDimension,
+	const vector<double>& aInputs,
+	const double& aTarget,
+	LookupSlice* ioSlice,
+	double* outValue,
+	string* outErrMsg) const
+{
+	if (nullptr == outValue || nullptr == outErrMsg)
+		return false;
+	const ErrorCode error = FindInverse(aDimension, aInputs.data(), aInputs.size(), aTarget,
+		ioSlice, outValue);
+	if (error != ErrorCode::None) {
+		*outErrMsg = ErrorCodeMessage(error);
+		return false;
+	}
+	return true;
+}
+Result<double> LookupTableND::QueryInverse(const size_t& aDimension,
+	const vector<double>& aInputs,
+	const double& aTarget,
+	LookupSlice* ioSlice) const
+{
+	double value;
+	const ErrorCode error = FindInverse(aDimension, aInputs.data(), aInputs.size(), aTarget,
+		ioSlice, &value);
+	return (error == ErrorCode::None) ? Result<double>(value) : Result<double>(error);
+}
+
+bool LookupTableND::QuerySlice(const size_t& aDimension,
+	const vector<double>& aInputs,
+	LookupSlice* ioSlice,
+	string* outErrMsg) const
+{
+	if (nullptr == outErrMsg)
+		return false;
+	const ErrorCode error = FindSlice(aDimension, aInputs.data(), aInputs.size(), ioSlice);
+	if (error != ErrorCode::None) {
+		*outErrMsg = ErrorCodeMessage(error);
+		return false;
+	}
+	return true;
+}
+// ==== End Section: Inverse Lookup Methods (Public) ==== //
+
+
+
+
+// ==== Begin Section: Partial Evaluation Methods (Public) ==== //
+bool LookupTableND::QueryPartial(const vector<size_t>& aFreeDimensions,
+	const vector<double>& aInputs,
+	LookupPartial* ioPartial,
+	string* outErrMsg) const
+{
+	if (nullptr == outErrMsg)
+		return false;
+	const ErrorCode error = FindPartial(aFreeDimensions, aInputs.data(), aInputs.size(), ioPartial);
+	if (error != ErrorCode::None) {
+		*outErrMsg = ErrorCodeMessage(error);
+		return false;
+	}
+	return true;
+}
+// ==== End Section: Partial Evaluation Methods (Public) ==== //
+
+
+
+
+// ==== Begin Section: Batch Lookup Methods (Public) ==== //
+size_t LookupTableND::QueryBatchByValues(const vector<const double*>& aDimValues,
+	const size_t& aCount,
+	double* outValues,
+	uint64_t* outValidMask) const
+{
+	if (!PrepareBatch(aDimValues, aCount, outValues, outValidMask))
+		return 0;
+	ZJLD_LOOKUP_TRACE_ONLY(if (_trace) _trace->RecordBatch(aDimValues.data(), aCount));
+	const size_t validCount = EvaluateBatch(aDimValues.data(), 0, aCount, outValues, outValidMask);
+	CountBatch(aCount, validCount);
+	return validCount;
+}
+
+size_t LookupTableND::QueryBatchByValuesParallel(const vector<const double*>& aDimValues,
+	const size_t& aCount,
+	double* outValues,
+	uint64_t* outValidMask,
+	const BatchExecutor& aExecutor) const
+{
+	if (!PrepareBatch(aDimValues, aCount, outValues, outValidMask))
+		return 0;
+	ZJLD_LOOKUP_TRACE_ONLY(if (_trace) _trace->RecordBatch(aDimValues.data(), aCount));
+
+	// Each chunk counts its own valid points, summed once all have finished
+	const size_t chunkCount = (aCount + kBatchChunkSize - 1) / kBatchChunkSize;
+	vector<size_t> validCounts(chunkCount, 0);
+	const double* const* dimValues = aDimValues.data();
+	const std::function<void(size_t)> task = [&](size_t aChunk) {
+		const size_t begin = aChunk * kBatchChunkSize;
+		const size_t end = std::min(begin + kBatchChunkSize, aCount);
+		validCounts[aChunk] = EvaluateBatch(dimValues, begin, end, outValues, outValidMask);
+	};
+	if (aExecutor) {
+		aExecutor(chunkCount, task);
+	}
+	else {
+		ThreadPool::Default().Run(chunkCount, task);
+	}
+	size_t validCount = 0;
+	for (size_t count : validCounts) {
+		validCount += count;
+	}
+	CountBatch(aCount, validCount);
+	return validCount;
+}
+// ==== End Section: Batch Lookup Methods (Public) ==== //
+
+
+
+// ==== Begin Section: Tracing (Public) ==== //
+void LookupTableND::SetTraceRecorder(LookupTraceRecorder* aRecorder)
+{
+	_trace = aRecorder;
+}
+LookupTraceRecorder* LookupTableND::TraceRecorder() const
+{
+	return _trace;
+}
+// ==== End Section: Tracing (Public) ==== //
+
+
+
+// ==== Begin Section: Metadata (Public) ==== //
+bool LookupTableND::Valid() const 
+{ 
+	return _valid; 
+};
+size_t LookupTableND::Dimensions() const 
+{ 
+	return _indepData.size(); 
+}
+size_t LookupTableND::DepDataSize() const 
 { 
-	return _depData.size(); 
+	return _indepData.empty() ? 0 : _strides.back() * _indepData.back().size(); 
 };
+size_t LookupTableND::DepDataBytes() const
+{
+	return _depData.ByteSize() + _tiles.size() * sizeof(TileBlock)
+		+ (_reader ? _reader->MemoryBytes() : 0);
+}
+bool LookupTableND::DepDataIsView() const
+{
+	return _depData.IsView();
+}
+size_t LookupTableND::CellDataSize() const
+{
+	return _cellData.size();
+}
+size_t LookupTableND::DerivativeDataSize() const
+{
+	return _derivData.size();
+}
+size_t LookupTableND::ConstantTileCount() const
+{
+	return static_cast<size_t>(std::count_if(_tiles.begin(), _tiles.end(),
+		[](const TileBlock& aTile) { return aTile.mask == 0; }));
+}
+bool LookupTableND::Paged() const
+{
+	return dynamic_cast<const PageCache*>(_reader.get()) != nullptr;
+}
+size_t LookupTableND::FilledTileCount() const
+{
+	const LazyTiles* lazy = dynamic_cast<const LazyTiles*>(_reader.get());
+	return lazy ? lazy->FilledTiles() : 0;
+}
+PageStats LookupTableND::PagingStats() const
+{
+	const PageCache* pages = dynamic_cast<const PageCache*>(_reader.get());
+	return pages ? pages->Stats() : PageStats();
+}
 size_t LookupTableND::IndepDataSize(const size_t& aDimension) const 
 {
 	if (aDimension >= Dimensions())
 		throw std::invalid_argument("Invalid dimension provided: " + std::to_string(aDimension));
 	return _indepData.at(aDimension).size();
 }
+const LookupAxis& LookupTableND::Axis(const size_t& aDimension) const
+{
+	if (aDimension >= Dimensions())
+		throw std::invalid_argument("Invalid dimension provided: " + std::to_string(aDimension));
+	return _axes.at(aDimension);
+}
+uint64_t LookupTableND::Generation() const
+{
+	return _generation;
+}
 // ==== End Section: Metadata (Public) ==== //
 
 
 
+// ==== Begin Section: Batch Helpers (Protected) ==== //
+bool LookupTableND::PrepareBatch(const vector<const double*>& aDimValues,
+	const size_t& aCount,
+	double* outValues,
+	uint64_t* outValidMask) const
+{
+	if (nullptr == outValues || nullptr == outValidMask)
+		return false;
+	std::fill(outValidMask, outValidMask + utils::BatchMaskWords(aCount), 0);
+
+	bool batchValid = _valid && aDimValues.size() == _indepData.size();
+	for (size_t i = 0; batchValid && i < aDimValues.size(); i++) {
+		batchValid = (nullptr != aDimValues[i]);
+	}
+	if (!batchValid) {
+		std::fill(outValues, outValues + aCount, std::numeric_limits<double>::quiet_NaN());
+		return false;
+	}
+	return true;
+}
+void LookupTableND::CountBatch(const size_t& aCount,
+	const size_t& aValidCount) const
+{
+#if defined(ZJLD_LOOKUP_STATS)
+	stats::Add(stats::Counter::Queries, aCount);
+	stats::Add(stats::Counter::OutOfBounds, aCount - aValidCount);
+	stats::Add(stats::Counter::Searches, aCount * _indepData.size());
+	stats::Add(stats::Counter::SearchSteps, aCount * _searchDepth);
+#else
+	(void)aCount; (void)aValidCount;
+#endif
+}
+// ==== End Section: Batch Helpers (Protected) ==== //
+
+
+
+
+// ==== Begin Section: Lookup Helpers (Protected) ==== //
+ErrorCode LookupTableND::FindIndexAt(const size_t* aInputs,
+	const size_t& aCount,
+	size_t* outIndex,
+	size_t* outDimension) const
+{
+	if (!_valid)
+		return ErrorCode::InvalidTable;
+	if (aCount != _indepData.size())
+		return ErrorCode::WrongInputCount;
+	// Index calculation follows the pattern: i + j*ni + k*nj*ni + l*nk*nj*ni + ...
+	size_t idx = 0;
+	for (size_t i = 0; i < aCount; i++) {
+		if (aInputs[i] >= _indepData[i].size()) {
+			if (outDimension)
+				*outDimension = i;
+			return ErrorCode::IndexOutOfBounds;
+		}
+		idx += aInputs[i] * _strides[i];
+	}
+	*outIndex = idx;
+	return ErrorCode::None;
+}
+
+ErrorCode LookupTableND::FindByIndices(const size_t* aInputs,
+	const size_t& aCount,
+	double* outValue,
+	size_t* outDimension) const
+{
+	ZJLD_LOOKUP_STATS_ONLY(stats::QueryTimer timer);
+	size_t idx;
+	const ErrorCode error = FindIndexAt(aInputs, aCount, &idx, outDimension);
+	if (error == ErrorCode::None)
+		*outValue = StoredValue(_dimOffsets.empty() ? idx : StorageIndex(aInputs));
+	ZJLD_LOOKUP_STATS_ONLY(if (error == ErrorCode::IndexOutOfBounds) timer.OutOfBounds());
+	return error;
+}
+
+ErrorCode LookupTableND::FindByValues(const double* aValueInputs,
+	const size_t& aCount,
+	size_t* ioSegments,
+	double* outValue) const
+{
+	ZJLD_LOOKUP_STATS_ONLY(stats::QueryTimer timer);
+	if (!_valid)
+		return ErrorCode::InvalidTable;
+	const size_t kInSize = _indepData.size(); // shorthand
+	if (aCount != kInSize)
+		return ErrorCode::WrongInputCount;
+	ZJLD_LOOKUP_TRACE_ONLY(if (_trace) _trace->Record(aValueInputs));
+	if (kInSize > kMaxFastDimensions) {
+		if (FindByValuesGeneric(aValueInputs, outValue)) {
+			ZJLD_LOOKUP_STATS_ONLY(timer.Searched(kInSize, _searchDepth));
+			return ErrorCode::None;
+		}
+		ZJLD_LOOKUP_STATS_ONLY(timer.OutOfBounds());
+		return ErrorCode::ValueOutOfBounds;
+	}
+
+	// Fixed-size storage keeps the common case free of heap allocations
+	size_t lowIdxs[kMaxFastDimensions];
+	double prcPrgs[kMaxFastDimensions];
+	for (size_t i = 0; i < kInSize; i++) {
+		if (!FindPositionInfo(i, aValueInputs[i], ioSegments ? &ioSegments[i] : nullptr,
+			&lowIdxs[i], &prcPrgs[i])) {
+			ZJLD_LOOKUP_STATS_ONLY(timer.OutOfBounds());
+			return ErrorCode::ValueOutOfBounds;
+		}
+	}
+	// Unhinted searches always take the same steps, while hinted ones count their own
+	ZJLD_LOOKUP_STATS_ONLY(timer.Searched(kInSize, ioSegments ? 0 : _searchDepth));
+	*outValue = InterpolateCell(lowIdxs, prcPrgs);
+	return ErrorCode::None;
+}
+
+ErrorCode LookupTableND::FindValueAndGradient(const double* aValueInputs,
+	const size_t& aCount,
+	double* outValue,
+	double* outGradient) const
+{
+	ZJLD_LOOKUP_STATS_ONLY(stats::QueryTimer timer);
+	if (!_valid)
+		return ErrorCode::InvalidTable;
+	const size_t kInSize = _indepData.size(); // shorthand
+	if (aCount != kInSize)
+		return ErrorCode::WrongInputCount;
+	if (nullptr == outGradient)
+		return ErrorCode::NullPointer;
+	if (!_derivData.empty())
+		return ErrorCode::Unsupported;
+
+	Scratch<size_t, kMaxFastDimensions> lowIdxs(kInSize);
+	Scratch<double, kMaxFastDimensions> prcPrgs(kInSize);
+	for (size_t i = 0; i < kInSize; i++) {
+		if (!FindPositionInfo(i, aValueInputs[i], &lowIdxs.Data()[i], &prcPrgs.Data()[i])) {
+			ZJLD_LOOKUP_STATS_ONLY(timer.OutOfBounds());
+			return ErrorCode::ValueOutOfBounds;
+		}
+	}
+	ZJLD_LOOKUP_STATS_ONLY(timer.Searched(kInSize, _searchDepth));
+	*outValue = InterpolateCellGradient(lowIdxs.Data(), prcPrgs.Data(), outGradient);
+
+	// Each percent progress runs from 0 to 1 across its segment, so scale its partial by
+	// the inverse of the segment's width (unless the input was clamped onto the bounds,
+	// where the value no longer changes with it)
+	for (size_t i = 0; i < kInSize; i++) {
+		const TableData& data = _indepData[i]; // shorthand
+		const size_t low = lowIdxs.Data()[i];
+		const bool clamped = (_axes[i].Bounds() == LookupAxis::BoundPolicy::Clamp)
+			&& (aValueInputs[i] < data.front() || aValueInputs[i] > data.back());
+		outGradient[i] = clamped ? 0.0 : outGradient[i] / (data[low + 1] - data[low]);
+	}
+	return ErrorCode::None;
+}
+
+ErrorCode LookupTableND::FindSlice(const size_t& aDimension,
+	const double* aInputs,
+	const size_t& aCount,
+	LookupSlice* ioSlice) const
+{
+	if (!_valid)
+		return ErrorCode::InvalidTable;
+	const size_t kInSize = _indepData.size(); // shorthand
+	if (aCount != kInSize)
+		return ErrorCode::WrongInputCount;
+	if (nullptr == ioSlice)
+		return ErrorCode::NullPointer;
+	if (aDimension >= kInSize)
+		return ErrorCode::InvalidDimension;
+	if (!_derivData.empty())
+		return ErrorCode::Unsupported; // (a slice is only exact between linear breakpoints)
+	if (ioSlice->Matches(this, aDimension, aInputs, aCount))
+		return ErrorCode::None;
+
+	// Evaluate the table at every breakpoint of aDimension, finding the positions of the
+	// other inputs only once (those of the breakpoints themselves are exact)
+	const TableData& breakpoints = _indepData[aDimension]; // shorthand
+	const size_t size = breakpoints.size();
+	ioSlice->Reset();
+	ioSlice->_values.resize(size);
+	if (kInSize > kMaxFastDimensions) {
+		vector<double> inputs(aInputs, aInputs + aCount);
+		for (size_t k = 0; k < size; k++) {
+			inputs[aDimension] = breakpoints[k];
+			if (!FindByValuesGeneric(inputs.data(), &ioSlice->_values[k]))
+				return ErrorCode::ValueOutOfBounds;
+		}
+	}
+	else {
+		size_t lowIdxs[kMaxFastDimensions];
+		double prcPrgs[kMaxFastDimensions];
+		for (size_t i = 0; i < kInSize; i++) {
+			if (i != aDimension && !FindPositionInfo(i, aInputs[i], &lowIdxs[i], &prcPrgs[i]))
+				return ErrorCode::ValueOutOfBounds;
+		}
+		for (size_t k = 0; k < size; k++) {
+			lowIdxs[aDimension] = std::min(k, size - 2); // as PositionFromApproxPos does
+			prcPrgs[aDimension] = (k == lowIdxs[aDimension]) ? 0.0 : 1.0;
+			ioSlice->_values[k] = InterpolateCell(lowIdxs, prcPrgs);
+		}
+	}
+	ioSlice->_table = this;
+	ioSlice->_generation = _generation;
+	ioSlice->_dimension = aDimension;
+	ioSlice->_inputs.assign(aInputs, aInputs + aCount);
+	ioSlice->_breakpoints = breakpoints;
+	ioSlice->FindOrder();
+	return ErrorCode::None;
+}
+
+ErrorCode LookupTableND::FindInverse(const size_t& aDimension,
+	const double* aInputs,
+	const size_t& aCount,
+	const double& aTarget,
+	LookupSlice* ioSlice,
+	double* outValue) const
+{
+	const ErrorCode error = FindSlice(aDimension, aInputs, aCount, ioSlice);
+	if (error != ErrorCode::None)
+		return error;
+	return ioSlice->FindFirstRoot(aTarget, outValue) ? ErrorCode::None : ErrorCode::NoSolution;
+}
+
+ErrorCode LookupTableND::FindPartial(const vector<size_t>& aFreeDimensions,
+	const double* aInputs,
+	const size_t& aCount,
+	LookupPartial* ioPartial) const
+{
+	if (!_valid)
+		return ErrorCode::InvalidTable;
+	const size_t kInSize = _indepData.size(); // shorthand
+	if (aCount != kInSize)
+		return ErrorCode::WrongInputCount;
+	if (nullptr == ioPartial)
+		return ErrorCode::NullPointer;
+	if (aFreeDimensions.empty() || aFreeDimensions.back() >= kInSize)
+		return ErrorCode::InvalidDimension;
+	for (size_t f = 1; f < aFreeDimensions.size(); f++) {
+		if (aFreeDimensions[f - 1] >= aFreeDimensions[f])
+			return ErrorCode::InvalidDimension;
+	}
+	if (!_derivData.empty())
+		return ErrorCode::Unsupported;
+	if (ioPartial->Matches(this, aFreeDimensions, aInputs, aCount))
+		return ErrorCode::None;
+
+	// Find the positions of the bound inputs once, noting which dimensions they are
+	const size_t kFreeSize = aFreeDimensions.size(); // shorthand
+	const size_t kBoundSize = kInSize - kFreeSize;   // shorthand
+	Scratch<size_t, kMaxFastDimensions> boundScratch(kBoundSize);
+	Scratch<size_t, kMaxFastDimensions> lowScratch(kBoundSize);
+	Scratch<double, kMaxFastDimensions> prcScratch(kBoundSize);
+	Scratch<size_t, kMaxFastDimensions> indexScratch(kInSize);
+	size_t* boundDims = boundScratch.Data();
+	size_t* lowIdxs = lowScratch.Data();
+	double* prcPrgs = prcScratch.Data();
+	size_t* indices = indexScratch.Data();
+	ioPartial->Reset();
+	for (size_t i = 0, f = 0, b = 0; i < kInSize; i++) {
+		indices[i] = 0;
+		if (f < kFreeSize && aFreeDimensions[f] == i) {
+			f++;
+			continue;
+		}
+		if (!FindPositionInfo(i, aInputs[i], &lowIdxs[b], &prcPrgs[b]))
+			return ErrorCode::ValueOutOfBounds;
+		boundDims[b++] = i;
+	}
+
+	// Interpolate the bound dimensions at every breakpoint of the free ones, stepping
+	// through those as a counter with the first free dimension fastest.  The corners of
+	// the bound dimensions follow the table's order (the last bound dimension as the
+	// least significant bit), so each value is interpolated as InterpolateCell would.
+	size_t valueCount = 1;
+	for (const size_t dim : aFreeDimensions) {
+		valueCount *= _indepData[dim].size();
+	}
+	const size_t comboCount = static_cast<size_t>(1) << kBoundSize;
+	Scratch<double, static_cast<size_t>(1) << kMaxFastDimensions> valsScratch(comboCount);
+	double* vals = valsScratch.Data();
+	TableData& values = ioPartial->_values; // shorthand
+	values.resize(valueCount);
+	for (size_t v = 0; v < valueCount; v++) {
+		for (size_t c = 0; c < comboCount; c++) {
+			for (size_t b = 0; b < kBoundSize; b++) {
+				indices[boundDims[b]] = lowIdxs[b] + ((c >> (kBoundSize - b - 1)) & 1);
+			}
+			vals[c] = StoredValue(StorageIndex(indices));
+		}
+		for (size_t i = 0, count = comboCount; i < kBoundSize; i++, count >>= 1) {
+			const double prc = prcPrgs[kBoundSize - i - 1];
+			for (size_t j = 1; j < count; j += 2) {
+				vals[j / 2] = utils::Lerp(vals[j - 1], vals[j], prc);
+			}
+		}
+		values[v] = vals[0];
+
+		for (const size_t dim : aFreeDimensions) {
+			if (++indices[dim] < _indepData[dim].size())
+				break;
+			indices[dim] = 0;
+		}
+	}
+
+	ioPartial->_table = this;
+	ioPartial->_generation = _generation;
+	ioPartial->_free = aFreeDimensions;
+	ioPartial->_inputs.assign(aInputs, aInputs + aCount);
+	size_t stride = 1;
+	for (const size_t dim : aFreeDimensions) {
+		ioPartial->_axes.push_back(_axes[dim]);
+		ioPartial->_strides.push_back(stride);
+		stride *= _indepData[dim].size();
+	}
+	return ErrorCode::None;
+}
+
+string LookupTableND::ErrorMessage(const ErrorCode& aError,
+	const size_t* aIndexInputs,
+	const size_t& aDimension) const
+{
+	if (aError == ErrorCode::IndexOutOfBounds && nullptr != aIndexInputs) {
+		return "Input " + std::to_string(aDimension) + " of value "
+			+ std::to_string(aIndexInputs[aDimension]) + " out of bounds[0, "
+			+ std::to_string(_indepData[aDimension].size() - 1) + "].";
+	}
+	return utils::ErrorCodeMessage(aError);
+}
+
+void LookupTableND::ThrowError(const ErrorCode& aError,
+	const size_t* aIndexInputs,
+	const size_t& aDimension) const
+{
+	if (aError == ErrorCode::InvalidTable)
+		throw std::runtime_error(utils::ErrorCodeMessage(aError));
+	throw std::invalid_argument(ErrorMessage(aError, aIndexInputs, aDimension));
+}
+// ==== End Section: Lookup Helpers (Protected) ==== //
+
+
+
+
 // ==== Begin Section: Position Helpers (Protected) ==== //
 void LookupTableND::GetPositionInfo(const size_t& aDimension,
 	const double& aValue,
 	size_t* outLowIdx,
 	double* outPercProgress) const
+{
+	GetPositionInfo(aDimension, aValue, nullptr, outLowIdx, outPercProgress);
+}
+
+void LookupTableND::GetPositionInfo(const size_t& aDimension,
+	const double& aValue,
+	size_t* ioSegment,
+	size_t* outLowIdx,
+	double* outPercProgress) const
 {
 	if (!_valid)
-		throw std::exception("Unable to operate on invalid table.");
+		throw std::runtime_error("Unable to operate on invalid table.");
 	if (nullptr == outLowIdx || nullptr == outPercProgress)
 		throw std::invalid_argument("Null pointer provided as input.");
 	
 	double pos;
-	GetApproxPos(aDimension, aValue, &pos);
-	
-	// Take approx position and find the index beneath it and the percent progress to the
-	// next index.  For example, pos=1.3, low=1, perc=0.3.
-	*outLowIdx = static_cast<size_t>(pos);
-	*outPercProgress = pos - static_cast<double>(*outLowIdx);
-	if (*outLowIdx > 0 && *outLowIdx == _indepData.at(aDimension).size() - 1) {
-		// If value is found at last index, reduce by one since it's the "low" value so
-		// that checking the "high" value later will not go out of bounds, and use a
-		// percent progress of 100% (1.0) to show that it's actually at the next value
-		(*outLowIdx)--;
-		*outPercProgress += 1.0; // +=1.0 instead of =1.0 to allow for extrapolation
-	}
+	GetApproxPos(aDimension, aValue, ioSegment, &pos);
+	PositionFromApproxPos(aDimension, pos, outLowIdx, outPercProgress);
+}
+
+void LookupTableND::GetApproxPos(const size_t& aDimension,
+	const double& aValue,
+	double* outApproxPosition) const
+{
+	GetApproxPos(aDimension, aValue, nullptr, outApproxPosition);
 }
 
 void LookupTableND::GetApproxPos(const size_t& aDimension,
 	const double& aValue,
+	size_t* ioSegment,
 	double* outApproxPosition) const
 {
 	if (!_valid)
-		throw std::exception("Unable to operate on invalid table.");
+		throw std::runtime_error("Unable to operate on invalid table.");
 	if (nullptr == outApproxPosition)
 		throw std::invalid_argument("Null pointer provided as input.");
 	if (aDimension >= _indepData.size())
@@ -328,48 +1559,834 @@ void LookupTableND::GetApproxPos(const size_t& aDimension,
 
 	const TableData& data = _indepData.at(aDimension);
 	if (data.empty())
-		throw std::exception("Data vector is empty.");
-	if (aValue < data.front() || aValue > data.back())
-		throw std::invalid_argument("Value given is outside of data bounds. (Extrapolation not supported.)");
-
-	// Use a binary search to find the value searched for
-	// - NOTE: this is why the independent data must be monotonically increasing
-	size_t l = 0, r = data.size(); // left/right ends
-	size_t m = (l + r) / 2;        // mid-point
-	while (l < m && m < r) {
-		if (utils::IsApproxEqual(aValue, data.at(m))) {
-			l = m;
-			r = m;
-			break; // found it
-		}
-		if (aValue < data.at(m))
-			r = m;
-		else
-			l = m;
-		m = (l + r) / 2;
-	}
-	if (l == r) // found exact match
-		*outApproxPosition = static_cast<double>(l);
-	else {      // Otherwise: interpolate
-		double perc = utils::ILerp(data.at(l), data.at(r), aValue);
-		*outApproxPosition = static_cast<double>(l) + perc;
-	}
+		throw std::runtime_error("Data vector is empty.");
+	if (!FindApproxPos(aDimension, aValue, ioSegment, outApproxPosition))
+		throw std::invalid_argument(ErrorCodeMessage(ErrorCode::ValueOutOfBounds));
 }
-// ==== End Section: Position Helpers (Protected) ==== //
 
+bool LookupTableND::FindPositionInfo(const size_t& aDimension,
+	const double& aValue,
+	size_t* outLowIdx,
+	double* outPercProgress) const
+{
+	double pos;
+	if (!FindApproxPos(aDimension, aValue, &pos))
+		return false;
+	PositionFromApproxPos(aDimension, pos, outLowIdx, outPercProgress);
+	return true;
+}
 
+bool LookupTableND::FindPositionInfo(const size_t& aDimension,
+	const double& aValue,
+	size_t* ioSegment,
+	size_t* outLowIdx,
+	double* outPercProgress) const
+{
+	double pos;
+	if (!FindApproxPos(aDimension, aValue, ioSegment, &pos))
+		return false;
+	PositionFromApproxPos(aDimension, pos, outLowIdx, outPercProgress);
+	return true;
+}
 
+bool LookupTableND::FindApproxPos(const size_t& aDimension,
+	const double& aValue,
+	double* outApproxPosition) const
+{
+	return _axes[aDimension].FindApproxPos(aValue, outApproxPosition);
+}
 
-// ==== Begin Section: Validity Helpers (Protected) ==== //
-bool LookupTableND::CheckMonotonicallyIncreasing(const TableDataSet& aFullDataSet) const
+bool LookupTableND::FindApproxPos(const size_t& aDimension,
+	const double& aValue,
+	size_t* ioSegment,
+	double* outApproxPosition) const
 {
-	for (size_t i = 0; i < aFullDataSet.size() - 1; i++) {
-		const TableData& data = aFullDataSet.at(i); // shorthand
-		for (size_t j = 1; j < data.size(); j++) {
-			if (data.at(j - 1) >= data.at(j))
-				return false;
-		}
-	}
-	return true;
+	if (nullptr == ioSegment)
+		return FindApproxPos(aDimension, aValue, outApproxPosition);
+	return _axes[aDimension].FindApproxPos(aValue, ioSegment, outApproxPosition);
 }
-// ==== End Section: Validity Helpers (Protected) ==== //
+
+void LookupTableND::PositionFromApproxPos(const size_t& aDimension,
+	const double& aApproxPosition,
+	size_t* outLowIdx,
+	double* outPercProgress) const
+{
+	// Take approx position and find the index beneath it and the percent progress to the
+	// next index.  For example, pos=1.3, low=1, perc=0.3.
+	LookupAxis::CellFromPosition(aApproxPosition, _indepData[aDimension].size(), outLowIdx,
+		outPercProgress);
+}
+// ==== End Section: Position Helpers (Protected) ==== //
+
+
+
+
+// ==== Begin Section: Construction Helpers (Protected) ==== //
+void LookupTableND::BuildStorage(const TableData& aDepData)
+{
+	BuildStorage(aDepData.data(), aDepData.size());
+}
+
+void LookupTableND::BuildStorage(TableData&& aDepData)
+{
+	if (_options.storageType == StorageType::Double && BuildDimOffsets() == aDepData.size()
+		&& _dimOffsets.empty()) {
+		_depData = LookupStorage(std::move(aDepData), StorageType::Double);
+	}
+	else {
+		BuildStorage(aDepData.data(), aDepData.size());
+	}
+}
+
+void LookupTableND::BuildStorage(const double* aDepData,
+	const size_t& aDepSize)
+{
+	const size_t storedSize = BuildDimOffsets();
+	if (_dimOffsets.empty()) {
+		_depData = LookupStorage(aDepData, aDepSize, _options.storageType);
+		return;
+	}
+	if (!_tiles.empty()) {
+		BuildTiles(aDepData, aDepSize);
+		return;
+	}
+
+	// Padding is never read, but is filled with NaN to make any mistake obvious
+	const size_t kInSize = _indepData.size(); // shorthand
+	TableData tiledData = TableData(storedSize, std::numeric_limits<double>::quiet_NaN());
+	size_t indices[kMaxFastDimensions] = {};
+	for (size_t idx = 0; idx < aDepSize; idx++) {
+		tiledData[StorageIndex(indices)] = aDepData[idx];
+		for (size_t i = 0; i < kInSize && ++indices[i] == _indepData[i].size(); i++) {
+			indices[i] = 0;
+		}
+	}
+	_depData = LookupStorage(std::move(tiledData), _options.storageType);
+}
+
+string LookupTableND::LoadLayout(const file::Header& aHeader,
+	const unsigned char* aAxes)
+{
+	if (!IsValidDimensionCount(aHeader.dimensions))
+		return "Unsupported number of dimensions (" + std::to_string(aHeader.dimensions) + ").";
+	if (aHeader.storageType > static_cast<uint32_t>(StorageType::BFloat16)
+		|| aHeader.dataLayout > static_cast<uint32_t>(TableOptions::DataLayout::Tiled))
+		return "Unsupported storage type or data layout.";
+
+	// Axes block (a multiple of 8 bytes and aligned to them, see CheckHeader)
+	const size_t kInSize = aHeader.dimensions; // shorthand
+	size_t axesLeft = static_cast<size_t>(aHeader.axesBytes) / sizeof(uint64_t);
+	if (axesLeft < kInSize)
+		return "The file's axes are truncated.";
+	axesLeft -= kInSize;
+	_indepData = TableDataSet(kInSize);
+	const unsigned char* pos = aAxes + kInSize * sizeof(uint64_t);
+	for (size_t i = 0; i < kInSize; i++) {
+		uint64_t size;
+		std::memcpy(&size, aAxes + i * sizeof(uint64_t), sizeof(size));
+		if (size == 0 || size > axesLeft)
+			return "The file's axes are truncated.";
+		_indepData[i] = TableData(static_cast<size_t>(size));
+		std::memcpy(_indepData[i].data(), pos, _indepData[i].size() * sizeof(double));
+		pos += _indepData[i].size() * sizeof(double);
+		axesLeft -= static_cast<size_t>(size);
+	}
+	for (size_t i = 0; i < kInSize; i++) {
+		if (!CheckMonotonicallyIncreasing(_indepData[i]))
+			return "The file's independent data is not monotonically increasing.";
+	}
+
+	// Dependent block, which must match the layout these axes and options would produce
+	_options.storageType = static_cast<StorageType>(aHeader.storageType);
+	_options.dataLayout = static_cast<TableOptions::DataLayout>(aHeader.dataLayout);
+	_options.tileSize = static_cast<size_t>(aHeader.tileSize);
+	size_t prod = 1;
+	for (size_t i = 0; i < kInSize; i++) {
+		if (prod > aHeader.depCount / _indepData[i].size())
+			return "The file's dependent data does not match its axes.";
+		prod *= _indepData[i].size();
+	}
+	BuildStrides();
+	const size_t valueBytes = LookupStorage::ValueBytes(_options.storageType);
+	if (BuildDimOffsets() != aHeader.depCount
+		|| aHeader.depBytes / valueBytes < aHeader.depCount + 1
+		|| (_dimOffsets.empty() && aHeader.dataLayout != static_cast<uint32_t>(TableOptions::DataLayout::Linear)))
+		return "The file's dependent data does not match its axes.";
+	return {};
+}
+
+void LookupTableND::BuildStrides()
+{
+	// Cache the step through _depData for each dimension, following the same
+	// i + j*ni + k*nj*ni + ... pattern used by LookupIndexAt
+	_strides = vector<size_t>(_indepData.size());
+	size_t prod = 1;
+	for (size_t i = 0; i < _indepData.size(); i++) {
+		_strides[i] = prod;
+		prod *= _indepData[i].size();
+	}
+}
+
+size_t LookupTableND::BuildDimOffsets()
+{
+	const size_t kInSize = _indepData.size(); // shorthand
+	const size_t tile = _options.tileSize;
+	_dimOffsets = {};
+	_tiles = {};
+	if (_options.dataLayout == TableOptions::DataLayout::Linear || tile < 2
+		|| kInSize > kMaxFastDimensions) {
+		return DepDataSize();
+	}
+
+	// Each tile is stored contiguously in the same order as a Linear table (dimension 0
+	// fastest), and so are the tiles themselves.  The position of a value is then a sum of
+	// independent terms for each dimension, (i % tile) * tileStride + (i / tile) * blockStride,
+	// which are precomputed for every index along every dimension.  When Compressed, the
+	// tile number is instead kept above the position within the tile (see TileBlock),
+	// unless tiles are too large for it (then staying Tiled).
+	size_t tileStride = 1, tileCount = 1;
+	for (size_t i = 0; i < kInSize; i++) {
+		tileStride *= tile;
+	}
+	const size_t tileVolume = tileStride;
+	const bool compressed = (_options.dataLayout == TableOptions::DataLayout::Compressed)
+		&& tileVolume <= (static_cast<size_t>(1) << kTileShift);
+	_dimOffsets = vector<vector<size_t>>(kInSize);
+	tileStride = 1;
+	for (size_t i = 0; i < kInSize; i++) {
+		const size_t size = _indepData[i].size();
+		const size_t blockStride = compressed ? (tileCount << kTileShift) : tileCount * tileVolume;
+		_dimOffsets[i] = vector<size_t>(size);
+		for (size_t j = 0; j < size; j++) {
+			_dimOffsets[i][j] = (j % tile) * tileStride + (j / tile) * blockStride;
+		}
+		tileStride *= tile;
+		tileCount *= (size + tile - 1) / tile;
+	}
+	if (compressed) {
+		_tiles = vector<TileBlock>(tileCount);
+	}
+	return tileCount * tileVolume;
+}
+
+void LookupTableND::BuildTiles(const double* aDepData,
+	const size_t& aDepSize)
+{
+	// A tile is constant if every value it holds (ignoring its padding) has the exact same
+	// bits.  Infinite values and negative zero are left in full tiles, as interpolating
+	// between them does not always give back the same value.
+	const size_t kInSize = _indepData.size(); // shorthand
+	const size_t positionMask = (static_cast<size_t>(1) << kTileShift) - 1;
+	vector<double> firsts(_tiles.size());
+	vector<unsigned char> seen(_tiles.size(), 0), constant(_tiles.size(), 0);
+	size_t indices[kMaxFastDimensions] = {};
+	for (size_t idx = 0; idx < aDepSize; idx++) {
+		const size_t tile = StorageIndex(indices) >> kTileShift;
+		const double& value = aDepData[idx];
+		if (!seen[tile]) {
+			seen[tile] = 1;
+			firsts[tile] = value;
+			constant[tile] = std::isfinite(value) && !(value == 0.0 && std::signbit(value));
+		}
+		else if (constant[tile] && std::memcmp(&value, &firsts[tile], sizeof(double)) != 0) {
+			constant[tile] = 0;
+		}
+		for (size_t i = 0; i < kInSize && ++indices[i] == _indepData[i].size(); i++) {
+			indices[i] = 0;
+		}
+	}
+
+	// Lay out the tiles one after another, full tiles exactly as Tiled would (including
+	// their padding, which is never read but is filled with NaN to make mistakes obvious)
+	size_t tileVolume = 1;
+	for (size_t i = 0; i < kInSize; i++) {
+		tileVolume *= _options.tileSize;
+	}
+	size_t poolSize = 0;
+	for (size_t t = 0; t < _tiles.size(); t++) {
+		_tiles[t].start = poolSize;
+		_tiles[t].mask = constant[t] ? 0 : positionMask;
+		poolSize += constant[t] ? 1 : tileVolume;
+	}
+	TableData pool = TableData(poolSize, std::numeric_limits<double>::quiet_NaN());
+	for (size_t idx = 0; idx < aDepSize; idx++) {
+		pool[PoolIndex(StorageIndex(indices))] = aDepData[idx];
+		for (size_t i = 0; i < kInSize && ++indices[i] == _indepData[i].size(); i++) {
+			indices[i] = 0;
+		}
+	}
+	_depData = LookupStorage(std::move(pool), _options.storageType);
+}
+
+void LookupTableND::BuildAxes()
+{
+	_generation = NewGeneration();
+	_axes = vector<LookupAxis>();
+	_axes.reserve(_indepData.size());
+	_searchDepth = 0;
+	for (size_t i = 0; i < _indepData.size(); i++) {
+		_axes.emplace_back(_indepData.at(i), _options.searchLayout, _options.Bounds(i));
+		_searchDepth += _axes.back().SearchDepth();
+	}
+}
+
+void LookupTableND::BuildCells()
+{
+	_cellData = {};
+	_cellStrides = {};
+	const size_t kInSize = _indepData.size(); // shorthand
+	if (!_options.precomputeCells || kInSize > kMaxFastDimensions || _reader || !_derivData.empty())
+		return;
+
+	// Cells are numbered like _depData (dimension 0 fastest), but with one less value
+	// along each dimension since the last value of each only appears as a "high" corner
+	size_t cellCount = 1;
+	_cellStrides = vector<size_t>(kInSize);
+	for (size_t i = 0; i < kInSize; i++) {
+		_cellStrides[i] = cellCount;
+		cellCount *= (_indepData[i].size() > 1) ? _indepData[i].size() - 1 : 0;
+	}
+
+	// Walk every cell in order, tracking its low indices, and copy out its corners in the
+	// same order as InterpolateCell
+	const size_t comboCount = static_cast<size_t>(1) << kInSize;
+	_cellData = CellData(cellCount * comboCount);
+	size_t lowIdxs[kMaxFastDimensions] = {};
+	size_t steps[kMaxFastDimensions];
+	size_t offsets[static_cast<size_t>(1) << kMaxFastDimensions];
+	for (size_t cell = 0; cell < cellCount; cell++) {
+		LocateCell(lowIdxs, &offsets[0], steps);
+		for (size_t i = 0, bit = 1; i < kInSize; i++, bit <<= 1) {
+			for (size_t j = 0; j < bit; j++) {
+				offsets[j | bit] = offsets[j] + steps[kInSize - i - 1];
+			}
+		}
+		double* corners = &_cellData[cell * comboCount];
+		for (size_t j = 0; j < comboCount; j++) {
+			corners[j] = StoredValue(offsets[j]);
+		}
+		for (size_t i = 0; i < kInSize && ++lowIdxs[i] == _indepData[i].size() - 1; i++) {
+			lowIdxs[i] = 0;
+		}
+	}
+}
+
+void LookupTableND::BuildDerivatives()
+{
+	_derivData = {};
+	_kernelBits = {};
+	_derivBlock = 1;
+	const size_t kInSize = _indepData.size(); // shorthand
+	if (kInSize > kMaxFastDimensions || _reader)
+		return;
+	vector<size_t> kernelBits(kInSize, 0);
+	for (size_t i = 0; i < kInSize; i++) {
+		if (_options.Kernel(i) != TableOptions::Interpolation::Linear) {
+			kernelBits[i] = _derivBlock;
+			_derivBlock <<= 1;
+		}
+	}
+	if (_derivBlock == 1)
+		return;
+
+	// Every point holds its value first, then the derivative for each subset of its
+	// cubic dimensions at the position of the subset's bits
+	const TableData depData = LogicalDepData();
+	const size_t kBlock = _derivBlock; // shorthand
+	_derivData = vector<double>(depData.size() * kBlock, 0.0);
+	for (size_t idx = 0; idx < depData.size(); idx++) {
+		_derivData[idx * kBlock] = depData[idx];
+	}
+
+	// Differentiate every derivative found so far along each cubic dimension in turn,
+	// one line of points along that dimension at a time
+	vector<double> line, slopes;
+	for (size_t i = 0; i < kInSize; i++) {
+		const size_t bit = kernelBits[i];
+		if (bit == 0)
+			continue;
+		const TableData& breakpoints = _indepData[i]; // shorthand
+		const size_t size = breakpoints.size();
+		const size_t stride = _strides[i];
+		line.resize(size);
+		slopes.resize(size);
+		for (size_t start = 0; start < depData.size(); start++) {
+			if ((start / stride) % size != 0)
+				continue; // not the first point of a line along dimension i
+			for (size_t subset = 0; subset < bit; subset++) {
+				for (size_t k = 0; k < size; k++) {
+					line[k] = _derivData[(start + k * stride) * kBlock + subset];
+				}
+				KernelSlopes(_options.Kernel(i), breakpoints.data(), line.data(), size, slopes.data());
+				for (size_t k = 0; k < size; k++) {
+					_derivData[(start + k * stride) * kBlock + (subset | bit)] = slopes[k];
+				}
+			}
+		}
+	}
+	_kernelBits = std::move(kernelBits);
+}
+
+TableData LookupTableND::LogicalDepData() const
+{
+	TableData depData = TableData(DepDataSize());
+	if (_dimOffsets.empty()) {
+		for (size_t idx = 0; idx < depData.size(); idx++) {
+			depData[idx] = _depData.At(idx);
+		}
+		return depData;
+	}
+	size_t indices[kMaxFastDimensions] = {};
+	for (size_t idx = 0; idx < depData.size(); idx++) {
+		depData[idx] = StoredValue(StorageIndex(indices));
+		for (size_t i = 0; i < _indepData.size() && ++indices[i] == _indepData[i].size(); i++) {
+			indices[i] = 0;
+		}
+	}
+	return depData;
+}
+
+size_t LookupTableND::StorageIndex(const size_t* aIndices) const
+{
+	size_t idx = 0;
+	if (_dimOffsets.empty()) {
+		for (size_t i = 0; i < _indepData.size(); i++) {
+			idx += aIndices[i] * _strides[i];
+		}
+	}
+	else {
+		for (size_t i = 0; i < _indepData.size(); i++) {
+			idx += _dimOffsets[i][aIndices[i]];
+		}
+	}
+	return idx;
+}
+
+void LookupTableND::LocateCell(const size_t* aLowIdxs,
+	size_t* outBase,
+	size_t* outSteps) const
+{
+	*outBase = 0;
+	if (_dimOffsets.empty()) {
+		for (size_t i = 0; i < _indepData.size(); i++) {
+			*outBase += aLowIdxs[i] * _strides[i];
+			outSteps[i] = _strides[i];
+		}
+	}
+	else {
+		for (size_t i = 0; i < _indepData.size(); i++) {
+			const size_t* offsets = &_dimOffsets[i][aLowIdxs[i]]; // shorthand
+			*outBase += offsets[0];
+			outSteps[i] = offsets[1] - offsets[0];
+		}
+	}
+}
+// ==== End Section: Construction Helpers (Protected) ==== //
+
+
+
+
+// ==== Begin Section: Validity Helpers (Protected) ==== //
+bool LookupTableND::CheckMonotonicallyIncreasing(const TableDataSet& aFullDataSet) const
+{
+	for (size_t i = 0; i < aFullDataSet.size() - 1; i++) {
+		if (!CheckMonotonicallyIncreasing(aFullDataSet.at(i)))
+			return false;
+	}
+	return true;
+}
+
+bool LookupTableND::CheckMonotonicallyIncreasing(const TableData& aIndepData) const
+{
+	for (size_t j = 1; j < aIndepData.size(); j++) {
+		if (aIndepData[j - 1] >= aIndepData[j])
+			return false;
+	}
+	return true;
+}
+
+bool LookupTableND::CheckSourceData(const TableData* aIndepData,
+	const size_t& aDimensions,
+	const size_t& aDepSize) const
+{
+	// Valid only if the dependent data has a size equal to the size of each independent
+	//   data array multiplied together (e.g. a 2x3x4 needs a size 24 dep data)
+	if (!IsValidDimensionCount(aDimensions))
+		return false;
+	size_t reqSize = 1;
+	for (size_t i = 0; i < aDimensions; i++) {
+		const size_t size = aIndepData[i].size();
+		if (size != 0 && reqSize > std::numeric_limits<size_t>::max() / size)
+			return false; // far too large to be stored anyway
+		reqSize *= size;
+	}
+	if (reqSize != aDepSize)
+		return false; // dimensions must lineup
+	for (size_t i = 0; i < aDimensions; i++) {
+		if (!CheckMonotonicallyIncreasing(aIndepData[i]))
+			return false;
+	}
+	return true;
+}
+// ==== End Section: Validity Helpers (Protected) ==== //
+
+
+
+
+// ==== Begin Section: Interpolation Helpers (Protected) ==== //
+double LookupTableND::InterpolateCell(const size_t* aLowIdxs,
+	const double* aPercProgresses) const
+{
+	if (!_derivData.empty())
+		return InterpolateCubic(aLowIdxs, aPercProgresses);
+	const size_t kInSize = _indepData.size(); // shorthand
+	const size_t comboCount = static_cast<size_t>(1) << kInSize;
+
+	// Gather every corner of the cell, either from _cellData or from _depData using the
+	// steps found by LocateCell.  The corner ordering matches the binary counter used by
+	// FindByValuesGeneric, where the last dimension is the least significant bit, so that
+	// the interpolation below operates in the exact same order (and gives bit-identical
+	// results).
+	double vals[static_cast<size_t>(1) << kMaxFastDimensions];
+	if (!_cellData.empty()) {
+		// The corners are already packed in this order, so copy the whole cell at once
+		size_t cell = 0;
+		for (size_t i = 0; i < kInSize; i++) {
+			cell += aLowIdxs[i] * _cellStrides[i];
+		}
+		std::copy_n(&_cellData[cell * comboCount], comboCount, vals);
+	}
+	else {
+		size_t offsets[static_cast<size_t>(1) << kMaxFastDimensions];
+		size_t steps[kMaxFastDimensions];
+		LocateCell(aLowIdxs, &offsets[0], steps);
+		for (size_t i = 0, bit = 1; i < kInSize; i++, bit <<= 1) {
+			const size_t step = steps[kInSize - i - 1];
+			for (size_t j = 0; j < bit; j++) {
+				offsets[j | bit] = offsets[j] + step;
+			}
+		}
+		if (!_tiles.empty()) {
+			// The corners of a cell within a single constant tile all hold its value, which
+			// interpolating would give back exactly, so return it straight away
+			const TileBlock& tile = _tiles[offsets[0] >> kTileShift];
+			if (tile.mask == 0 && (offsets[comboCount - 1] >> kTileShift) == (offsets[0] >> kTileShift))
+				return _depData.At(tile.start);
+			for (size_t i = 0; i < comboCount; i++) {
+				offsets[i] = PoolIndex(offsets[i]);
+			}
+		}
+		if (_reader) {
+			if (_reader->Read(offsets, comboCount, vals) && _reader->Prefetching()) {
+				PrefetchNeighbours(aLowIdxs, offsets);
+			}
+		}
+		else {
+			_depData.Visit([&](const auto* aDepData) {
+				for (size_t i = 0; i < comboCount; i++) {
+					vals[i] = LookupStorage::ToDouble(aDepData[offsets[i]]);
+				}
+			});
+		}
+	}
+
+	// Work down through the corners, interpolating pairs one dimension at a time (see
+	// FindByValuesGeneric for a more detailed description)
+	for (size_t i = 0, count = comboCount; i < kInSize; i++, count >>= 1) {
+		const double prc = aPercProgresses[kInSize - i - 1];
+		for (size_t j = 1; j < count; j += 2) {
+			vals[j / 2] = utils::Lerp(vals[j - 1], vals[j], prc);
+		}
+	}
+	return vals[0];
+}
+
+double LookupTableND::InterpolateCubic(const size_t* aLowIdxs,
+	const double* aPercProgresses) const
+{
+	const size_t kInSize = _indepData.size(); // shorthand
+	const size_t kBlock = _derivBlock;        // shorthand
+	const size_t comboCount = static_cast<size_t>(1) << kInSize;
+
+	// Gather the value and derivatives of every corner, in the order of InterpolateCell
+	size_t offsets[static_cast<size_t>(1) << kMaxFastDimensions];
+	offsets[0] = 0;
+	for (size_t i = 0; i < kInSize; i++) {
+		offsets[0] += aLowIdxs[i] * _strides[i];
+	}
+	for (size_t i = 0, bit = 1; i < kInSize; i++, bit <<= 1) {
+		const size_t step = _strides[kInSize - i - 1];
+		for (size_t j = 0; j < bit; j++) {
+			offsets[j | bit] = offsets[j] + step;
+		}
+	}
+	Scratch<double, kCubicFastValues> valsScratch(comboCount * kBlock);
+	double* vals = valsScratch.Data();
+	for (size_t j = 0; j < comboCount; j++) {
+		std::copy_n(&_derivData[offsets[j] * kBlock], kBlock, &vals[j * kBlock]);
+	}
+
+	// Work down through the corners one dimension at a time as InterpolateCell does.  A
+	// linear dimension interpolates each pair's values and derivatives alike, while a
+	// cubic one combines each pair's values (and derivatives along the dimensions not yet
+	// reduced) with their slopes along it, after which those slopes are no longer needed.
+	double weights[4];
+	for (size_t i = 0, count = comboCount; i < kInSize; i++, count >>= 1) {
+		const size_t dim = kInSize - i - 1;
+		const double prc = aPercProgresses[dim];
+		const size_t bit = _kernelBits[dim];
+		if (bit == 0) {
+			for (size_t j = 1; j < count; j += 2) {
+				const double* low = &vals[(j - 1) * kBlock];
+				const double* high = &vals[j * kBlock];
+				double* out = &vals[(j / 2) * kBlock];
+				for (size_t k = 0; k < kBlock; k++) {
+					out[k] = utils::Lerp(low[k], high[k], prc);
+				}
+			}
+			continue;
+		}
+		const double width = _indepData[dim][aLowIdxs[dim] + 1] - _indepData[dim][aLowIdxs[dim]];
+		HermiteWeights(prc, width, weights);
+		for (size_t j = 1; j < count; j += 2) {
+			const double* low = &vals[(j - 1) * kBlock];
+			const double* high = &vals[j * kBlock];
+			double* out = &vals[(j / 2) * kBlock];
+			for (size_t k = 0; k < kBlock; k++) {
+				if ((k & bit) == 0) {
+					out[k] = weights[0] * low[k] + weights[1] * low[k | bit]
+						+ weights[2] * high[k] + weights[3] * high[k | bit];
+				}
+			}
+		}
+	}
+	return vals[0];
+}
+
+void LookupTableND::PrefetchNeighbours(const size_t* aLowIdxs,
+	const size_t* aCorners) const
+{
+	// Moving one cell up along dimension i adds the step from index low + 1 to low + 2 to
+	// the corners at low + 1 (those with its bit set), and moving down subtracts the step
+	// from low - 1 to low from those at low, giving the neighbour's new corners
+	const size_t kInSize = _indepData.size(); // shorthand
+	const size_t comboCount = static_cast<size_t>(1) << kInSize;
+	size_t corners[static_cast<size_t>(1) << (kMaxFastDimensions - 1)];
+	for (size_t i = 0; i < kInSize; i++) {
+		const size_t bit = static_cast<size_t>(1) << (kInSize - i - 1);
+		const size_t low = aLowIdxs[i]; // shorthand
+		if (low + 2 < _indepData[i].size()) {
+			const size_t step = _dimOffsets.empty() ? _strides[i]
+				: _dimOffsets[i][low + 2] - _dimOffsets[i][low + 1];
+			size_t count = 0;
+			for (size_t j = bit; j < comboCount; j = (j + 1) | bit) {
+				corners[count++] = aCorners[j] + step;
+			}
+			_reader->Prefetch(corners, count);
+		}
+		if (low > 0) {
+			const size_t step = _dimOffsets.empty() ? _strides[i]
+				: _dimOffsets[i][low] - _dimOffsets[i][low - 1];
+			size_t count = 0;
+			for (size_t j = 0; j < comboCount; j = ((j | bit) + 1) & ~bit) {
+				corners[count++] = aCorners[j] - step;
+			}
+			_reader->Prefetch(corners, count);
+		}
+	}
+}
+
+double LookupTableND::InterpolateCellGradient(const size_t* aLowIdxs,
+	const double* aPercProgresses,
+	double* outPartials) const
+{
+	const size_t kInSize = _indepData.size(); // shorthand
+	const size_t comboCount = static_cast<size_t>(1) << kInSize;
+	const size_t half = comboCount / 2;
+
+	// Gather every corner of the cell in the same order as InterpolateCell, finding the
+	// offset of each from the steps of the dimensions whose bit is set in its number
+	const size_t kFastCount = static_cast<size_t>(1) << kMaxFastDimensions;
+	Scratch<double, kFastCount> valsScratch(comboCount);
+	Scratch<double, kMaxFastDimensions * kFastCount / 2> partialsScratch(kInSize * half);
+	double* vals = valsScratch.Data();
+	double* partials = partialsScratch.Data();
+	if (!_cellData.empty()) {
+		size_t cell = 0;
+		for (size_t i = 0; i < kInSize; i++) {
+			cell += aLowIdxs[i] * _cellStrides[i];
+		}
+		std::copy_n(&_cellData[cell * comboCount], comboCount, vals);
+	}
+	else {
+		size_t base;
+		Scratch<size_t, kMaxFastDimensions> steps(kInSize);
+		Scratch<size_t, kFastCount> offsets(comboCount);
+		LocateCell(aLowIdxs, &base, steps.Data());
+		for (size_t j = 0; j < comboCount; j++) {
+			size_t offset = base;
+			for (size_t i = 0; i < kInSize; i++) {
+				offset += ((j >> (kInSize - i - 1)) & 1) * steps.Data()[i];
+			}
+			offsets.Data()[j] = _tiles.empty() ? offset : PoolIndex(offset);
+		}
+		if (_reader) {
+			_reader->Read(offsets.Data(), comboCount, vals);
+		}
+		else {
+			_depData.Visit([&](const auto* aDepData) {
+				for (size_t j = 0; j < comboCount; j++) {
+					vals[j] = LookupStorage::ToDouble(aDepData[offsets.Data()[j]]);
+				}
+			});
+		}
+	}
+
+	// Interpolate pairs exactly as InterpolateCell does while carrying the partials of
+	// each value along (partials[d * half + j] being that of value j along dimension d):
+	// those of the dimensions already interpolated are interpolated the same way, while
+	// that of the current dimension is the difference across the pair
+	for (size_t i = 0, count = comboCount; i < kInSize; i++, count >>= 1) {
+		const size_t dim = kInSize - i - 1;
+		const double prc = aPercProgresses[dim];
+		for (size_t j = 1; j < count; j += 2) {
+			for (size_t d = dim + 1; d < kInSize; d++) {
+				double* dimPartials = &partials[d * half]; // shorthand
+				dimPartials[j / 2] = utils::Lerp(dimPartials[j - 1], dimPartials[j], prc);
+			}
+			partials[dim * half + j / 2] = vals[j] - vals[j - 1];
+			vals[j / 2] = utils::Lerp(vals[j - 1], vals[j], prc);
+		}
+	}
+	for (size_t d = 0; d < kInSize; d++) {
+		outPartials[d] = partials[d * half];
+	}
+	return vals[0];
+}
+
+bool LookupTableND::FindByValuesGeneric(const double* aValueInputs,
+	double* outValue) const
+{
+	const size_t kInSize = _indepData.size(); // shorthand
+	vector<size_t> lowIdxs = vector<size_t>(kInSize);
+	vector<double> prcPrgs = vector<double>(kInSize);
+	size_t comboCount = 1; // number of value combinations required for interpolation later
+	for (size_t i = 0; i < kInSize; i++) {
+		if (!FindPositionInfo(i, aValueInputs[i], &lowIdxs.at(i), &prcPrgs.at(i)))
+			return false;
+		comboCount <<= 1; // number of combinations increases by power of two per input
+	}
+
+	vector<size_t> inps = vector<size_t>(lowIdxs);	  // inputs for each interpolation
+	vector<bool> bits = vector<bool>(kInSize, false); // used to modify inps programatically
+	vector<double> vals = vector<double>(comboCount); // will hold all interpolated values
+	for (size_t i = 0; i < comboCount; i++) {
+		vals.at(i) = StoredValue(StorageIndex(inps.data()));
+
+		// Vary inputs programmatically, following a binary counter flipping between the low
+		//	index value found above, and the index immediately following that one
+		// e.g. for 3 inputs: low,low,low; low,low,low+1; low,low+1,low; low,low+1,low+1; ...
+		bool flipped = false;
+		for (int k = kInSize - 1; k >= 0; k--) {
+			if (!flipped) {
+				bits.at(k) = !bits.at(k);
+				flipped = bits.at(k);
+			}
+			inps.at(k) = lowIdxs.at(k) + static_cast<size_t>(bits.at(k));
+		}
+	}
+
+	// Work down through the inputs above, interpolating their results together
+	for (size_t i = 0; i < kInSize; i++) {
+		for (size_t j = 1; j < comboCount; j += 2) {
+			vals.at(j / 2) = utils::Lerp(vals.at(j - 1), vals.at(j),
+										 prcPrgs.at(prcPrgs.size() - i - 1));
+		}
+		comboCount >>= 1;
+		// This process interpolates all combinations of intermediate interpoloations of any
+		// number of dimensions by condensing the vals vector from back to front until the 
+		// final interpolated value is calculated and stored at vals[0]
+	}
+	*outValue = vals.front();
+	return true;
+}
+
+size_t LookupTableND::EvaluateBatch(const double* const* aDimValues,
+	const size_t& aBegin,
+	const size_t& aEnd,
+	double* outValues,
+	uint64_t* outValidMask) const
+{
+	const size_t kInSize = _indepData.size(); // shorthand
+	if (kInSize > kMaxFastDimensions) {
+		// Rare case, so simply reuse the generic implementation point by point
+		size_t validCount = 0;
+		vector<double> inputs(kInSize);
+		for (size_t i = aBegin; i < aEnd; i++) {
+			for (size_t k = 0; k < kInSize; k++) {
+				inputs[k] = aDimValues[k][i];
+			}
+			if (FindByValuesGeneric(inputs.data(), &outValues[i])) {
+				outValidMask[i / 64] |= static_cast<uint64_t>(1) << (i % 64);
+				validCount++;
+			}
+			else {
+				outValues[i] = std::numeric_limits<double>::quiet_NaN();
+			}
+		}
+		return validCount;
+	}
+
+	size_t next;
+	size_t validCount = EvaluateBatchSimd(aDimValues, aBegin, aEnd, outValues, outValidMask, &next);
+
+	size_t lowIdxs[kMaxFastDimensions];
+	double prcPrgs[kMaxFastDimensions];
+	for (size_t i = next; i < aEnd; i++) {
+		bool found = true;
+		for (size_t k = 0; found && k < kInSize; k++) {
+			found = FindPositionInfo(k, aDimValues[k][i], &lowIdxs[k], &prcPrgs[k]);
+		}
+		if (found) {
+			outValues[i] = InterpolateCell(lowIdxs, prcPrgs);
+			outValidMask[i / 64] |= static_cast<uint64_t>(1) << (i % 64);
+			validCount++;
+		}
+		else {
+			outValues[i] = std::numeric_limits<double>::quiet_NaN();
+		}
+	}
+	return validCount;
+}
+
+size_t LookupTableND::EvaluateBatchSimd(const double* const* aDimValues,
+	const size_t& aBegin,
+	const size_t& aEnd,
+	double* outValues,
+	uint64_t* outValidMask,
+	size_t* outNext) const
+{
+	static_assert(simd::kMaxDimensions == kMaxFastDimensions, "Mismatched dimension limits.");
+	*outNext = aBegin;
+	if (!simd::Available() || _indepData.size() > kMaxFastDimensions || !_tiles.empty() || _reader
+		|| !_derivData.empty())
+		return 0; // (the kernels only interpolate linearly values held in _depData)
+
+	simd::BatchLayout layout;
+	layout.dims = _indepData.size();
+	for (size_t k = 0; k < layout.dims; k++) {
+		layout.axes[k] = _indepData[k].data();
+		layout.axisSizes[k] = _indepData[k].size();
+		layout.strides[k] = _strides[k];
+		layout.dimOffsets[k] = _dimOffsets.empty() ? nullptr : _dimOffsets[k].data();
+		layout.uniform[k] = _axes[k].Uniform();
+		layout.origins[k] = _axes[k].Origin();
+		layout.invSteps[k] = _axes[k].InvStep();
+		layout.bounds[k] = _axes[k].Bounds();
+	}
+	layout.depData = _depData.Data();
+	layout.depDataSize = _depData.Size();
+	layout.depStorage = _depData.Type();
+	return simd::EvaluateBatch(layout, aDimValues, aBegin, aEnd, outValues, outValidMask, outNext);
+}
+// ==== End Section: Interpolation Helpers (Protected) ==== //
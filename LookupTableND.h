@@ -27,34 +27,211 @@
 #ifndef _ZJLD_LOOKUP_TABLE_ND_H_
 #define _ZJLD_LOOKUP_TABLE_ND_H_
 
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
+#include "LookupAxis.h"
+#include "LookupFile.h"
+#include "LookupLazy.h"
+#include "LookupPaged.h"
+#include "LookupParallel.h"
+#include "LookupPartial.h"
+#include "LookupSlice.h"
+#include "LookupStats.h"
+#include "LookupStorage.h"
+#include "LookupTrace.h"
 #include "LookupUtils.hpp"
 
 
 namespace zjld // feel free to remove/rename as the license above allows
 {
-	
-	typedef std::vector<double>    TableData;
-	typedef std::vector<TableData> TableDataSet;
+
+	// This holds the segment found along each dimension by a previous lookup so that the
+	// next lookup can start its searches there (see the hinted LookupByValues methods).
+	// Inputs that change little between lookups (e.g. once per timestep of a simulation)
+	// then typically need one or two comparisons per dimension instead of a full search.
+	// The hint is owned by the caller rather than the table, so a const table stays safe
+	// to share between threads as long as each thread uses its own hint.  A hint from a
+	// different table or a default constructed one only costs speed, never correctness.
+	struct LookupHint
+	{
+		static const size_t kMaxDimensions = 8; // any further dimensions are not hinted
+
+		size_t segments[kMaxDimensions]; // last segment found along each dimension
+
+		LookupHint() : segments{} {}
+		void Reset() { *this = LookupHint(); }
+	};
+
+
+	// Function objects looking up points in one concrete type of table, as passed to the
+	// visitors of LookupTableVariant (see LookupTableVariant.h)
+	template<typename TTable>
+	class LookupKernel;
+
+
+	// This holds the options controlling how a table organizes its data internally (see
+	// LookupTableND::SetOptions).  None of them change the results of any lookup, other
+	// than the bound policies deciding what happens outside of the table's data and the
+	// interpolation kernels deciding what happens between its breakpoints.
+	struct TableOptions
+	{
+		// The order the dependent data is stored in internally (logical indices, such as
+		// those given to LookupByIndices or returned by LookupIndexAt, never change):
+		// - Linear: as given, with dimension 0 fastest (i + j*ni + k*nj*ni + ...)
+		// - Tiled: in hypercube tiles of tileSize values along each dimension, one tile
+		//   after another, so that the corners of a cell are (almost always) close together
+		//   rather than spread over up to 2^(N-1) distant cache lines and pages.  Dimensions
+		//   are padded up to a multiple of tileSize.
+		// - Compressed: the same tiles as Tiled, but each tile whose values are all the same
+		//   (e.g. the plateaus of a mostly flat table) is stored as that single value, found
+		//   through a small index holding where each tile starts.  Lookups in a cell within
+		//   such a tile return its value without interpolating, while every other lookup
+		//   costs one more read from the index per corner (nor are batches vectorized).
+		// Tables with more than LookupTableND::kMaxFastDimensions dimensions are always
+		// Linear.
+		enum class DataLayout { Linear, Tiled, Compressed };
+
+		LookupAxis::SearchLayout searchLayout; // search used along non-uniform dimensions
+		DataLayout dataLayout;                 // storage order of the dependent data
+		size_t tileSize;                       // tile edge length (Tiled only, at least 2)
+
+		// Type the dependent data is stored as (see StorageType).  Values are rounded once
+		// when stored, while all interpolation is still done in double.  Note that setting
+		// this on a populated table converts its current values, so precision lost by
+		// choosing a smaller type is not recovered by switching back.
+		StorageType storageType;
+
+		// If true, the 2^N corner values of every cell are also stored next to each other
+		// so that each lookup reads one contiguous block instead of 2^N scattered values.
+		// This costs up to 2^N times the memory of the dependent data (see CellDataSize),
+		// and is ignored by tables with more than LookupTableND::kMaxFastDimensions and by
+		// paged or lazy tables.
+		bool precomputeCells;
+
+		// How values outside of the independent data of each dimension are handled (see
+		// LookupAxis::BoundPolicy): boundPolicies[d] for dimension d if given, otherwise
+		// boundPolicy.  This applies to every lookup by values, including batches.
+		LookupAxis::BoundPolicy boundPolicy;
+		std::vector<LookupAxis::BoundPolicy> boundPolicies;
+
+		// How values are interpolated between the breakpoints of each dimension:
+		// interpolations[d] for dimension d if given, otherwise interpolation.
+		// - Linear: straight lines between breakpoints (the default, and the only kernel
+		//   of the gradient, inverse and partial lookups, which return
+		//   ErrorCode::Unsupported for tables using any other)
+		// - CatmullRom: a cubic Hermite spline whose slope at each breakpoint is that of
+		//   the line between its neighbours, so it is smooth but may overshoot the data
+		// - Pchip: a monotone cubic Hermite spline (Fritsch-Carlson), which never overshoots
+		//   the data and stays flat where it is flat, at the cost of a less smooth curve
+		// - Akima: a cubic Hermite spline whose slopes are weighted towards the flatter
+		//   side of each breakpoint, which follows abrupt changes with little ringing
+		// The slopes of the cubic kernels (and their cross derivatives between cubic
+		// dimensions) are computed once when the table is built and stored per data point,
+		// taking 2^C times the memory of the dependent data as Double for C cubic
+		// dimensions (see DerivativeDataSize).  Each lookup then interpolates between the
+		// same 2^N corners as a linear one, reading 2^C values from each.  Beyond the
+		// bounds (BoundPolicy::Extrapolate), cubic dimensions continue along the slope of
+		// their first or last breakpoint.  Dimensions with only 2 breakpoints follow the
+		// line between them whatever their kernel.  Cubic kernels are ignored by tables
+		// with more than LookupTableND::kMaxFastDimensions dimensions and by paged or lazy
+		// tables, and replace precomputed cells and the SIMD batch kernels.
+		enum class Interpolation { Linear, CatmullRom, Pchip, Akima };
+		Interpolation interpolation;
+		std::vector<Interpolation> interpolations;
+
+		TableOptions()
+			: searchLayout{ LookupAxis::SearchLayout::Auto }
+			, dataLayout{ DataLayout::Linear }
+			, tileSize{ 4 }
+			, storageType{ StorageType::Double }
+			, precomputeCells{ false }
+			, boundPolicy{ LookupAxis::BoundPolicy::Error }
+			, boundPolicies{}
+			, interpolation{ Interpolation::Linear }
+			, interpolations{}
+		{}
+
+		// Returns the bound policy of dimension aDimension (see above)
+		LookupAxis::BoundPolicy Bounds(const size_t& aDimension) const
+		{
+			return (aDimension < boundPolicies.size()) ? boundPolicies[aDimension] : boundPolicy;
+		}
+
+		// Returns the interpolation of dimension aDimension (see above)
+		Interpolation Kernel(const size_t& aDimension) const
+		{
+			return (aDimension < interpolations.size()) ? interpolations[aDimension] : interpolation;
+		}
+	};
 
 
 	// This class implements the basics of a lookup table with 2 to N-dimensions.  Data
 	// structures with only 1 dimension are left for more trivial implementations.
-	// Linear interpolation is used between data points, while extrapolation is currently
-	// not implemented but rather returns an error if attempting to access a table's data
-	// outside of its defined limits.  With this, it also requires the independent data
-	// to be monotonically increasing (common in many tables, but not all).
-	// NOTE: If implementing a 2D or 3D table, this is slightly less efficient than derived
-	// classes LookupTable2D and LookupTable3D, respectively, due to use of loops, etc.
+	// Linear interpolation is used between data points by default, or one of the cubic
+	// kernels per dimension (see TableOptions::Interpolation), while values outside of a
+	// table's defined limits return an error by default, or are clamped or extrapolated
+	// according to the bound policy of their dimension (see TableOptions).  The table
+	// requires the independent data to be monotonically increasing (common in many tables,
+	// but not all).
+	// NOTE: If the dimension count is known at compile time, this is slightly less
+	// efficient than the class template LookupTable<N> (see LookupTableFixed.h, with the
+	// aliases LookupTable2D and LookupTable3D), whose searches and interpolation are
+	// unrolled rather than looped.
+	// Thread safety: every const method only reads the table and keeps no state between
+	// calls (hinted lookups keep theirs in each caller's LookupHint, while paged and lazy
+	// tables synchronize their own pages and tiles), so any number of threads may query
+	// the same table at once.  Non-const methods (populating, resetting,
+	// setting options, loading) must not run while any other thread uses the table; see
+	// LookupTableHandle for replacing tables that are in use.
 	class LookupTableND
 	{
 	protected:
+		// Cells are aligned to cache lines so that a cell of up to 8 values spans just one
+		typedef std::vector<double, utils::AlignedAllocator<double, 64>> CellData;
+
+		// With DataLayout::Compressed, the offsets in _dimOffsets add up to a tile number
+		// shifted up by kTileShift bits plus the position of the value within that tile,
+		// which is then found in _depData from the tile's TileBlock (see PoolIndex).
+		// Constant tiles have a mask of 0, so that every position reads their one value.
+		struct TileBlock {
+			size_t start; // position of the tile's first value in _depData
+			size_t mask;  // applied to positions within the tile (all ones, or 0 if constant)
+		};
+		static const size_t kTileShift = sizeof(size_t) * 4;
+
 		TableDataSet _indepData; // vector of vectors of independent variable data
-		TableData _depData;		 // vector of dependent variable data
+		LookupStorage _depData;	 // dependent variable data (see DataLayout, StorageType)
+		std::vector<size_t> _strides; // logical dependent data step per dimension
+		std::vector<std::vector<size_t>> _dimOffsets; // _depData offset of each index along
+		                                              // each dimension (empty if Linear)
+		std::vector<TileBlock> _tiles; // where each tile is in _depData (Compressed only)
+		std::shared_ptr<DepDataReader> _reader; // dependent data read through calls (paged
+		                                        // or lazy only, with _depData empty)
+		std::vector<LookupAxis> _axes; // search structures for each _indepData vector
+		CellData _cellData;      // corner values packed per cell (see TableOptions)
+		std::vector<size_t> _cellStrides; // cell number step per independent dimension
+		std::vector<double> _derivData; // each point's value and derivatives along its cubic
+		                                // dimensions (empty unless any, see TableOptions)
+		std::vector<size_t> _kernelBits; // bit of each cubic dimension within a point's
+		                                 // _derivData (0 if linear)
+		size_t _derivBlock;      // _derivData values per point (2^C for C cubic dimensions)
+		TableOptions _options;   // how the internal structures above are built
+		size_t _searchDepth;     // sum of the axes' SearchDepth (for LookupStats)
+		uint64_t _generation;    // unique to the current data and options (see Generation)
+		LookupTraceRecorder* _trace = nullptr; // records lookups by values (see SetTraceRecorder)
 		bool _valid;			 // current validity status of the table
 
+		template<typename TTable> friend class LookupKernel; // calls FindByValues directly
+		friend class LookupDeviceData; // copies the stored data for devices
+
 	public:
+		// Tables with up to this many dimensions are interpolated using fixed-size stack
+		// storage (2^N corner values), avoiding any heap allocation per lookup.  Tables
+		// with more dimensions fall back to the (allocating) generic implementation.
+		static const size_t kMaxFastDimensions = 8;
+
 
 	// ==== Begin Section: Construction/Destruction (Public) ==== //
 		/* - Provided a valid data set, these will initialize the table appropriately and
@@ -70,30 +247,154 @@ namespace zjld // feel free to remove/rename as the license above allows
 		LookupTableND(const TableDataSet& aFullDataSet);
 		LookupTableND(const TableDataSet& aIndepDataSet,
 			const TableData& aDepData);
+		LookupTableND(TableDataSet&& aFullDataSet);
+		LookupTableND(TableDataSet&& aIndepDataSet,
+			TableData&& aDepData);
+
+		/* These are the same as the above, but build the table with the given options
+		* rather than the defaults (see SetOptions), e.g. to choose the bound policies.
+		*/
+		LookupTableND(const TableDataSet& aFullDataSet,
+			const TableOptions& aOptions);
+		LookupTableND(TableDataSet&& aFullDataSet,
+			const TableOptions& aOptions);
 		virtual ~LookupTableND(){}
 	// ==== End Section: Construction/Destruction (Public) ==== //
 
 
 	// ==== Begin Section: Data Population (Public) ==== //
 		/* These check if a given data set is valid to supply the source for this table,
-		* return true if true, falase otherwise.
+		* return true if true, falase otherwise.  The data is checked in place (without
+		* copying any of it).
 		*/
 		virtual bool IsValidSourceData(const TableDataSet& aFullDataSet) const;
 		bool IsValidSourceData(const TableDataSet& aIndepDataSet,
 			const TableData& aDepData) const;
 
+		/* This returns true if the table supports the given number of independent dimensions
+		* (2 or more here, exactly N for LookupTable<N>).
+		*/
+		virtual bool IsValidDimensionCount(const size_t& aDimensions) const;
+
 		/* These attempt to populate the table with the given data.  If unable to, the table
-		* is reset using ResetData, resulting in the Valid flag being false.
+		* is reset using ResetData, resulting in the Valid flag being false.  Either way, a
+		* table that was paged (see LoadBinary) or lazy (see PopulateLazy) no longer is.
 		*/
 		bool PopulateData(const TableDataSet& aFullDataSet);
 		bool PopulateData(const TableDataSet& aIndepDataSet,
 			const TableData& aDepData);
 
+		/* These are the same as the above, but take over the memory of the given data
+		* instead of copying it (the dependent data is only taken over as-is when stored
+		* Linear as Double, the default, see TableOptions).  The given data is left empty if
+		* the table is populated, or unchanged otherwise.
+		*/
+		bool PopulateData(TableDataSet&& aFullDataSet);
+		bool PopulateData(TableDataSet&& aIndepDataSet,
+			TableData&& aDepData);
+
+		/* This populates the table without copying the dependent data, instead viewing the
+		* aDepSize values at aDepData (e.g. a numpy or Eigen buffer), which must stay valid
+		* and unchanged until the table is reset or repopulated.  The (comparatively small)
+		* independent data is copied.  The values are only viewed when stored Linear as
+		* Double (the default options), otherwise they are converted from aDepData straight
+		* into the table's own memory, as they are when setting options later.
+		*/
+		bool PopulateDataView(const TableDataSet& aIndepDataSet,
+			const double* aDepData,
+			const size_t& aDepSize);
+
+		/* This populates the table with the given independent data, leaving each dependent
+		* value to be computed by aGenerator the first time a lookup needs it, a tile at a
+		* time (see LazyTiles), so that the cost of populating grows with the part of the
+		* table actually used rather than with its size.  The table is stored Tiled as
+		* Double (replacing those options) with the tile size of the options, which must be
+		* at least 2; larger tiles generate more points at once but index fewer tiles.  Lazy
+		* tables support up to kMaxFastDimensions dimensions, never precompute cells, only
+		* rebuild their searches when setting options, and cannot be saved.  If the
+		* independent data is invalid (see IsValidSourceData) or the tile file of aLazy
+		* cannot be written, the table is reset using ResetData and false is returned, with
+		* a reason in outErrMsg (if not null).
+		*/
+		bool PopulateLazy(const TableDataSet& aIndepDataSet,
+			const DepDataGenerator& aGenerator,
+			const LazyOptions& aLazy,
+			std::string* outErrMsg);
+
 		/* This empties all data in the table and sets the Valid flag to be false.
 		*/
 		void ResetData();
 	// ==== End Section: Data Population (Public) ==== //
 
+
+	// ==== Begin Section: Options (Public) ==== //
+		/* These set and return the options used to build the table's internal structures.
+		* Setting them on a populated table rebuilds those structures from its current data,
+		* so it is cheapest to set them before populating.  ResetData keeps the options.
+		*/
+		void SetOptions(const TableOptions& aOptions);
+		const TableOptions& Options() const;
+	// ==== End Section: Options (Public) ==== //
+
+
+	// ==== Begin Section: Binary Files (Public) ==== //
+		/* This writes the table to aPath in the binary format described in LookupFile.h,
+		* storing the dependent data exactly as held (same StorageType and DataLayout).  It
+		* returns false, with a reason in outErrMsg (if not null), if the table is invalid or
+		* the file could not be written.
+		*/
+		bool SaveBinary(const std::string& aPath,
+			std::string* outErrMsg) const;
+
+		/* This populates the table from a file written by SaveBinary (see FileMode):
+		* - Copy reads the whole file and verifies its checksum
+		* - Map only reads the header and axes, leaving the dependent data in the mapped
+		*   pages (which stay mapped until the table is reset or repopulated), so the
+		*   checksum is not verified (see VerifyBinary)
+		* The storage type, data layout and tile size of the options are replaced by those of
+		* the file, while the other options apply as usual.  If the file is invalid, the
+		* table is reset using ResetData and false is returned, with a reason in outErrMsg
+		* (if not null).
+		*/
+		bool LoadBinary(const std::string& aPath,
+			const FileMode& aMode,
+			std::string* outErrMsg);
+
+		/* This is the same as the above, but leaves the dependent data in the file and reads
+		* it a page at a time as lookups need it, keeping the recently used pages in memory
+		* within aPages.cacheBytes (see PageCache), so that tables larger than memory can
+		* be used.  Only the header and axes are read up front, and the checksum is not
+		* verified.  Lookups reading a page from the file are far slower than others, so
+		* Tiled files (whose cells are close together) page much better than Linear ones.
+		* Paged tables never precompute cells, while setting options only rebuilds their
+		* searches, and they cannot be saved again (copy the file instead).  A value whose
+		* page can no longer be read from the file (e.g. since truncated) is NaN.
+		*/
+		bool LoadBinary(const std::string& aPath,
+			const PageOptions& aPages,
+			std::string* outErrMsg);
+
+		/* This writes a Linear binary file at aPath (in the storage type of the options) for
+		* the given independent data and the dependent data supplied by aSource a chunk at a
+		* time, never holding more than one chunk in memory, then loads it paged with aPages
+		* as above.  The independent data is checked first (as by IsValidSourceData), and
+		* the number of values supplied must match it exactly.  If not, or the file cannot
+		* be written, the file is removed, the table is reset using ResetData and false is
+		* returned, with a reason in outErrMsg (if not null).
+		*/
+		bool PopulateStream(const std::string& aPath,
+			const TableDataSet& aIndepDataSet,
+			const DepDataSource& aSource,
+			const PageOptions& aPages,
+			std::string* outErrMsg);
+
+		/* This reads the whole file at aPath and returns true if it is a binary table whose
+		* checksum matches its contents, or false (with a reason in outErrMsg) otherwise.
+		*/
+		static bool VerifyBinary(const std::string& aPath,
+			std::string* outErrMsg);
+	// ==== End Section: Binary Files (Public) ==== //
+
 		
 	// ==== Begin Section: Lookup Methods (Public) ==== //
 		/* These find the index in the dependent data vector that corresponds to the given
@@ -125,14 +426,191 @@ namespace zjld // feel free to remove/rename as the license above allows
 			double* outValue,
 			std::string* outErrMsg) const;
 		virtual utils::Result<double> QueryByValues(const std::vector<double>& aValueInputs) const;
+
+		/* These are the same as the above, but each dimension's search starts from the
+		* segment stored in ioHint, which is then updated with the segment that was found
+		* (on failure, ioHint may be partially updated but remains usable).  Results are
+		* identical to the unhinted methods - only the time spent searching differs.
+		*/
+		double LookupByValues(const std::vector<double>& aValueInputs,
+			LookupHint* ioHint) const;
+		bool QueryByValues(const std::vector<double>& aValueInputs,
+			LookupHint* ioHint,
+			double* outValue,
+			std::string* outErrMsg) const;
+		utils::Result<double> QueryByValues(const std::vector<double>& aValueInputs,
+			LookupHint* ioHint) const;
 	// ==== End Section: Lookup Methods (Public) ==== //
 
 
+
+
+	// ==== Begin Section: Gradient Methods (Public) ==== //
+		/* These are the same as the unhinted LookupByValues and QueryByValues, but also
+		* return the gradient of the interpolated value: outGradient must hold one value per
+		* dimension and receives the partial derivative with respect to each input.  Both
+		* come from the same searches and cell corners, so the value is bit-identical to
+		* that of LookupByValues, and nothing is written to outGradient on failure.
+		* - Within a cell the interpolation is linear along each dimension, so each partial
+		* is the slope across the cell along that dimension (interpolated along the others)
+		* - On a breakpoint, the slope of the segment after it is used (or of the last
+		* segment on the upper bound)
+		* - A dimension with BoundPolicy::Clamp has a partial of 0 when its input is out of
+		* bounds, while BoundPolicy::Extrapolate continues the slope of the outer segment
+		*/
+		double LookupValueAndGradient(const std::vector<double>& aValueInputs,
+			double* outGradient) const;
+		bool QueryValueAndGradient(const std::vector<double>& aValueInputs,
+			double* outValue,
+			double* outGradient,
+			std::string* outErrMsg) const;
+		utils::Result<double> QueryValueAndGradient(const std::vector<double>& aValueInputs,
+			double* outGradient) const;
+	// ==== End Section: Gradient Methods (Public) ==== //
+
+
+
+
+	// ==== Begin Section: Inverse Lookup Methods (Public) ==== //
+		/* These solve for the input of aDimension at which the table gives aTarget, with
+		* every other input fixed to its entry in aInputs (one per dimension, where that of
+		* aDimension is ignored), returning the lowest such input within the breakpoints of
+		* aDimension.  The slice of the table along aDimension at those inputs is evaluated
+		* once (see LookupSlice), then searched directly: a binary search if its values are
+		* monotonic, otherwise a scan of its segments.  LookupByValues then gives aTarget
+		* at the result, to within the rounding of the interpolation.
+		* Inputs outside of the bounds are handled according to the BoundPolicy of each
+		* fixed dimension, but the result is never extrapolated beyond those of aDimension
+		* (ErrorCode::NoSolution is returned instead).
+		*/
+		double LookupInverse(const size_t& aDimension,
+			const std::vector<double>& aInputs,
+			const double& aTarget) const;
+		bool QueryInverse(const size_t& aDimension,
+			const std::vector<double>& aInputs,
+			const double& aTarget,
+			double* outValue,
+			std::string* outErrMsg) const;
+		utils::Result<double> QueryInverse(const size_t& aDimension,
+			const std::vector<double>& aInputs,
+			const double& aTarget) const;
+
+		/* These are the same as the above, but keep the slice in ioSlice, which is only
+		* evaluated again if it does not already hold the slice of this table along
+		* aDimension at aInputs.  Repeated solves at the same fixed inputs then cost a
+		* single search of the slice each.
+		*/
+		double LookupInverse(const size_t& aDimension,
+			const std::vector<double>& aInputs,
+			const double& aTarget,
+			LookupSlice* ioSlice) const;
+		bool QueryInverse(const size_t& aDimension,
+			const std::vector<double>& aInputs,
+			const double& aTarget,
+			LookupSlice* ioSlice,
+			double* outValue,
+			std::string* outErrMsg) const;
+		utils::Result<double> QueryInverse(const size_t& aDimension,
+			const std::vector<double>& aInputs,
+			const double& aTarget,
+			LookupSlice* ioSlice) const;
+
+		/* This fills ioSlice with the slice of the table along aDimension at aInputs (as
+		* described above, keeping it as is if it already holds that slice), from which
+		* every input giving a target can be found (see LookupSlice::FindRoots).
+		*/
+		bool QuerySlice(const size_t& aDimension,
+			const std::vector<double>& aInputs,
+			LookupSlice* ioSlice,
+			std::string* outErrMsg) const;
+	// ==== End Section: Inverse Lookup Methods (Public) ==== //
+
+
+	// ==== Begin Section: Partial Evaluation Methods (Public) ==== //
+		/* This fills ioPartial with the table reduced to aFreeDimensions (in increasing
+		* order, at least one of them) with every other input bound to its entry in aInputs
+		* (one per dimension, where those of the free dimensions are ignored), keeping it
+		* as is if it already holds that partial (see LookupPartial).  The bound inputs are
+		* found and interpolated once for every breakpoint of the free dimensions, so
+		* evaluating the partial costs only the searches of the free dimensions and the
+		* interpolation between their corners.  Bound inputs outside of the bounds are
+		* handled according to the BoundPolicy of their dimension, as are the free inputs
+		* later given to the partial.
+		*/
+		bool QueryPartial(const std::vector<size_t>& aFreeDimensions,
+			const std::vector<double>& aInputs,
+			LookupPartial* ioPartial,
+			std::string* outErrMsg) const;
+	// ==== End Section: Partial Evaluation Methods (Public) ==== //
+
+
+	// ==== Begin Section: Batch Lookup Methods (Public) ==== //
+		/* This is the equivalent of LookupByValues for many points at once, with the inputs
+		* given as a structure of arrays: aDimValues holds one pointer per dimension, each to
+		* aCount contiguous values (i.e. aDimValues[d][i] is input d of point i).
+		* - outValues must hold aCount values and receives each interpolated value, or NaN
+		* for any point that could not be evaluated (e.g. out of bounds)
+		* - outValidMask must hold utils::BatchMaskWords(aCount) words, and bit (i % 64) of
+		* word (i / 64) is set if point i is valid (see utils::BatchMaskTest)
+		* - Table validity, dimension count and pointer checks are done once per batch
+		* rather than once per point, and nothing is thrown nor allocated per point
+		* The number of valid points is returned (0 if the batch itself is invalid, e.g. an
+		* invalid table or the wrong number of dimensions, in which case no bits are set).
+		*/
+		size_t QueryBatchByValues(const std::vector<const double*>& aDimValues,
+			const size_t& aCount,
+			double* outValues,
+			uint64_t* outValidMask) const;
+
+		/* This is the same as QueryBatchByValues, with identical results, but splits the
+		* batch into chunks of kBatchChunkSize points (sized so that a chunk's inputs and
+		* outputs stay within a core's L2 cache) that are evaluated in parallel by aExecutor,
+		* or by ThreadPool::Default() if aExecutor is empty.  Chunks only write to their own
+		* parts of outValues and outValidMask (the chunk size being a multiple of 64 points,
+		* no two chunks share a mask word) and share no other mutable state.
+		*/
+		static const size_t kBatchChunkSize = 4096;
+		size_t QueryBatchByValuesParallel(const std::vector<const double*>& aDimValues,
+			const size_t& aCount,
+			double* outValues,
+			uint64_t* outValidMask,
+			const BatchExecutor& aExecutor = BatchExecutor()) const;
+	// ==== End Section: Batch Lookup Methods (Public) ==== //
+
+
+	// ==== Begin Section: Tracing (Public) ==== //
+		/* These set and return the recorder that this table's lookups by values are recorded
+		* by (see LookupTraceRecorder), or null (the default) to record nothing.  Recording
+		* is only compiled in when ZJLD_LOOKUP_TRACE is defined (see LookupTrace.h), and
+		* the recorder must outlive its use by the table.  It must not be set while other
+		* threads use the table.  Copies of the table keep the recorder, and repopulating
+		* it does not change it.
+		*/
+		void SetTraceRecorder(LookupTraceRecorder* aRecorder);
+		LookupTraceRecorder* TraceRecorder() const;
+	// ==== End Section: Tracing (Public) ==== //
+
+
 	// ==== Begin Section: Metadata (Public) ==== //
 		bool Valid() const;
 		size_t Dimensions() const;  // _indepData.size (vector of vectors)
-		size_t DepDataSize() const; // _depData.size
+		size_t DepDataSize() const; // number of dependent data values (excluding padding)
+		size_t DepDataBytes() const; // memory used to store them (including padding, the
+		                             // index of a Compressed or lazy table, and the pages
+		                             // cached by a paged one)
+		bool DepDataIsView() const;  // true if stored in memory owned elsewhere (e.g. a view)
+		size_t CellDataSize() const; // _cellData.size (0 unless precomputing cells)
+		size_t DerivativeDataSize() const; // _derivData.size (0 unless any kernel is cubic)
+		size_t ConstantTileCount() const; // tiles stored as one value (0 unless Compressed)
+		bool Paged() const;           // true if loaded paged (see LoadBinary)
+		size_t FilledTileCount() const; // tiles generated so far (0 unless lazy)
+		PageStats PagingStats() const; // page cache activity (all zero unless paged)
 		size_t IndepDataSize(const size_t& aDimension) const; // _indepData[aDimension].size
+		const LookupAxis& Axis(const size_t& aDimension) const; // search info for a dimension
+		uint64_t Generation() const; // unique within the process to the table's current data
+		                             // and options, changing whenever either does (so that
+		                             // slices and other caches of lookups can tell their
+		                             // table has changed)
 	// ==== End Section: Metadata (Public) ==== //
 
 
@@ -154,17 +632,284 @@ namespace zjld // feel free to remove/rename as the license above allows
 			size_t* outLowIdx,
 			double* outPercProgress) const;
 
-		/* This returns the floating point "index" to the location in the dependent data
-		* vector where the given value would be located, using simple linear interpolation.
+		/* This is the same as the above, but starts the search from the segment held by
+		* ioSegment and updates it with the segment found (see LookupAxis::FindSegment).
+		* A null ioSegment searches without a hint, as with all helpers taking one.
+		*/
+		void GetPositionInfo(const size_t& aDimension,
+			const double& aValue,
+			size_t* ioSegment,
+			size_t* outLowIdx,
+			double* outPercProgress) const;
+
+		/* These return the floating point "index" to the location in the dependent data
+		* vector where the given value would be located, using simple linear interpolation
+		* (the second starting from a hinted segment, as with GetPositionInfo).
 		*/
 		void GetApproxPos(const size_t& aDimension,
 			const double& aValue,
 			double* outApproxPosition) const;
+		void GetApproxPos(const size_t& aDimension,
+			const double& aValue,
+			size_t* ioSegment,
+			double* outApproxPosition) const;
+
+		/* These are the non-throwing cores of GetPositionInfo and GetApproxPos, returning
+		* false if aValue is NaN or outside the bounds of the data (with BoundPolicy::Error)
+		* instead of throwing.
+		* The table must be valid and aDimension in range, as neither is checked here.
+		*/
+		bool FindPositionInfo(const size_t& aDimension,
+			const double& aValue,
+			size_t* outLowIdx,
+			double* outPercProgress) const;
+		bool FindPositionInfo(const size_t& aDimension,
+			const double& aValue,
+			size_t* ioSegment,
+			size_t* outLowIdx,
+			double* outPercProgress) const;
+		bool FindApproxPos(const size_t& aDimension,
+			const double& aValue,
+			double* outApproxPosition) const;
+		bool FindApproxPos(const size_t& aDimension,
+			const double& aValue,
+			size_t* ioSegment,
+			double* outApproxPosition) const;
+
+		/* These are the non-throwing cores of the Lookup and Query methods, which check
+		* everything the Lookup methods do but return the reason for any failure instead of
+		* throwing (and nothing else is allocated, other than the values of a slice or a
+		* partial, which FindSlice and FindPartial leave empty on failure).  outDimension
+		* receives the dimension of an input that is out of bounds, and ioSegments is either
+		* null or holds the hinted segment of every dimension (see LookupHint).
+		*/
+		utils::ErrorCode FindIndexAt(const size_t* aInputs,
+			const size_t& aCount,
+			size_t* outIndex,
+			size_t* outDimension) const;
+		utils::ErrorCode FindByIndices(const size_t* aInputs,
+			const size_t& aCount,
+			double* outValue,
+			size_t* outDimension) const;
+		utils::ErrorCode FindByValues(const double* aValueInputs,
+			const size_t& aCount,
+			size_t* ioSegments,
+			double* outValue) const;
+		utils::ErrorCode FindValueAndGradient(const double* aValueInputs,
+			const size_t& aCount,
+			double* outValue,
+			double* outGradient) const;
+		utils::ErrorCode FindSlice(const size_t& aDimension,
+			const double* aInputs,
+			const size_t& aCount,
+			LookupSlice* ioSlice) const;
+		utils::ErrorCode FindInverse(const size_t& aDimension,
+			const double* aInputs,
+			const size_t& aCount,
+			const double& aTarget,
+			LookupSlice* ioSlice,
+			double* outValue) const;
+		utils::ErrorCode FindPartial(const std::vector<size_t>& aFreeDimensions,
+			const double* aInputs,
+			const size_t& aCount,
+			LookupPartial* ioPartial) const;
+
+		/* These format the message of aError, including the offending input and bounds of
+		* IndexOutOfBounds errors (aIndexInputs[aDimension]), and throw it as the Lookup
+		* methods always have (std::invalid_argument for bad inputs).  The Query methods
+		* only format a message when returning it through a string.
+		*/
+		std::string ErrorMessage(const utils::ErrorCode& aError,
+			const size_t* aIndexInputs,
+			const size_t& aDimension) const;
+		[[noreturn]] void ThrowError(const utils::ErrorCode& aError,
+			const size_t* aIndexInputs,
+			const size_t& aDimension) const;
+
+		/* This converts an approximate position found by GetApproxPos into the low index
+		* and percent progress used for interpolation (see GetPositionInfo).
+		*/
+		void PositionFromApproxPos(const size_t& aDimension,
+			const double& aApproxPosition,
+			size_t* outLowIdx,
+			double* outPercProgress) const;
+
+		/* These (re)build _depData (along with _dimOffsets) from the given dependent data,
+		* and _axes and _cellData from the table's data, according to _options.  _strides
+		* must already be set.
+		*/
+		void BuildStorage(const TableData& aDepData);
+		void BuildStorage(TableData&& aDepData);
+		void BuildStorage(const double* aDepData,
+			const size_t& aDepSize);
+
+		/* This (re)builds just _dimOffsets (and the size of _tiles) according to _options
+		* and returns the number of values _depData must hold in that layout (including any
+		* padding, and before any compression).
+		*/
+		size_t BuildDimOffsets();
+
+		/* This (re)builds _depData and _tiles from the given dependent data (in its logical
+		* order) for DataLayout::Compressed, once BuildDimOffsets has sized _tiles.
+		*/
+		void BuildTiles(const double* aDepData,
+			const size_t& aDepSize);
+
+		/* This sets _indepData, _strides and _options (storage type, data layout and tile
+		* size) from the header of a binary file and its axes block (at aAxes, holding
+		* aHeader.axesBytes bytes), checking that the dependent block matches them, and
+		* returns the reason if not (or an empty string).
+		*/
+		std::string LoadLayout(const file::Header& aHeader,
+			const unsigned char* aAxes);
+
+		/* This (re)builds _strides from _indepData (see LookupIndexAt).
+		*/
+		void BuildStrides();
+
+		/* This (re)builds _axes from _indepData and _options, and gives the table a new
+		* _generation, since every change to its data or options goes through either this
+		* or ResetData (which does the same).
+		*/
+		void BuildAxes();
+		void BuildCells();
+
+		/* This (re)builds _derivData for the cubic kernels of the options (see
+		* TableOptions::Interpolation): the value of every point, then the slopes along the
+		* first cubic dimension of those values, then along the second of both of those,
+		* and so on, so that each point holds a derivative for every subset of its cubic
+		* dimensions.  It must run before BuildCells, which it stops from building cells.
+		*/
+		void BuildDerivatives();
+
+		/* This returns the dependent data in its logical (Linear) order, regardless of how
+		* it is stored.
+		*/
+		TableData LogicalDepData() const;
+
+		/* These translate logical indices (one per dimension) into storage in _depData: the
+		* first returns the position of a single value, while the second finds the position
+		* of the lowest corner of the cell at aLowIdxs along with the step to the next
+		* value along each dimension from there (constant strides if Linear).  No bounds
+		* checking is done.
+		*/
+		size_t StorageIndex(const size_t* aIndices) const;
+		void LocateCell(const size_t* aLowIdxs,
+			size_t* outBase,
+			size_t* outSteps) const;
+
+		/* These read through the storage positions found above: PoolIndex translates one
+		* into the position of its value in _depData when Compressed (see TileBlock), and
+		* StoredValue returns that value in any layout, read through _reader or not.
+		*/
+		size_t PoolIndex(const size_t& aStorageIndex) const
+		{
+			const TileBlock& tile = _tiles[aStorageIndex >> kTileShift];
+			const size_t position = aStorageIndex & ((static_cast<size_t>(1) << kTileShift) - 1);
+			return tile.start + (position & tile.mask);
+		}
+		double StoredValue(const size_t& aStorageIndex) const
+		{
+			if (_reader)
+				return _reader->At(aStorageIndex);
+			return _depData.At(_tiles.empty() ? aStorageIndex : PoolIndex(aStorageIndex));
+		}
 
 		/* Returns false if any independent data vectors are NOT monotonically increasing
 		* (required for searches, interpolations, etc.), or true otherwise.
 		*/
 		bool CheckMonotonicallyIncreasing(const TableDataSet& aFullDataSet) const;
+		bool CheckMonotonicallyIncreasing(const TableData& aIndepData) const;
+
+		/* Returns true if aDimensions independent data vectors at aIndepData along with
+		* aDepSize dependent values form a valid data set for this table (see
+		* IsValidSourceData), without copying any of them.
+		*/
+		bool CheckSourceData(const TableData* aIndepData,
+			const size_t& aDimensions,
+			const size_t& aDepSize) const;
+
+		/* This interpolates the 2^N corners of the cell whose lowest corner is given by
+		* aLowIdxs (one entry per dimension, as found by GetPositionInfo), weighting each
+		* dimension by the matching entry in aPercProgresses.  No bounds checking is done
+		* and no memory is allocated, so the inputs must come from GetPositionInfo and
+		* the table must have at most kMaxFastDimensions dimensions.  The corner values
+		* are read from _cellData if it has been built, otherwise from _depData.
+		*/
+		double InterpolateCell(const size_t* aLowIdxs,
+			const double* aPercProgresses) const;
+
+		/* This is the equivalent of InterpolateCell for tables with cubic kernels (which it
+		* hands over to), reading the values and derivatives of each corner from _derivData
+		* and combining each pair of corners along a cubic dimension with the weights of
+		* the cubic Hermite basis instead of a linear interpolation.
+		*/
+		double InterpolateCubic(const size_t* aLowIdxs,
+			const double* aPercProgresses) const;
+
+		/* This queues the pages of the cells next to the one at aLowIdxs along every
+		* dimension for prefetching, given the storage positions of its 2^N corners (in the
+		* order of InterpolateCell).  Only the new corners of each neighbour are queued, as
+		* the others are those just read.
+		*/
+		void PrefetchNeighbours(const size_t* aLowIdxs,
+			const size_t* aCorners) const;
+
+		/* This is the equivalent of InterpolateCell that also fills outPartials (one per
+		* dimension) with the partial derivative of the value with respect to each entry of
+		* aPercProgresses, found alongside it while interpolating (in the same order, so the
+		* value is bit-identical).  Unlike InterpolateCell, any number of dimensions is
+		* supported, only allocating for tables with more than kMaxFastDimensions.
+		*/
+		double InterpolateCellGradient(const size_t* aLowIdxs,
+			const double* aPercProgresses,
+			double* outPartials) const;
+
+		/* This is the original, allocating implementation of LookupByValues kept for
+		* tables with more than kMaxFastDimensions dimensions (aValueInputs holding one
+		* value per dimension), returning false if any input is out of bounds.
+		*/
+		bool FindByValuesGeneric(const double* aValueInputs,
+			double* outValue) const;
+
+		/* This zeroes outValidMask and checks that a batch can be evaluated (see
+		* QueryBatchByValues), returning false after filling outValues with NaN if not.
+		*/
+		bool PrepareBatch(const std::vector<const double*>& aDimValues,
+			const size_t& aCount,
+			double* outValues,
+			uint64_t* outValidMask) const;
+
+		/* This adds a finished batch of aCount points (aValidCount of them valid) to the
+		* calling thread's LookupStats, if compiled in (see LookupStats.h).
+		*/
+		void CountBatch(const size_t& aCount,
+			const size_t& aValidCount) const;
+
+		/* This evaluates points [aBegin, aEnd) of a batch already checked by 
+		* QueryBatchByValues (aDimValues has one non-null entry per dimension), setting the
+		* bits of valid points in outValidMask (which must be zeroed beforehand) and returning
+		* the number of valid points.  aBegin must be a multiple of 64 so that separate
+		* ranges never touch the same mask word.  Derived classes may override this to
+		* provide a faster kernel for their specific case.
+		*/
+		virtual size_t EvaluateBatch(const double* const* aDimValues,
+			const size_t& aBegin,
+			const size_t& aEnd,
+			double* outValues,
+			uint64_t* outValidMask) const;
+
+		/* This runs the SIMD batch kernels (see LookupSimd.h) over as much of [aBegin, aEnd)
+		* as they support, with the same requirements and results as EvaluateBatch.  It
+		* returns the number of valid points and sets outNext to the first point that still
+		* needs to be evaluated by the scalar path (aBegin if SIMD is unavailable).
+		*/
+		size_t EvaluateBatchSimd(const double* const* aDimValues,
+			const size_t& aBegin,
+			const size_t& aEnd,
+			double* outValues,
+			uint64_t* outValidMask,
+			size_t* outNext) const;
 	// ==== End Section: Helpers (Protected) ==== //
 
 	};
@@ -0,0 +1,428 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+// This file is part of LookupTable <https://github.com/zjldemers/LookupTable>.
+// 
+// MIT License
+// Copyright (c) 2022 Zachary J. L. Demers
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef _ZJLD_LOOKUP_TABLE_STATIC_H_
+#define _ZJLD_LOOKUP_TABLE_STATIC_H_
+
+#include <array>
+#include <cstddef>
+#include <limits>
+#include "LookupAxis.h"
+#include "LookupUtils.hpp"
+
+
+namespace zjld // feel free to remove/rename as the license above allows
+{
+	namespace detail
+	{
+		// The step through the dependent data of a StaticLookupTable along each dimension
+		// (the first dimension changing fastest, as for LookupTableND)
+		template<size_t N>
+		constexpr std::array<size_t, N> StaticStrides(const std::array<size_t, N>& aSizes)
+		{
+			std::array<size_t, N> strides{};
+			strides[0] = 1;
+			for (size_t i = 1; i < N; i++) {
+				strides[i] = strides[i - 1] * aSizes[i - 1];
+			}
+			return strides;
+		}
+
+		// Where each dimension's breakpoints start within the independent data of a
+		// StaticLookupTable, which stores them one dimension after another
+		template<size_t N>
+		constexpr std::array<size_t, N> StaticOffsets(const std::array<size_t, N>& aSizes)
+		{
+			std::array<size_t, N> offsets{};
+			for (size_t i = 1; i < N; i++) {
+				offsets[i] = offsets[i - 1] + aSizes[i - 1];
+			}
+			return offsets;
+		}
+
+		template<size_t N>
+		constexpr std::array<LookupAxis::BoundPolicy, N> StaticPolicies(
+			const LookupAxis::BoundPolicy& aBoundPolicy)
+		{
+			std::array<LookupAxis::BoundPolicy, N> policies{};
+			for (size_t i = 0; i < N; i++) {
+				policies[i] = aBoundPolicy;
+			}
+			return policies;
+		}
+
+		// Deliberately not constexpr: a StaticLookupTable constructed in a constant
+		// expression from breakpoints that are not strictly increasing calls this, which
+		// stops the compilation with an error naming it.  Elsewhere it does nothing (the
+		// table is then just not Valid).
+		inline void StaticTableBreakpointsNotIncreasing() {}
+	}
+
+
+	// This class template is a table whose breakpoint counts are fixed at compile time
+	// (kSizes... gives the count of each dimension, e.g. StaticLookupTable<5, 3> for a
+	// 5x3 table), for small tables that are known when building, such as those compiled
+	// into embedded firmware.  It is a literal type holding its data in std::arrays, with
+	// no heap allocation, no virtual methods and no exceptions, so a constexpr instance is
+	// built entirely by the compiler and placed in read-only data (i.e. flash/ROM on most
+	// embedded targets) with no startup cost:
+	//   constexpr StaticLookupTable<3, 2> kTable({ 0.0, 1.0, 4.0 }, { 0.0, 1.0 },
+	//       { 1.0, 2.0, 3.0, 4.0, 5.0, 6.0 });
+	//   static_assert(kTable.LookupByValues(0.5, 0.5) == 3.0, "");
+	// The sizes are checked by static_asserts, while the breakpoints must be strictly
+	// increasing for the table to be Valid, which is a compile error for a constexpr
+	// table (see detail::StaticTableBreakpointsNotIncreasing).  Every lookup is constexpr
+	// and noexcept, so the compiler is free to inline it fully or fold it into a constant.
+	// Results are bit-identical to a LookupTableND of the same data with the default
+	// options (and the same bound policies).  Failures are reported through the ErrorCode
+	// of the Result overloads, or the return value of the out-value overloads, since no
+	// message strings are built; the Lookup- overloads return NaN instead of throwing.
+	template<size_t... kSizes>
+	class StaticLookupTable
+	{
+		static_assert(sizeof...(kSizes) >= 2, "1-dimensional tables are not implemented.");
+		static_assert(((kSizes >= 2) && ...), "Every dimension needs at least 2 breakpoints.");
+
+		template<size_t I> using Index = typename detail::Repeat<I, const size_t&>::type;
+		template<size_t I> using Value = typename detail::Repeat<I, const double&>::type;
+
+	public:
+		static constexpr size_t kDimensions = sizeof...(kSizes);
+		static constexpr size_t kDepSize = (kSizes * ...);
+		static constexpr size_t kIndepSize = (kSizes + ...);
+
+		typedef std::array<double, kDepSize> DepData; // first dimension changing fastest
+		typedef std::array<size_t, kDimensions> IndexInputs;
+		typedef std::array<double, kDimensions> ValueInputs;
+		typedef std::array<LookupAxis::BoundPolicy, kDimensions> BoundPolicies;
+
+	protected:
+		typedef std::array<size_t, kDimensions> DimSizes;
+		static constexpr DimSizes kDimSizes = { kSizes... };
+		static constexpr DimSizes kStrides = detail::StaticStrides(kDimSizes);
+		static constexpr DimSizes kOffsets = detail::StaticOffsets(kDimSizes);
+
+		std::array<double, kIndepSize> _indepData; // every dimension's breakpoints in turn
+		DepData _depData;                          // dependent data (see DepData)
+		BoundPolicies _bounds;                     // how out of bounds values are handled
+		bool _valid;                               // whether the breakpoints are valid
+
+	public:
+	// ==== Begin Section: Construction (Public) ==== //
+		/* Each aIndepData holds the breakpoints of its dimension, and aDepData the values at
+		* every combination of them (laid out as the dependent data of a LookupTableND).
+		* aBoundPolicy (or aBoundPolicies, one per dimension) decides how values beyond
+		* the breakpoints are handled, as with TableOptions::boundPolicy.
+		*/
+		constexpr StaticLookupTable(const std::array<double, kSizes>&... aIndepData,
+			const DepData& aDepData,
+			const LookupAxis::BoundPolicy& aBoundPolicy
+				= LookupAxis::BoundPolicy::Error) noexcept;
+		constexpr StaticLookupTable(const std::array<double, kSizes>&... aIndepData,
+			const DepData& aDepData,
+			const BoundPolicies& aBoundPolicies) noexcept;
+	// ==== End Section: Construction (Public) ==== //
+
+
+
+	// ==== Begin Section: Lookup Methods (Public) ==== //
+		/* Returns the dependent value at the given indices, or NaN if the table is not
+		* valid or an index is beyond its dimension.
+		*/
+		constexpr double LookupByIndices(Index<kSizes>... aIndices) const noexcept;
+		constexpr double LookupByIndices(const IndexInputs& aIndexInputs) const noexcept;
+		constexpr bool QueryByIndices(Index<kSizes>... aIndices,
+			double* outValue) const noexcept;
+		constexpr utils::Result<double> QueryByIndices(
+			Index<kSizes>... aIndices) const noexcept;
+
+		/* Interpolates the dependent value at the given inputs, or returns NaN if the table
+		* is not valid or an input is rejected by its dimension's bound policy (NaN always
+		* is).
+		*/
+		constexpr double LookupByValues(Value<kSizes>... aValues) const noexcept;
+		constexpr double LookupByValues(const ValueInputs& aValueInputs) const noexcept;
+		constexpr bool QueryByValues(Value<kSizes>... aValues,
+			double* outValue) const noexcept;
+		constexpr utils::Result<double> QueryByValues(
+			Value<kSizes>... aValues) const noexcept;
+	// ==== End Section: Lookup Methods (Public) ==== //
+
+
+
+	// ==== Begin Section: Metadata Methods (Public) ==== //
+		constexpr bool Valid() const noexcept { return _valid; }
+		constexpr size_t Dimensions() const noexcept { return kDimensions; }
+		constexpr size_t DepDataSize() const noexcept { return kDepSize; }
+		constexpr size_t IndepDataSize(const size_t& aDimension) const noexcept {
+			return (aDimension < kDimensions) ? kDimSizes[aDimension] : 0;
+		}
+		constexpr LookupAxis::BoundPolicy Bounds(const size_t& aDimension) const noexcept {
+			return _bounds[aDimension];
+		}
+	// ==== End Section: Metadata Methods (Public) ==== //
+
+	protected:
+		/* Copies aData to _indepData at *ioPos (advancing it), returning whether it is
+		* strictly increasing (and free of NaN).
+		*/
+		template<size_t kSize>
+		constexpr bool AppendBreakpoints(const std::array<double, kSize>& aData,
+			size_t* ioPos) noexcept;
+
+		/* The non-throwing cores of the lookup methods above, which return the reason for
+		* any failure (leaving outValue untouched).
+		*/
+		constexpr utils::ErrorCode FindByIndices(const size_t* aIndices,
+			double* outValue) const noexcept;
+		constexpr utils::ErrorCode FindByValues(const double* aValues,
+			double* outValue) const noexcept;
+
+		/* Finds the low index and percent progress of aValue along aDimension with
+		* LookupAxis::FindPosition (and so exactly as a LookupTableND would), returning false
+		* if the bound policy rejects it.
+		*/
+		constexpr bool FindPosition(const size_t& aDimension,
+			const double& aValue,
+			size_t* outLowIdx,
+			double* outPercProgress) const noexcept;
+
+		/* Interpolates the 2^N corners of the cell in the same order as
+		* LookupTableND::InterpolateCell (the last dimension is the least significant bit).
+		*/
+		constexpr double Interpolate(const size_t* aLowIdxs,
+			const double* aPercProgresses) const noexcept;
+	};
+
+
+
+
+	// ==== Begin Section: Construction (Public) ==== //
+	template<size_t... kSizes>
+	constexpr StaticLookupTable<kSizes...>::StaticLookupTable(
+		const std::array<double, kSizes>&... aIndepData,
+		const DepData& aDepData,
+		const LookupAxis::BoundPolicy& aBoundPolicy) noexcept
+		: StaticLookupTable(aIndepData..., aDepData,
+			detail::StaticPolicies<kDimensions>(aBoundPolicy))
+	{}
+
+	template<size_t... kSizes>
+	constexpr StaticLookupTable<kSizes...>::StaticLookupTable(
+		const std::array<double, kSizes>&... aIndepData,
+		const DepData& aDepData,
+		const BoundPolicies& aBoundPolicies) noexcept
+		: _indepData{}
+		, _depData{ aDepData }
+		, _bounds{ aBoundPolicies }
+		, _valid{ true }
+	{
+		// (a braced list is evaluated in order, so the dimensions are appended in turn)
+		size_t pos = 0;
+		const bool increasing[] = { AppendBreakpoints(aIndepData, &pos)... };
+		for (const bool valid : increasing) {
+			_valid = _valid && valid;
+		}
+		if (!_valid)
+			detail::StaticTableBreakpointsNotIncreasing();
+	}
+
+	template<size_t... kSizes>
+	template<size_t kSize>
+	constexpr bool StaticLookupTable<kSizes...>::AppendBreakpoints(
+		const std::array<double, kSize>& aData,
+		size_t* ioPos) noexcept
+	{
+		bool increasing = true;
+		for (size_t i = 0; i < kSize; i++) {
+			_indepData[*ioPos + i] = aData[i];
+			if (i > 0 && !(aData[i - 1] < aData[i]))
+				increasing = false;
+		}
+		*ioPos += kSize;
+		return increasing && aData[0] == aData[0];
+	}
+	// ==== End Section: Construction (Public) ==== //
+
+
+
+
+	// ==== Begin Section: Lookup Methods (Public) ==== //
+	template<size_t... kSizes>
+	constexpr double StaticLookupTable<kSizes...>::LookupByIndices(
+		Index<kSizes>... aIndices) const noexcept
+	{
+		const size_t inputs[kDimensions] = { aIndices... };
+		double value = std::numeric_limits<double>::quiet_NaN();
+		FindByIndices(inputs, &value);
+		return value;
+	}
+	template<size_t... kSizes>
+	constexpr double StaticLookupTable<kSizes...>::LookupByIndices(
+		const IndexInputs& aIndexInputs) const noexcept
+	{
+		double value = std::numeric_limits<double>::quiet_NaN();
+		FindByIndices(aIndexInputs.data(), &value);
+		return value;
+	}
+	template<size_t... kSizes>
+	constexpr bool StaticLookupTable<kSizes...>::QueryByIndices(Index<kSizes>... aIndices,
+		double* outValue) const noexcept
+	{
+		if (nullptr == outValue)
+			return false;
+		const size_t inputs[kDimensions] = { aIndices... };
+		return FindByIndices(inputs, outValue) == utils::ErrorCode::None;
+	}
+	template<size_t... kSizes>
+	constexpr utils::Result<double> StaticLookupTable<kSizes...>::QueryByIndices(
+		Index<kSizes>... aIndices) const noexcept
+	{
+		const size_t inputs[kDimensions] = { aIndices... };
+		double value = 0.0;
+		const utils::ErrorCode error = FindByIndices(inputs, &value);
+		return (error == utils::ErrorCode::None)
+			? utils::Result<double>(value) : utils::Result<double>(error);
+	}
+
+
+	template<size_t... kSizes>
+	constexpr double StaticLookupTable<kSizes...>::LookupByValues(
+		Value<kSizes>... aValues) const noexcept
+	{
+		const double inputs[kDimensions] = { aValues... };
+		double value = std::numeric_limits<double>::quiet_NaN();
+		FindByValues(inputs, &value);
+		return value;
+	}
+	template<size_t... kSizes>
+	constexpr double StaticLookupTable<kSizes...>::LookupByValues(
+		const ValueInputs& aValueInputs) const noexcept
+	{
+		double value = std::numeric_limits<double>::quiet_NaN();
+		FindByValues(aValueInputs.data(), &value);
+		return value;
+	}
+	template<size_t... kSizes>
+	constexpr bool StaticLookupTable<kSizes...>::QueryByValues(Value<kSizes>... aValues,
+		double* outValue) const noexcept
+	{
+		if (nullptr == outValue)
+			return false;
+		const double inputs[kDimensions] = { aValues... };
+		return FindByValues(inputs, outValue) == utils::ErrorCode::None;
+	}
+	template<size_t... kSizes>
+	constexpr utils::Result<double> StaticLookupTable<kSizes...>::QueryByValues(
+		Value<kSizes>... aValues) const noexcept
+	{
+		const double inputs[kDimensions] = { aValues... };
+		double value = 0.0;
+		const utils::ErrorCode error = FindByValues(inputs, &value);
+		return (error == utils::ErrorCode::None)
+			? utils::Result<double>(value) : utils::Result<double>(error);
+	}
+	// ==== End Section: Lookup Methods (Public) ==== //
+
+
+
+
+	// ==== Begin Section: Lookup Helpers (Protected) ==== //
+	template<size_t... kSizes>
+	constexpr utils::ErrorCode StaticLookupTable<kSizes...>::FindByIndices(
+		const size_t* aIndices,
+		double* outValue) const noexcept
+	{
+		if (!_valid)
+			return utils::ErrorCode::InvalidTable;
+		size_t offset = 0;
+		for (size_t i = 0; i < kDimensions; i++) {
+			if (aIndices[i] >= kDimSizes[i])
+				return utils::ErrorCode::IndexOutOfBounds;
+			offset += aIndices[i] * kStrides[i];
+		}
+		*outValue = _depData[offset];
+		return utils::ErrorCode::None;
+	}
+
+	template<size_t... kSizes>
+	constexpr utils::ErrorCode StaticLookupTable<kSizes...>::FindByValues(
+		const double* aValues,
+		double* outValue) const noexcept
+	{
+		if (!_valid)
+			return utils::ErrorCode::InvalidTable;
+		size_t lowIdxs[kDimensions] = {};
+		double prcPrgs[kDimensions] = {};
+		for (size_t i = 0; i < kDimensions; i++) {
+			if (!FindPosition(i, aValues[i], &lowIdxs[i], &prcPrgs[i]))
+				return utils::ErrorCode::ValueOutOfBounds;
+		}
+		*outValue = Interpolate(lowIdxs, prcPrgs);
+		return utils::ErrorCode::None;
+	}
+
+	template<size_t... kSizes>
+	constexpr bool StaticLookupTable<kSizes...>::FindPosition(const size_t& aDimension,
+		const double& aValue,
+		size_t* outLowIdx,
+		double* outPercProgress) const noexcept
+	{
+		return LookupAxis::FindPosition(&_indepData[kOffsets[aDimension]], kDimSizes[aDimension],
+			_bounds[aDimension], aValue, outLowIdx, outPercProgress);
+	}
+
+	template<size_t... kSizes>
+	constexpr double StaticLookupTable<kSizes...>::Interpolate(const size_t* aLowIdxs,
+		const double* aPercProgresses) const noexcept
+	{
+		constexpr size_t comboCount = static_cast<size_t>(1) << kDimensions;
+		size_t offsets[comboCount] = {};
+		for (size_t i = 0; i < kDimensions; i++) {
+			offsets[0] += aLowIdxs[i] * kStrides[i];
+		}
+		for (size_t i = 0, bit = 1; i < kDimensions; i++, bit <<= 1) {
+			for (size_t j = 0; j < bit; j++) {
+				offsets[j | bit] = offsets[j] + kStrides[kDimensions - i - 1];
+			}
+		}
+		double vals[comboCount] = {};
+		for (size_t i = 0; i < comboCount; i++) {
+			vals[i] = _depData[offsets[i]];
+		}
+
+		// Work down through the corners, interpolating pairs one dimension at a time
+		for (size_t i = 0, count = comboCount; i < kDimensions; i++, count >>= 1) {
+			const double prc = aPercProgresses[kDimensions - i - 1];
+			for (size_t j = 1; j < count; j += 2) {
+				vals[j / 2] = utils::Lerp(vals[j - 1], vals[j], prc);
+			}
+		}
+		return vals[0];
+	}
+	// ==== End Section: Lookup Helpers (Protected) ==== //
+}
+
+#endif // _ZJLD_LOOKUP_TABLE_STATIC_H_
@@ -0,0 +1,159 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+// This file is part of LookupTable <https://github.com/zjldemers/LookupTable>.
+// 
+// MIT License
+// Copyright (c) 2022 Zachary J. L. Demers
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "LookupTableVariant.h"
+
+using namespace zjld; // feel free to remove/rename as the license above allows
+using std::string;
+using std::vector;
+using utils::Result;
+
+
+// ==== Begin Section: Construction (Public) ==== //
+LookupTableVariant::LookupTableVariant()
+	: _table{}
+{}
+
+LookupTableVariant::LookupTableVariant(const TableDataSet& aFullDataSet)
+	: _table{}
+{
+	PopulateData(aFullDataSet);
+}
+
+LookupTableVariant::LookupTableVariant(TableDataSet&& aFullDataSet)
+	: _table{}
+{
+	PopulateData(std::move(aFullDataSet));
+}
+
+LookupTableVariant::LookupTableVariant(const TableDataSet& aFullDataSet,
+	const TableOptions& aOptions)
+	: _table{}
+{
+	SetOptions(aOptions); // only stored, as the table is not populated yet
+	PopulateData(aFullDataSet);
+}
+
+LookupTableVariant::LookupTableVariant(TableDataSet&& aFullDataSet,
+	const TableOptions& aOptions)
+	: _table{}
+{
+	SetOptions(aOptions);
+	PopulateData(std::move(aFullDataSet));
+}
+
+bool LookupTableVariant::PopulateData(const TableDataSet& aFullDataSet)
+{
+	const TableOptions options = Options();
+	LookupTableND& table = Reset(aFullDataSet.empty() ? 0 : aFullDataSet.size() - 1);
+	table.SetOptions(options);
+	return table.PopulateData(aFullDataSet);
+}
+
+bool LookupTableVariant::PopulateData(TableDataSet&& aFullDataSet)
+{
+	const TableOptions options = Options();
+	LookupTableND& table = Reset(aFullDataSet.empty() ? 0 : aFullDataSet.size() - 1);
+	table.SetOptions(options);
+	return table.PopulateData(std::move(aFullDataSet));
+}
+
+void LookupTableVariant::SetOptions(const TableOptions& aOptions)
+{
+	Table().SetOptions(aOptions);
+}
+
+const TableOptions& LookupTableVariant::Options() const
+{
+	return Table().Options();
+}
+// ==== End Section: Construction (Public) ==== //
+
+
+
+
+// ==== Begin Section: Lookup Methods (Public) ==== //
+// A qualified call is never virtual, so each of these goes straight to the held type's own
+// implementation (which, for LookupTable<N>, unpacks the inputs into its fixed-N lookup)
+double LookupTableVariant::LookupByValues(const vector<double>& aValueInputs) const
+{
+	return std::visit([&](const auto& aTable) {
+		typedef std::decay_t<decltype(aTable)> TTable;
+		return aTable.TTable::LookupByValues(aValueInputs); }, _table);
+}
+bool LookupTableVariant::QueryByValues(const vector<double>& aValueInputs,
+	double* outValue,
+	string* outErrMsg) const
+{
+	return std::visit([&](const auto& aTable) {
+		typedef std::decay_t<decltype(aTable)> TTable;
+		return aTable.TTable::QueryByValues(aValueInputs, outValue, outErrMsg); }, _table);
+}
+Result<double> LookupTableVariant::QueryByValues(const vector<double>& aValueInputs) const
+{
+	return std::visit([&](const auto& aTable) {
+		typedef std::decay_t<decltype(aTable)> TTable;
+		return aTable.TTable::QueryByValues(aValueInputs); }, _table);
+}
+// ==== End Section: Lookup Methods (Public) ==== //
+
+
+
+
+// ==== Begin Section: Metadata (Public) ==== //
+const LookupTableND& LookupTableVariant::Table() const
+{
+	return std::visit([](const auto& aTable) -> const LookupTableND& { return aTable; }, _table);
+}
+
+LookupTableND& LookupTableVariant::Table()
+{
+	return std::visit([](auto& aTable) -> LookupTableND& { return aTable; }, _table);
+}
+
+bool LookupTableVariant::Valid() const
+{
+	return Table().Valid();
+}
+
+size_t LookupTableVariant::Dimensions() const
+{
+	return Table().Dimensions();
+}
+// ==== End Section: Metadata (Public) ==== //
+
+
+
+
+// ==== Begin Section: Helpers (Protected) ==== //
+LookupTableND& LookupTableVariant::Reset(const size_t& aDimensions)
+{
+	switch (aDimensions) {
+	case 2: return _table.emplace<LookupTable2D>();
+	case 3: return _table.emplace<LookupTable3D>();
+	default: return _table.emplace<LookupTableND>();
+	}
+}
+// ==== End Section: Helpers (Protected) ==== //
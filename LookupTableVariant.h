@@ -0,0 +1,204 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+// This file is part of LookupTable <https://github.com/zjldemers/LookupTable>.
+// 
+// MIT License
+// Copyright (c) 2022 Zachary J. L. Demers
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef _ZJLD_LOOKUP_TABLE_VARIANT_H_
+#define _ZJLD_LOOKUP_TABLE_VARIANT_H_
+
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+#include "LookupTableFixed.h"
+#include "LookupTable2D.h"
+#include "LookupTable3D.h"
+
+
+namespace zjld // feel free to remove/rename as the license above allows
+{
+
+	// These function objects are what LookupTableVariant::Visit passes to its visitors: a
+	// reference to a table of one concrete type whose call operator looks up a point by
+	// its values without any virtual dispatch, so that a loop over many points compiles
+	// against that one type (and the fixed-N lookups inline into the loop).  Each takes
+	// the Dimensions() values of a point and returns the same result as the table's own
+	// QueryByValues.  kDimensions is that count when it is known at compile time, or 0 for
+	// LookupTableND, which lets visitors specialize with if constexpr.
+	// Kernels do not keep the table alive, so they must not outlive it.
+	template<size_t N, size_t... Is>
+	class LookupKernel<LookupTable<N, std::index_sequence<Is...>>>
+	{
+	public:
+		typedef LookupTable<N, std::index_sequence<Is...>> Table;
+		static constexpr size_t kDimensions = N;
+
+	protected:
+		template<size_t I> using Value = typename detail::Repeat<I, const double&>::type;
+
+		const Table* _table;
+
+	public:
+		explicit LookupKernel(const Table& aTable)
+			: _table{ &aTable }
+		{}
+
+		utils::Result<double> operator()(const double* aValueInputs) const {
+			return _table->QueryByValues(aValueInputs[Is]...);
+		}
+		utils::Result<double> operator()(Value<Is>... aValues) const {
+			return _table->QueryByValues(aValues...);
+		}
+
+		size_t Dimensions() const { return N; }
+		const Table& Target() const { return *_table; }
+	};
+
+	template<>
+	class LookupKernel<LookupTableND>
+	{
+	public:
+		typedef LookupTableND Table;
+		static constexpr size_t kDimensions = 0; // only known at run time (see Dimensions)
+
+	protected:
+		const Table* _table;
+
+	public:
+		explicit LookupKernel(const Table& aTable)
+			: _table{ &aTable }
+		{}
+
+		utils::Result<double> operator()(const double* aValueInputs) const {
+			double value;
+			const utils::ErrorCode error = _table->FindByValues(aValueInputs,
+				_table->Dimensions(), nullptr, &value);
+			return (error == utils::ErrorCode::None)
+				? utils::Result<double>(value) : utils::Result<double>(error);
+		}
+
+		size_t Dimensions() const { return _table->Dimensions(); }
+		const Table& Target() const { return *_table; }
+	};
+
+
+	// This class holds a table whose concrete type is picked from its number of dimensions
+	// each time it is populated: LookupTable2D, LookupTable3D, or LookupTableND for any
+	// other count.  While the LookupByValues and QueryByValues methods of those classes
+	// are virtual, so that calls through a LookupTableND reference cannot be inlined, this
+	// dispatches statically instead:
+	// - Its own lookup methods switch on the type once per call, then call that type's
+	//   implementation directly, with results identical to those of the held table
+	// - Visit resolves the type once for a whole block of work, passing the visitor a
+	//   LookupKernel of that type (see above), e.g.
+	//     lut.Visit([&](const auto& aKernel) {
+	//         for (size_t i = 0; i < count; i++)
+	//             outValues[i] = aKernel(&points[i * dims]).Value(); });
+	//   where the visitor is compiled once per type
+	// Table() returns the held table as a LookupTableND for everything else, so existing
+	// code using the polymorphic interface is unaffected (its methods still dispatch as
+	// before).  Thread safety is that of the held table.
+	class LookupTableVariant
+	{
+	public:
+		typedef std::variant<LookupTableND, LookupTable2D, LookupTable3D> Alternatives;
+
+	protected:
+		Alternatives _table; // the held table, of the type chosen by PopulateData
+
+	public:
+	// ==== Begin Section: Construction (Public) ==== //
+		/* These mirror the LookupTableND constructors, holding an invalid LookupTableND
+		* until populated.
+		*/
+		LookupTableVariant();
+		LookupTableVariant(const TableDataSet& aFullDataSet);
+		LookupTableVariant(TableDataSet&& aFullDataSet);
+		LookupTableVariant(const TableDataSet& aFullDataSet,
+			const TableOptions& aOptions);
+		LookupTableVariant(TableDataSet&& aFullDataSet,
+			const TableOptions& aOptions);
+
+		/* These replace the held table with one of the type matching the dimensions of
+		* aFullDataSet, populated with it and the current options (see LookupTableND).
+		*/
+		bool PopulateData(const TableDataSet& aFullDataSet);
+		bool PopulateData(TableDataSet&& aFullDataSet);
+		void SetOptions(const TableOptions& aOptions);
+		const TableOptions& Options() const;
+	// ==== End Section: Construction (Public) ==== //
+
+
+
+	// ==== Begin Section: Lookup Methods (Public) ==== //
+		/* The same as those of LookupTableND (the held table's own implementation is used).
+		*/
+		double LookupByValues(const std::vector<double>& aValueInputs) const;
+		bool QueryByValues(const std::vector<double>& aValueInputs,
+			double* outValue,
+			std::string* outErrMsg) const;
+		utils::Result<double> QueryByValues(const std::vector<double>& aValueInputs) const;
+
+		/* Calls aVisitor with the LookupKernel of the held table, returning its result
+		* (which must be of the same type for every kernel).
+		*/
+		template<typename TVisitor>
+		decltype(auto) Visit(TVisitor&& aVisitor) const;
+	// ==== End Section: Lookup Methods (Public) ==== //
+
+
+
+	// ==== Begin Section: Metadata (Public) ==== //
+		const LookupTableND& Table() const; // the held table, for the polymorphic interface
+		LookupTableND& Table();
+		bool Valid() const;
+		size_t Dimensions() const;
+
+		/* Returns the held table if it is a TTable (one of Alternatives), or null.
+		*/
+		template<typename TTable>
+		const TTable* Get() const { return std::get_if<TTable>(&_table); }
+	// ==== End Section: Metadata (Public) ==== //
+
+	protected:
+		/* Replaces the held table with a default constructed one of the type for
+		* aDimensions dimensions, returning it.
+		*/
+		LookupTableND& Reset(const size_t& aDimensions);
+	};
+
+
+
+
+	// ==== Begin Section: Lookup Methods (Public) ==== //
+	template<typename TVisitor>
+	decltype(auto) LookupTableVariant::Visit(TVisitor&& aVisitor) const
+	{
+		return std::visit([&](const auto& aTable) -> decltype(auto) {
+			return aVisitor(LookupKernel<std::decay_t<decltype(aTable)>>(aTable)); }, _table);
+	}
+	// ==== End Section: Lookup Methods (Public) ==== //
+}
+
+#endif // _ZJLD_LOOKUP_TABLE_VARIANT_H_
@@ -0,0 +1,352 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+// This file is part of LookupTable <https://github.com/zjldemers/LookupTable>.
+// 
+// MIT License
+// Copyright (c) 2022 Zachary J. L. Demers
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "LookupTrace.h"
+#include <atomic>
+#include <cstring>
+#include <map>
+#include "LookupFile.h"
+#include "LookupTableND.h"
+
+using namespace zjld; // feel free to remove/rename as the license above allows
+using namespace zjld::trace;
+using std::string;
+
+
+namespace
+{
+	const char kMagic[8] = { 'Z', 'J', 'L', 'D', 'T', 'R', 'C', '\0' };
+
+	// Source of LookupTraceRecorder ids, starting from 1 since the thread caches start at 0
+	std::atomic<uint64_t> gNextRecorderId{ 1 };
+}
+
+
+
+
+// ==== Begin Section: Trace Helpers (Public) ==== //
+bool trace::Enabled()
+{
+#if defined(ZJLD_LOOKUP_TRACE)
+	return true;
+#else
+	return false;
+#endif
+}
+
+uint64_t trace::Fingerprint(const LookupTableND& aTable)
+{
+	uint64_t hash = file::kChecksumSeed;
+	for (size_t d = 0; d < aTable.Dimensions(); d++) {
+		const TableData& breakpoints = aTable.Axis(d).Data();
+		const uint64_t size = breakpoints.size();
+		hash = file::Checksum(&size, sizeof(size), hash);
+		hash = file::Checksum(breakpoints.data(), breakpoints.size() * sizeof(double), hash);
+	}
+	return hash;
+}
+// ==== End Section: Trace Helpers (Public) ==== //
+
+
+
+
+// ==== Begin Section: LookupTraceRecorder (Public) ==== //
+LookupTraceRecorder::LookupTraceRecorder()
+	: _written{ 0 }
+	, _failed{ false }
+	, _open{ false }
+	, _id{ 0 }
+	, _dims{ 0 }
+	, _sampleInterval{ 0 }
+{
+}
+
+LookupTraceRecorder::~LookupTraceRecorder()
+{
+	Close();
+}
+
+bool LookupTraceRecorder::Open(const string& aPath,
+	const LookupTableND& aTable,
+	const uint32_t& aSampleInterval,
+	string* outErrMsg)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	string errMsg;
+	if (_open.load(std::memory_order_relaxed)) {
+		errMsg = "Unable to open " + aPath + " while already recording to " + _path + ".";
+	}
+	else if (!aTable.Valid()) {
+		errMsg = "Unable to trace invalid table.";
+	}
+	else if (aSampleInterval == 0) {
+		errMsg = "Invalid sample interval provided: 0";
+	}
+	else {
+		Header header = {};
+		std::memcpy(header.magic, kMagic, sizeof(kMagic));
+		header.version = kVersion;
+		header.byteOrder = kByteOrderMark;
+		header.headerBytes = static_cast<uint32_t>(kHeaderBytes);
+		header.dimensions = static_cast<uint32_t>(aTable.Dimensions());
+		header.sampleInterval = aSampleInterval;
+		header.fingerprint = Fingerprint(aTable);
+
+		_stream.clear();
+		_stream.open(aPath, std::ios::binary | std::ios::trunc);
+		_stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		if (_stream) {
+			_path = aPath;
+			_id = gNextRecorderId.fetch_add(1, std::memory_order_relaxed);
+			_written = 0;
+			_failed = false;
+			_dims = aTable.Dimensions();
+			_sampleInterval = aSampleInterval;
+			_open.store(true, std::memory_order_release);
+			return true;
+		}
+		_stream.close();
+		errMsg = "Unable to write " + aPath + ".";
+	}
+	if (outErrMsg) {
+		*outErrMsg = errMsg;
+	}
+	return false;
+}
+
+bool LookupTraceRecorder::Close(string* outErrMsg)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (!_open.load(std::memory_order_relaxed))
+		return true;
+	_open.store(false, std::memory_order_release);
+	for (std::unique_ptr<ThreadBuffer>& buffer : _buffers) {
+		if (buffer->count > 0) {
+			WriteChunk(*buffer);
+		}
+		_retired.push_back(std::move(buffer));
+	}
+	_buffers.clear();
+	_stream.close();
+	_failed = _failed || !_stream;
+	if (_failed && outErrMsg) {
+		*outErrMsg = "Unable to write " + _path + ".";
+	}
+	return !_failed;
+}
+
+bool LookupTraceRecorder::IsOpen() const
+{
+	return _open.load(std::memory_order_acquire);
+}
+size_t LookupTraceRecorder::Dimensions() const
+{
+	return IsOpen() ? _dims : 0;
+}
+uint32_t LookupTraceRecorder::SampleInterval() const
+{
+	return IsOpen() ? _sampleInterval : 0;
+}
+
+uint64_t LookupTraceRecorder::RecordedCount()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	uint64_t count = _written;
+	for (const std::unique_ptr<ThreadBuffer>& buffer : _buffers) {
+		count += buffer->count;
+	}
+	return count;
+}
+
+void LookupTraceRecorder::RecordBatch(const double* const* aDimValues,
+	const size_t& aCount)
+{
+	if (!_open.load(std::memory_order_acquire))
+		return;
+	ThreadBuffer& buffer = Buffer();
+
+	// Skip straight from one sampled point to the next, then carry the remainder over to
+	// the thread's following lookups
+	size_t i = buffer.countdown - 1;
+	for (; i < aCount; i += _sampleInterval) {
+		double* point = &buffer.values[buffer.count * _dims];
+		for (size_t d = 0; d < _dims; d++) {
+			point[d] = aDimValues[d][i];
+		}
+		if (++buffer.count == kBufferPoints) {
+			Flush(buffer);
+		}
+	}
+	buffer.countdown = static_cast<uint32_t>(i - aCount + 1);
+}
+// ==== End Section: LookupTraceRecorder (Public) ==== //
+
+
+
+
+// ==== Begin Section: LookupTraceRecorder (Protected) ==== //
+ThreadBuffer& LookupTraceRecorder::RegisterThread()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	const std::thread::id self = std::this_thread::get_id();
+	ThreadBuffer* buffer = nullptr;
+	for (const std::unique_ptr<ThreadBuffer>& existing : _buffers) {
+		if (existing->owner == self) {
+			buffer = existing.get();
+			break;
+		}
+	}
+	if (nullptr == buffer) {
+		if (_retired.empty()) {
+			_buffers.push_back(std::unique_ptr<ThreadBuffer>(new ThreadBuffer()));
+		}
+		else {
+			_buffers.push_back(std::move(_retired.back()));
+			_retired.pop_back();
+		}
+		buffer = _buffers.back().get();
+		buffer->values.resize(kBufferPoints * _dims);
+		buffer->count = 0;
+		buffer->owner = self;
+		buffer->thread = static_cast<uint32_t>(_buffers.size() - 1);
+		buffer->countdown = 1; // the thread's first lookup is recorded
+	}
+	tCache = { _id, buffer };
+	return *buffer;
+}
+
+void LookupTraceRecorder::Flush(ThreadBuffer& ioBuffer)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	WriteChunk(ioBuffer);
+	ioBuffer.count = 0;
+}
+
+void LookupTraceRecorder::WriteChunk(const ThreadBuffer& aBuffer)
+{
+	const ChunkHeader chunk = { aBuffer.thread, static_cast<uint32_t>(aBuffer.count) };
+	_stream.write(reinterpret_cast<const char*>(&chunk), sizeof(chunk));
+	_stream.write(reinterpret_cast<const char*>(aBuffer.values.data()),
+		aBuffer.count * _dims * sizeof(double));
+	_failed = _failed || !_stream;
+	_written += aBuffer.count;
+}
+// ==== End Section: LookupTraceRecorder (Protected) ==== //
+
+
+
+
+// ==== Begin Section: LookupTrace (Public) ==== //
+LookupTrace::LookupTrace()
+	: _dims{ 0 }
+	, _sampleInterval{ 0 }
+	, _fingerprint{ 0 }
+{
+}
+
+bool LookupTrace::Load(const string& aPath,
+	string* outErrMsg)
+{
+	_streams = {};
+	_dims = 0;
+	_sampleInterval = 0;
+	_fingerprint = 0;
+
+	std::ifstream stream{ aPath, std::ios::binary };
+	Header header = {};
+	stream.read(reinterpret_cast<char*>(&header), sizeof(header));
+	string errMsg;
+	if (!stream) {
+		errMsg = "Unable to read " + aPath + ".";
+	}
+	else if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) {
+		errMsg = aPath + " is not a lookup trace.";
+	}
+	else if (header.byteOrder != kByteOrderMark) {
+		errMsg = "Unsupported byte order in " + aPath + " (written by a machine of the other byte order).";
+	}
+	else if (header.version != kVersion || header.headerBytes != kHeaderBytes) {
+		errMsg = "Unsupported trace version in " + aPath + ": " + std::to_string(header.version);
+	}
+	else if (header.dimensions == 0 || header.sampleInterval == 0) {
+		errMsg = "Invalid trace header in " + aPath + ".";
+	}
+	else {
+		// Gather each thread's chunks in order
+		std::map<uint32_t, std::vector<double>> points;
+		ChunkHeader chunk;
+		std::vector<double> values;
+		while (errMsg.empty() && stream.read(reinterpret_cast<char*>(&chunk), sizeof(chunk))) {
+			if (chunk.count > kBufferPoints) {
+				errMsg = "Invalid chunk in " + aPath + ": " + std::to_string(chunk.count) + " points";
+				break;
+			}
+			values.resize(static_cast<size_t>(chunk.count) * header.dimensions);
+			if (!stream.read(reinterpret_cast<char*>(values.data()), values.size() * sizeof(double)))
+				break; // cut short, see above
+			std::vector<double>& threadPoints = points[chunk.thread];
+			threadPoints.insert(threadPoints.end(), values.begin(), values.end());
+		}
+		if (errMsg.empty()) {
+			for (auto& threadPoints : points) {
+				_streams.push_back({ threadPoints.first, std::move(threadPoints.second) });
+			}
+			_dims = header.dimensions;
+			_sampleInterval = header.sampleInterval;
+			_fingerprint = header.fingerprint;
+			return true;
+		}
+	}
+	if (outErrMsg) {
+		*outErrMsg = errMsg;
+	}
+	return false;
+}
+
+size_t LookupTrace::Dimensions() const
+{
+	return _dims;
+}
+uint32_t LookupTrace::SampleInterval() const
+{
+	return _sampleInterval;
+}
+uint64_t LookupTrace::Fingerprint() const
+{
+	return _fingerprint;
+}
+size_t LookupTrace::PointCount() const
+{
+	size_t count = 0;
+	for (const Stream& stream : _streams) {
+		count += stream.points.size();
+	}
+	return _dims ? count / _dims : 0;
+}
+const std::vector<LookupTrace::Stream>& LookupTrace::Streams() const
+{
+	return _streams;
+}
+// ==== End Section: LookupTrace (Public) ==== //
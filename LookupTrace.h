@@ -0,0 +1,271 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+// This file is part of LookupTable <https://github.com/zjldemers/LookupTable>.
+// 
+// MIT License
+// Copyright (c) 2022 Zachary J. L. Demers
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef _ZJLD_LOOKUP_TRACE_H_
+#define _ZJLD_LOOKUP_TRACE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Recording lookups into traces is opt-in: the hooks on the lookup paths are only compiled
+// in when ZJLD_LOOKUP_TRACE is defined (for every file including the LookupTable headers,
+// e.g. through the ZJLD_LOOKUP_TRACE option of the CMake project).  Otherwise they compile
+// to nothing and tables ignore their recorder (see LookupTableND::SetTraceRecorder).
+#if defined(ZJLD_LOOKUP_TRACE)
+	#define ZJLD_LOOKUP_TRACE_ONLY(...) __VA_ARGS__
+#else
+	#define ZJLD_LOOKUP_TRACE_ONLY(...)
+#endif
+
+namespace zjld // feel free to remove/rename as the license above allows
+{
+	class LookupTableND;
+
+
+	namespace trace
+	{
+		// Trace format (version 1), with all values in the byte order of the machine that
+		// wrote the file (files from a machine of the other byte order are rejected):
+		// - Header: the Header struct below (kHeaderBytes bytes)
+		// - Chunks until the end of the file: a ChunkHeader followed by its count points of
+		//   dimensions doubles each, in the order the thread looked them up
+		// Each thread writes a chunk whenever its buffer fills (and when the trace is
+		// closed), so the chunks of different threads are interleaved while those of one
+		// thread are in order.
+		static const uint32_t kVersion = 1;
+		static const uint32_t kByteOrderMark = 0x01020304;
+		static const size_t kHeaderBytes = 64;
+
+		struct Header
+		{
+			char magic[8];           // "ZJLDTRC" (null terminated)
+			uint32_t version;        // kVersion
+			uint32_t byteOrder;      // kByteOrderMark as written by the creating machine
+			uint32_t headerBytes;    // kHeaderBytes
+			uint32_t dimensions;     // values per point
+			uint32_t sampleInterval; // one in this many lookups of each thread was recorded
+			uint32_t reserved0;      // zero
+			uint64_t fingerprint;    // of the table's breakpoints (see Fingerprint)
+			uint8_t reserved[kHeaderBytes - 40]; // zero
+		};
+		static_assert(sizeof(Header) == kHeaderBytes, "Unexpected trace header size.");
+
+		struct ChunkHeader
+		{
+			uint32_t thread; // order in which the thread recorded its first point
+			uint32_t count;  // points in the chunk
+		};
+
+		// Points buffered per thread before being written as a chunk
+		static const size_t kBufferPoints = 4096;
+
+		/* This returns true if the recording hooks are compiled in (see ZJLD_LOOKUP_TRACE).
+		*/
+		bool Enabled();
+
+		/* This returns a 64-bit FNV-1a hash of aTable's breakpoints (each dimension's size
+		* followed by its breakpoints, see file::Checksum), identifying the grid its lookups
+		* searched regardless of its dependent values, storage or options.  Tables loaded
+		* from the same binary file, or rebuilt with new options, have the same fingerprint.
+		*/
+		uint64_t Fingerprint(const LookupTableND& aTable);
+
+
+		// The points recorded by one thread, only ever written by that thread until the
+		// recorder is closed (see LookupTraceRecorder)
+		struct alignas(64) ThreadBuffer
+		{
+			std::vector<double> values; // kBufferPoints points of the recorder's dimensions
+			size_t count;               // points held in values
+			std::thread::id owner;      // the thread recording into it
+			uint32_t thread;            // see ChunkHeader
+			uint32_t countdown;         // lookups until the next one recorded
+		};
+
+		// The calling thread's buffer for the recorder with the given id (see
+		// LookupTraceRecorder::Buffer), so that only a thread's first lookup after opening
+		// a trace needs to find its buffer
+		struct ThreadCache
+		{
+			uint64_t recorder;
+			ThreadBuffer* buffer;
+		};
+		inline thread_local ThreadCache tCache{ 0, nullptr };
+	}
+
+
+	// This records a sample of the lookups by values of the tables it is attached to (see
+	// LookupTableND::SetTraceRecorder) into a trace file, for replaying them (e.g. with the
+	// lookup_trace_replay tool of bench/) to tune a table against a real query stream.
+	// Every point of a batch counts as a lookup, recorded by the thread making the batch
+	// call.  Each thread keeps every sampleInterval-th of its lookups in its own buffer,
+	// without any locks or atomic read-modify-writes, and only takes the recorder's lock
+	// to write out a full buffer of trace::kBufferPoints points (and on its first lookup).
+	// All of the attached tables must have the same breakpoints as the one the trace was
+	// opened for.  Tables may stay attached while the recorder is closed: their lookups
+	// then check that it is closed (one atomic load) and record nothing.
+	class LookupTraceRecorder
+	{
+		std::mutex _mutex;    // guards the members below up to _failed
+		std::ofstream _stream;
+		std::string _path;
+		std::vector<std::unique_ptr<trace::ThreadBuffer>> _buffers; // of every thread
+		                                                            // since opening
+		std::vector<std::unique_ptr<trace::ThreadBuffer>> _retired; // of earlier openings,
+		                      // reused by later ones and only freed with the recorder, so
+		                      // that no thread's cached buffer is ever freed under it
+		uint64_t _written;    // points written to the file so far
+		bool _failed;         // true once a write has failed
+
+		// Set by Open before _open is set (with release ordering), and only read by the
+		// lookups once they have seen it set (with acquire ordering)
+		std::atomic<bool> _open;
+		uint64_t _id;         // unique to each opening (see trace::ThreadCache)
+		size_t _dims;
+		uint32_t _sampleInterval;
+
+	public:
+		LookupTraceRecorder();
+		~LookupTraceRecorder(); // closes the trace, if open
+		LookupTraceRecorder(const LookupTraceRecorder&) = delete;
+		LookupTraceRecorder& operator=(const LookupTraceRecorder&) = delete;
+
+		/* This creates (or truncates) the trace file at aPath for lookups on tables with
+		* the breakpoints of aTable, keeping one in every aSampleInterval lookups of each
+		* thread (1 keeps them all), starting with its first.  It returns false, with a
+		* reason in outErrMsg (if not null), if already open, if aTable is invalid or
+		* aSampleInterval is 0, or if the file could not be written.  It may be called
+		* while the attached tables are in use, whose lookups start recording once it has
+		* returned true.
+		*/
+		bool Open(const std::string& aPath,
+			const LookupTableND& aTable,
+			const uint32_t& aSampleInterval,
+			std::string* outErrMsg);
+
+		/* This writes out the remaining buffered points and closes the file, returning false
+		* (with a reason in outErrMsg, if not null) if any write since Open failed.  It
+		* reads the buffers of the recording threads, so no lookups may be in progress on
+		* the attached tables while it runs (which would be a data race): stop them, or
+		* detach the tables and let the lookups in progress finish, first.  Lookups made
+		* after it has returned record nothing.  Closing a recorder that is not open does
+		* nothing and returns true.
+		*/
+		bool Close(std::string* outErrMsg = nullptr);
+
+		bool IsOpen() const;
+		size_t Dimensions() const;      // values per point (0 unless open)
+		uint32_t SampleInterval() const; // see Open (0 unless open)
+
+		/* This returns the number of points recorded so far, both written and buffered.
+		* It must not be called while any of the attached tables are in use.
+		*/
+		uint64_t RecordedCount();
+
+		/* These record the lookup of the point at aValues (Dimensions() values) or of the
+		* aCount points of a batch given as one array per dimension, if sampled.  They are
+		* called by the lookups of the attached tables.
+		*/
+		void Record(const double* aValues)
+		{
+			if (!_open.load(std::memory_order_acquire))
+				return;
+			trace::ThreadBuffer& buffer = Buffer();
+			if (--buffer.countdown != 0)
+				return;
+			buffer.countdown = _sampleInterval;
+			double* point = &buffer.values[buffer.count * _dims];
+			for (size_t d = 0; d < _dims; d++) {
+				point[d] = aValues[d];
+			}
+			if (++buffer.count == trace::kBufferPoints) {
+				Flush(buffer);
+			}
+		}
+		void RecordBatch(const double* const* aDimValues,
+			const size_t& aCount);
+
+	protected:
+		/* This returns the calling thread's buffer, finding it (or registering it on the
+		* thread's first lookup) whenever the thread last recorded into another recorder.
+		*/
+		trace::ThreadBuffer& Buffer()
+		{
+			const trace::ThreadCache& cache = trace::tCache;
+			return (cache.recorder == _id) ? *cache.buffer : RegisterThread();
+		}
+		trace::ThreadBuffer& RegisterThread();
+
+		/* This writes ioBuffer's points to the file as one chunk and empties it.
+		*/
+		void Flush(trace::ThreadBuffer& ioBuffer);
+		void WriteChunk(const trace::ThreadBuffer& aBuffer); // with _mutex held
+	};
+
+
+	// The contents of a trace file written by LookupTraceRecorder, with the points of each
+	// thread gathered in the order it looked them up.
+	class LookupTrace
+	{
+	public:
+		struct Stream
+		{
+			uint32_t thread;            // see trace::ChunkHeader
+			std::vector<double> points; // Dimensions() values per point
+		};
+
+	private:
+		std::vector<Stream> _streams; // ordered by thread
+		size_t _dims;
+		uint32_t _sampleInterval;
+		uint64_t _fingerprint;
+
+	public:
+		LookupTrace();
+
+		/* This reads the trace file at aPath, returning false (with a reason in outErrMsg,
+		* if not null) and leaving the trace empty if it is not a valid trace.  A final
+		* chunk cut short (e.g. by the process ending before the trace was closed) is
+		* dropped.
+		*/
+		bool Load(const std::string& aPath,
+			std::string* outErrMsg);
+
+		size_t Dimensions() const;        // values per point (0 if empty)
+		uint32_t SampleInterval() const;  // see LookupTraceRecorder::Open
+		uint64_t Fingerprint() const;     // see trace::Fingerprint
+		size_t PointCount() const;        // summed over every stream
+		const std::vector<Stream>& Streams() const;
+	};
+}
+
+#endif // _ZJLD_LOOKUP_TRACE_H_
@@ -27,83 +27,191 @@
 #ifndef ZJLD_UTILS_H_
 #define ZJLD_UTILS_H_
 
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
 #include <string>
+#include <vector>
+
+// Functions marked with this are compiled for both the host and the device when built by
+// nvcc (see LookupCuda.cu), and are plain functions otherwise.  They may call the other
+// constexpr helpers here, which needs nvcc's --expt-relaxed-constexpr.
+#if defined(__CUDACC__)
+#define ZJLD_LOOKUP_HOST_DEVICE __host__ __device__
+#else
+#define ZJLD_LOOKUP_HOST_DEVICE
+#endif
 
 namespace zjld  // feel free to remove/rename as the license above allows
 {
 	namespace utils
 	{
 
+		// The reasons an operation on a table can fail, as reported by the Query methods
+		// (which never throw to do so).  See ErrorCodeMessage for their descriptions.
+		enum class ErrorCode : uint8_t {
+			None,             // no error
+			Uninitialized,    // a default constructed Result
+			InvalidTable,     // the table is not valid (e.g. not yet populated)
+			NullPointer,      // a required pointer argument was null
+			WrongInputCount,  // not exactly one input per independent variable
+			IndexOutOfBounds, // an index input is beyond the data of its dimension
+			ValueOutOfBounds, // a value input is outside the data of its dimension (or NaN)
+			OutOfBounds,      // a value outside of the bounds given to Result
+			InvalidDimension, // a dimension beyond those of the table
+			NoSolution,       // no input gives the target of an inverse lookup
+			Unsupported       // not supported with the table's options (e.g. its interpolation)
+		};
+
+		// Returns a description of aCode, which is a string literal (so nothing is
+		// allocated until a std::string is built from it, if ever)
+		static const char* ErrorCodeMessage(const ErrorCode aCode)
+		{
+			switch (aCode) {
+			case ErrorCode::None: return "";
+			case ErrorCode::Uninitialized: return "Uninitialized.";
+			case ErrorCode::InvalidTable: return "Unable to operate on invalid table.";
+			case ErrorCode::NullPointer: return "Null pointer provided as input.";
+			case ErrorCode::WrongInputCount: return "Must provide one input per independent variable.";
+			case ErrorCode::IndexOutOfBounds: return "Index given is outside of data bounds.";
+			case ErrorCode::ValueOutOfBounds: return "Value given is outside of data bounds (rejected by the dimension's Error bound policy) or NaN.";
+			case ErrorCode::OutOfBounds: return "Out of bounds.";
+			case ErrorCode::InvalidDimension: return "Invalid dimension provided.";
+			case ErrorCode::NoSolution: return "No input within the data bounds gives the target value.";
+			case ErrorCode::Unsupported: return "Not supported with the table's interpolation.";
+			}
+			return "Unknown error.";
+		}
+
+		// A value or the reason it could not be produced.  Only the ErrorCode is stored, so
+		// a Result is as cheap to return on failure as on success, and the message is only
+		// built if ErrorMessage is called.  Everything but ErrorMessage is constexpr (for
+		// StaticLookupTable).
 		template<typename T>
 		class Result {
-			T           _value;
-			bool        _valid;
-			std::string _errMsg;
+			T         _value;
+			ErrorCode _error;
 
 		public:
-			Result()
+			constexpr Result()
 				: _value{ T() }
-				, _valid{ false }
-				, _errMsg{ "Uninitialized." }
+				, _error{ ErrorCode::Uninitialized }
 			{}
-			explicit Result(const T& aValue)
+			constexpr explicit Result(const T& aValue)
 				: _value{ aValue }
-				, _valid{ true }
-				, _errMsg{ "" }
+				, _error{ ErrorCode::None }
 			{}
-			Result(const std::string& aErrMsg)
+			constexpr Result(const ErrorCode& aError)
 				: _value{ T() }
-				, _valid{ false }
-				, _errMsg{ aErrMsg }
+				, _error{ aError }
 			{}
-			Result(const char* aErrMsg)
-				: Result(std::string(aErrMsg))
+			constexpr Result(const T& aValue, const T& aHighBound, const T& aLowBound = T())
+				: _value{ aValue }
+				, _error{ (aValue < aLowBound || aValue >= aHighBound)
+					? ErrorCode::OutOfBounds : ErrorCode::None }
 			{}
-			Result(const T& aValue, const T& aHighBound, const T& aLowBound = T())
-			{
-				_value = aValue;
-				if (_value < aLowBound || _value >= aHighBound)
-					ErrorMessage("Out of bounds.");
-				else
-					Valid(true);
-			}
 
-			T Value() const { return _value; }
-			void Value(const T& aValue) { _value = aValue; }
+			constexpr T Value() const { return _value; }
+			constexpr void Value(const T& aValue) { _value = aValue; }
 
-			bool Valid() const { return _valid; }
-			void Valid(const bool& aValid) {
-				_valid = aValid;
-				if (_valid)
-					_errMsg.clear();
+			constexpr bool Valid() const { return _error == ErrorCode::None; }
+			constexpr void Valid(const bool& aValid) {
+				if (aValid)
+					_error = ErrorCode::None;
+				else if (_error == ErrorCode::None)
+					_error = ErrorCode::Uninitialized;
 			}
 
-			const std::string& ErrorMessage() const { return _errMsg; }
-			void ErrorMessage(const std::string& aErrMsg) {
-				_errMsg = aErrMsg;
-				if (!_errMsg.empty())
-					_valid = false;
-			}
+			constexpr ErrorCode Error() const { return _error; }
+			constexpr void Error(const ErrorCode& aError) { _error = aError; }
+
+			std::string ErrorMessage() const { return ErrorCodeMessage(_error); }
+		};
+
+
+		// Working storage for aSize elements, kept on the stack for up to kFastSize of them
+		// and only allocated beyond that (e.g. for tables with more dimensions than
+		// LookupTableND::kMaxFastDimensions)
+		template<typename T, size_t kFastSize>
+		class Scratch {
+			T              _fast[kFastSize];
+			std::vector<T> _heap;
+
+		public:
+			explicit Scratch(const size_t aSize)
+				: _heap(aSize > kFastSize ? aSize : 0)
+			{}
+			Scratch(const Scratch&) = delete;
+			Scratch& operator=(const Scratch&) = delete;
+
+			T* Data() { return _heap.empty() ? _fast : _heap.data(); }
 		};
 
 
 		// Determine if two doubles are close enough to be considered approximately equal
-		static bool IsApproxEqual(const double A,
+		static constexpr bool IsApproxEqual(const double A,
 			const double B)
 		{
-			double diff = std::abs(A - B);	// get the absolute value of the difference
-			double max = std::max(A, B);	// get the maximum value between the two
+			// (std::abs is not constexpr until C++23, so the magnitudes are taken directly)
+			double diff = (A > B) ? A - B : B - A;	// get the absolute value of the difference
+			double max = std::max((A < 0.0) ? -A : A, (B < 0.0) ? -B : B); // get the maximum magnitude
 
 			// Calculate an epsilon value (very, very small) with a buffer for a "close enough" equality
 			double eps = max * std::numeric_limits<double>::epsilon() * 5.0;
 			return (diff <= eps); // If diff <= epsilon, they are approximately equal
 		}
 
+		// Minimal allocator for standard containers whose storage must start on a kAlignment
+		// byte boundary (e.g. a 64 byte cache line).
+		template<typename T, size_t kAlignment>
+		struct AlignedAllocator {
+			typedef T value_type;
+			template<typename U>
+			struct rebind { typedef AlignedAllocator<U, kAlignment> other; };
+
+			AlignedAllocator() noexcept {}
+			template<typename U>
+			AlignedAllocator(const AlignedAllocator<U, kAlignment>&) noexcept {}
+
+			T* allocate(const size_t aCount)
+			{
+				return static_cast<T*>(::operator new(aCount * sizeof(T),
+					std::align_val_t(kAlignment)));
+			}
+			void deallocate(T* aPtr, const size_t) noexcept
+			{
+				::operator delete(aPtr, std::align_val_t(kAlignment));
+			}
+
+			template<typename U>
+			bool operator==(const AlignedAllocator<U, kAlignment>&) const noexcept { return true; }
+			template<typename U>
+			bool operator!=(const AlignedAllocator<U, kAlignment>&) const noexcept { return false; }
+		};
+
+		// Number of 64-bit words needed for a status bitmask covering aCount batch points,
+		// where point i is represented by bit (i % 64) of word (i / 64).
+		static constexpr size_t BatchMaskWords(const size_t aCount)
+		{
+			return (aCount + 63) / 64;
+		}
+
+		// Returns true if point aIndex is flagged as valid in a batch status bitmask.
+		static constexpr bool BatchMaskTest(const uint64_t* aMask,
+			const size_t aIndex)
+		{
+			return (aMask[aIndex / 64] >> (aIndex % 64)) & 1;
+		}
+
+
 		// Standard linear interpolation - gets the value that would be found between aValA
 		// and aValB if progressed linearly by aPercentProgress (e.g. aValA=2.0, aValB=3.5,
 		// aPercentProgress=0.5 -> return 2.75).
 		// Note: allows for extrapolation if aPercentProgress < 0.0 or aPercentProgress > 1.0
-		static double Lerp(const double aValA,
+		static constexpr double Lerp(const double aValA,
 			const double aValB,
 			const double aPercentProgress)
 		{
@@ -113,7 +221,7 @@ namespace zjld  // feel free to remove/rename as the license above allows
 		// Inverted linear interpolation - returns the percentage aValToCompare is between
 		// aValA and aValB (e.g. aValA=2.0, aValB=3.5, aValToCompare=2.75 -> return 0.5)
 		// Note: allows for extrapolation if aValToCompare < aValA or aValToCompare > aValB
-		static double ILerp(const double aValA,
+		static constexpr double ILerp(const double aValA,
 			const double aValB,
 			const double aValToCompare)
 		{
@@ -127,6 +235,15 @@ namespace zjld  // feel free to remove/rename as the license above allows
 
 
 	}
+
+
+	namespace detail
+	{
+		// Maps every index of a parameter pack to the same type T, which allows the
+		// LookupTable<N> and StaticLookupTable methods to take exactly N scalar arguments
+		template<size_t, typename T>
+		struct Repeat { typedef T type; };
+	}
 }
 
 #endif // ZJLD_UTILS_H_
@@ -0,0 +1,113 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+// This file is part of LookupTable <https://github.com/zjldemers/LookupTable>.
+// 
+// MIT License
+// Copyright (c) 2022 Zachary J. L. Demers
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+// Benchmarks of the segment search along a single non-uniform axis, comparing the search
+// layouts of LookupAxis (see LookupAxis::SearchLayout) at several axis sizes.
+// - Random: independent queries, measuring throughput
+// - Chained: each query depends on the result of the previous one, measuring latency
+//   (closer to a single table lookup whose result is needed before the next one)
+// Built with Google Benchmark, e.g. from this directory:
+//   g++ -std=c++17 -O2 -I.. LookupAxisBench.cpp ../LookupAxis.cpp -lbenchmark -lpthread
+
+#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
+#include "LookupAxis.h"
+
+using namespace zjld; // feel free to remove/rename as the license above allows
+
+
+namespace
+{
+	const size_t kQueryCount = 1 << 16; // queries cycled through by each benchmark
+
+	// Builds an axis of aSize breakpoints with random (non-uniform) spacing
+	TableData MakeBreakpoints(const size_t aSize)
+	{
+		std::mt19937_64 rng(aSize);
+		std::uniform_real_distribution<double> spacing(0.1, 1.1);
+		TableData data(aSize);
+		double value = 0.0;
+		for (double& breakpoint : data) {
+			breakpoint = value;
+			value += spacing(rng);
+		}
+		return data;
+	}
+
+	// Random query values within the breakpoints
+	std::vector<double> MakeQueries(const TableData& aData)
+	{
+		std::mt19937_64 rng(42);
+		std::uniform_real_distribution<double> position(aData.front(), aData.back());
+		std::vector<double> queries(kQueryCount);
+		for (double& query : queries) {
+			query = position(rng);
+		}
+		return queries;
+	}
+
+	void SearchRandom(benchmark::State& aState,
+		const LookupAxis::SearchLayout aLayout)
+	{
+		const TableData data = MakeBreakpoints(static_cast<size_t>(aState.range(0)));
+		const LookupAxis axis(data, aLayout);
+		const std::vector<double> queries = MakeQueries(data);
+		size_t i = 0;
+		for (auto _ : aState) {
+			benchmark::DoNotOptimize(axis.FindSegment(queries[i]));
+			i = (i + 1) % kQueryCount;
+		}
+		aState.SetItemsProcessed(aState.iterations());
+	}
+
+	void SearchChained(benchmark::State& aState,
+		const LookupAxis::SearchLayout aLayout)
+	{
+		const TableData data = MakeBreakpoints(static_cast<size_t>(aState.range(0)));
+		const LookupAxis axis(data, aLayout);
+		const std::vector<double> queries = MakeQueries(data);
+		size_t i = 0, segment = 0;
+		for (auto _ : aState) {
+			// segment >> 62 is always 0, but makes this query wait on the previous one
+			segment = axis.FindSegment(queries[i] + static_cast<double>(segment >> 62));
+			i = (i + 1) % kQueryCount;
+		}
+		benchmark::DoNotOptimize(segment);
+		aState.SetItemsProcessed(aState.iterations());
+	}
+}
+
+
+#define ZJLD_AXIS_BENCHMARK(aFunc, aLayout) \
+	BENCHMARK_CAPTURE(aFunc, aLayout, LookupAxis::SearchLayout::aLayout) \
+		->Arg(16)->Arg(256)->Arg(4096)->Arg(65536)->Arg(1 << 20)
+
+ZJLD_AXIS_BENCHMARK(SearchRandom, Binary);
+ZJLD_AXIS_BENCHMARK(SearchRandom, Eytzinger);
+ZJLD_AXIS_BENCHMARK(SearchChained, Binary);
+ZJLD_AXIS_BENCHMARK(SearchChained, Eytzinger);
+
+BENCHMARK_MAIN();
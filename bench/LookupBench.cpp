@@ -0,0 +1,278 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+// This file is part of LookupTable <https://github.com/zjldemers/LookupTable>.
+//
+// MIT License
+// Copyright (c) 2022 Zachary J. L. Demers
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+// Benchmarks of single lookups by values through each of the three lookup schemas (see
+// README), covering every combination of:
+// - Table: LookupTableND with N = 2..6, and LookupTable2D/LookupTable3D
+// - Axes: Uniform (evenly spaced, located directly) or NonUniform (searched) breakpoints
+// - Stream: Random (independent points) or Coherent (a slow random walk, as when queried
+//   once per timestep of a simulation)
+// - Bounds: InBounds, or Mixed with 10% of the points outside of the table
+// - Schema: Lookup (catching the exceptions of out of bounds points), QueryOut or
+//   QueryResult
+// The Dispatch benchmarks instead look up every point of a Random/InBounds stream in one
+// loop, through either a LookupTableND reference to a LookupTable2D/LookupTable3D
+// (Virtual) or the LookupKernel passed by LookupTableVariant::Visit (Kernel).
+// Every table holds about 2^20 dependent values.  Names are built from the above (e.g.
+// "ND3/Uniform/Random/InBounds/Lookup"), so subsets can be run with --benchmark_filter.
+// Each reports time/query and queries/s, for comparing before and after a change.
+// Built by the lookup_bench target of the CMake project, or e.g. from this directory:
+//   g++ -std=c++17 -O2 -I.. LookupBench.cpp ../Lookup*.cpp -lbenchmark -lpthread
+
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+#include "LookupTable.h"
+
+using namespace zjld; // feel free to remove/rename as the license above allows
+
+
+namespace
+{
+	const size_t kQueryCount = 1 << 16; // points cycled through by each benchmark
+	const double kMixedOutOfBounds = 0.1; // fraction of points out of bounds when Mixed
+
+	enum class Axes { Uniform, NonUniform };
+	enum class Stream { Random, Coherent };
+	enum class Bounds { InBounds, Mixed };
+	enum class Schema { Lookup, QueryOut, QueryResult };
+
+	// Builds an N-dimensional table of random values with about 2^20 of them, where every
+	// dimension runs from 0 to 1
+	TableDataSet MakeData(const size_t aDimensions,
+		const Axes aAxes)
+	{
+		const size_t size = static_cast<size_t>(std::round(std::pow(1 << 20, 1.0 / aDimensions)));
+		std::mt19937_64 rng(aDimensions);
+		std::uniform_real_distribution<double> spacing(0.1, 1.1), value(-1.0, 1.0);
+		TableDataSet data(aDimensions, TableData(size));
+		for (TableData& breakpoints : data) {
+			double position = 0.0;
+			for (size_t i = 0; i < size; i++) {
+				breakpoints[i] = position;
+				position += (aAxes == Axes::Uniform) ? 1.0 : spacing(rng);
+			}
+			for (double& breakpoint : breakpoints) {
+				breakpoint /= breakpoints.back();
+			}
+		}
+		size_t depSize = 1;
+		for (const TableData& breakpoints : data) {
+			depSize *= breakpoints.size();
+		}
+		TableData depData(depSize);
+		for (double& dep : depData) {
+			dep = value(rng);
+		}
+		data.push_back(std::move(depData));
+		return data;
+	}
+
+	// Builds kQueryCount points of aDimensions values each (within [0, 1] unless out of
+	// bounds), either independent or following a random walk
+	std::vector<std::vector<double>> MakeQueries(const size_t aDimensions,
+		const Stream aStream,
+		const Bounds aBounds)
+	{
+		std::mt19937_64 rng(42);
+		std::uniform_real_distribution<double> position(0.0, 1.0), step(-0.001, 0.001);
+		std::vector<std::vector<double>> queries(kQueryCount, std::vector<double>(aDimensions));
+		std::vector<double> walk(aDimensions, 0.5);
+		for (std::vector<double>& query : queries) {
+			for (size_t d = 0; d < aDimensions; d++) {
+				if (aStream == Stream::Random) {
+					query[d] = position(rng);
+				}
+				else {
+					walk[d] = std::abs(walk[d] + step(rng)); // reflect off of 0...
+					walk[d] = (walk[d] > 1.0) ? 2.0 - walk[d] : walk[d]; // ...and 1
+					query[d] = walk[d];
+				}
+			}
+			if (aBounds == Bounds::Mixed && position(rng) < kMixedOutOfBounds) {
+				query[rng() % aDimensions] += 1.5; // beyond the end of that dimension
+			}
+		}
+		return queries;
+	}
+
+	// Looks up aQuery through kSchema, returning NaN if the point was rejected
+	template<Schema kSchema>
+	double Evaluate(const LookupTableND& aTable,
+		const std::vector<double>& aQuery,
+		std::string* ioErrMsg)
+	{
+		if constexpr (kSchema == Schema::Lookup) {
+			try {
+				return aTable.LookupByValues(aQuery);
+			}
+			catch (const std::exception&) {
+				return std::nan("");
+			}
+		}
+		else if constexpr (kSchema == Schema::QueryOut) {
+			double value;
+			return aTable.QueryByValues(aQuery, &value, ioErrMsg) ? value : std::nan("");
+		}
+		else {
+			const utils::Result<double> result = aTable.QueryByValues(aQuery);
+			return result.Valid() ? result.Value() : std::nan("");
+		}
+	}
+
+	// The same as the above for LookupTable<N>, using its unpacked overloads
+	template<Schema kSchema, size_t N, size_t... Is>
+	double Evaluate(const LookupTable<N, std::index_sequence<Is...>>& aTable,
+		const std::vector<double>& aQuery,
+		std::string* ioErrMsg)
+	{
+		if constexpr (kSchema == Schema::Lookup) {
+			try {
+				return aTable.LookupByValues(aQuery[Is]...);
+			}
+			catch (const std::exception&) {
+				return std::nan("");
+			}
+		}
+		else if constexpr (kSchema == Schema::QueryOut) {
+			double value;
+			return aTable.QueryByValues(aQuery[Is]..., &value, ioErrMsg) ? value : std::nan("");
+		}
+		else {
+			const utils::Result<double> result = aTable.QueryByValues(aQuery[Is]...);
+			return result.Valid() ? result.Value() : std::nan("");
+		}
+	}
+
+	template<typename TTable, Schema kSchema>
+	void LookupByValues(benchmark::State& aState,
+		const size_t aDimensions,
+		const Axes aAxes,
+		const Stream aStream,
+		const Bounds aBounds)
+	{
+		const TTable table(MakeData(aDimensions, aAxes));
+		const std::vector<std::vector<double>> queries = MakeQueries(aDimensions, aStream, aBounds);
+		std::string errMsg;
+		size_t i = 0;
+		for (auto _ : aState) {
+			benchmark::DoNotOptimize(Evaluate<kSchema>(table, queries[i], &errMsg));
+			i = (i + 1) % kQueryCount;
+		}
+		const double queryCount = static_cast<double>(aState.iterations());
+		aState.counters["time/query"] = benchmark::Counter(queryCount,
+			benchmark::Counter::kIsRate | benchmark::Counter::kInvert); // e.g. 52.1ns
+		aState.counters["queries/s"] = benchmark::Counter(queryCount,
+			benchmark::Counter::kIsRate);
+	}
+
+	// Looks up every query in one loop, through the polymorphic interface of the held table
+	// or through the kernel of its concrete type (see the top)
+	template<bool kKernel>
+	void LookupLoop(benchmark::State& aState,
+		const size_t aDimensions)
+	{
+		const LookupTableVariant table(MakeData(aDimensions, Axes::NonUniform));
+		const std::vector<std::vector<double>> queries = MakeQueries(aDimensions,
+			Stream::Random, Bounds::InBounds);
+		const LookupTableND& base = table.Table();
+		for (auto _ : aState) {
+			double sum = 0.0;
+			if constexpr (kKernel) {
+				table.Visit([&](const auto& aKernel) {
+					for (const std::vector<double>& query : queries) {
+						sum += aKernel(query.data()).Value();
+					} });
+			}
+			else {
+				for (const std::vector<double>& query : queries) {
+					sum += base.QueryByValues(query).Value();
+				}
+			}
+			benchmark::DoNotOptimize(sum);
+		}
+		const double queryCount = static_cast<double>(aState.iterations() * kQueryCount);
+		aState.counters["time/query"] = benchmark::Counter(queryCount,
+			benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+		aState.counters["queries/s"] = benchmark::Counter(queryCount,
+			benchmark::Counter::kIsRate);
+	}
+
+	// Registers every Axes/Stream/Bounds/Schema combination for TTable (see the top)
+	template<typename TTable>
+	void RegisterTable(const std::string& aName,
+		const size_t aDimensions)
+	{
+		typedef void (*Function)(benchmark::State&, size_t, Axes, Stream, Bounds);
+		const std::pair<const char*, Axes> axes[] = {
+			{ "Uniform", Axes::Uniform }, { "NonUniform", Axes::NonUniform } };
+		const std::pair<const char*, Stream> streams[] = {
+			{ "Random", Stream::Random }, { "Coherent", Stream::Coherent } };
+		const std::pair<const char*, Bounds> bounds[] = {
+			{ "InBounds", Bounds::InBounds }, { "Mixed", Bounds::Mixed } };
+		const std::pair<const char*, Function> schemas[] = {
+			{ "Lookup", &LookupByValues<TTable, Schema::Lookup> },
+			{ "QueryOut", &LookupByValues<TTable, Schema::QueryOut> },
+			{ "QueryResult", &LookupByValues<TTable, Schema::QueryResult> } };
+
+		for (const auto& axis : axes) {
+			for (const auto& stream : streams) {
+				for (const auto& bound : bounds) {
+					for (const auto& schema : schemas) {
+						const std::string name = aName + "/" + axis.first + "/" + stream.first
+							+ "/" + bound.first + "/" + schema.first;
+						benchmark::RegisterBenchmark(name.c_str(), schema.second, aDimensions,
+							axis.second, stream.second, bound.second);
+					}
+				}
+			}
+		}
+	}
+}
+
+
+int main(int argc, char** argv)
+{
+	for (size_t n = 2; n <= 6; n++) {
+		RegisterTable<LookupTableND>("ND" + std::to_string(n), n);
+	}
+	RegisterTable<LookupTable2D>("Fixed2", 2);
+	RegisterTable<LookupTable3D>("Fixed3", 3);
+	for (size_t n = 2; n <= 3; n++) {
+		const std::string name = "Dispatch" + std::to_string(n);
+		benchmark::RegisterBenchmark((name + "/Virtual").c_str(), &LookupLoop<false>, n);
+		benchmark::RegisterBenchmark((name + "/Kernel").c_str(), &LookupLoop<true>, n);
+	}
+
+	benchmark::Initialize(&argc, argv);
+	if (benchmark::ReportUnrecognizedArguments(argc, argv))
+		return 1;
+	benchmark::RunSpecifiedBenchmarks();
+	benchmark::Shutdown();
+	return 0;
+}
@@ -0,0 +1,184 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+// This file is part of LookupTable <https://github.com/zjldemers/LookupTable>.
+// 
+// MIT License
+// Copyright (c) 2022 Zachary J. L. Demers
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+// Benchmarks of looking up every output of a 3D table with several outputs at one point,
+// either from one LookupTable3D per output (Separate) or from a single LookupTableMulti
+// (Multi), for every combination of:
+// - Outputs: 1, 4 or 12 dependent values per grid point
+// - Axes: Uniform (evenly spaced, located directly) or NonUniform (searched) breakpoints
+// - Stream: Random (independent points) or Coherent (a slow random walk)
+// Every output holds 64^3 values.  Each reports queries/s, where a query gives every output
+// at one point.  Built by the lookup_multi_bench target of the CMake project, or e.g. from
+// this directory:
+//   g++ -std=c++17 -O2 -I.. LookupMultiBench.cpp ../Lookup*.cpp -lbenchmark -lpthread
+
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+#include "LookupTable.h"
+
+using namespace zjld; // feel free to remove/rename as the license above allows
+
+
+namespace
+{
+	const size_t kSize = 64;            // breakpoints per dimension
+	const size_t kQueryCount = 1 << 16; // points cycled through by each benchmark
+
+	enum class Table { Separate, Multi };
+	enum class Axes { Uniform, NonUniform };
+	enum class Stream { Random, Coherent };
+
+	// Builds 3 dimensions of kSize breakpoints from 0 to 1
+	TableDataSet MakeAxes(const Axes aAxes)
+	{
+		std::mt19937_64 rng(3);
+		std::uniform_real_distribution<double> spacing(0.1, 1.1);
+		TableDataSet axes(3, TableData(kSize));
+		for (TableData& breakpoints : axes) {
+			double position = 0.0;
+			for (size_t i = 0; i < kSize; i++) {
+				breakpoints[i] = position;
+				position += (aAxes == Axes::Uniform) ? 1.0 : spacing(rng);
+			}
+			for (double& breakpoint : breakpoints) {
+				breakpoint /= breakpoints.back();
+			}
+		}
+		return axes;
+	}
+
+	// Builds aOutputs dependent data vectors of random values over the grid of MakeAxes
+	TableDataSet MakeOutputs(const size_t aOutputs)
+	{
+		std::mt19937_64 rng(aOutputs);
+		std::uniform_real_distribution<double> value(-1.0, 1.0);
+		TableDataSet outputs(aOutputs, TableData(kSize * kSize * kSize));
+		for (TableData& depData : outputs) {
+			for (double& dep : depData) {
+				dep = value(rng);
+			}
+		}
+		return outputs;
+	}
+
+	// Builds kQueryCount points within [0, 1], either independent or following a random walk
+	std::vector<std::vector<double>> MakeQueries(const Stream aStream)
+	{
+		std::mt19937_64 rng(42);
+		std::uniform_real_distribution<double> position(0.0, 1.0), step(-0.001, 0.001);
+		std::vector<std::vector<double>> queries(kQueryCount, std::vector<double>(3));
+		std::vector<double> walk(3, 0.5);
+		for (std::vector<double>& query : queries) {
+			for (size_t d = 0; d < 3; d++) {
+				if (aStream == Stream::Random) {
+					query[d] = position(rng);
+				}
+				else {
+					walk[d] = std::abs(walk[d] + step(rng)); // reflect off of 0...
+					walk[d] = (walk[d] > 1.0) ? 2.0 - walk[d] : walk[d]; // ...and 1
+					query[d] = walk[d];
+				}
+			}
+		}
+		return queries;
+	}
+
+	void LookupAllOutputs(benchmark::State& aState,
+		const Table aTable,
+		const size_t aOutputs,
+		const Axes aAxes,
+		const Stream aStream)
+	{
+		const TableDataSet axes = MakeAxes(aAxes);
+		const TableDataSet outputs = MakeOutputs(aOutputs);
+		const std::vector<std::vector<double>> queries = MakeQueries(aStream);
+		std::vector<double> values(aOutputs);
+		std::string errMsg;
+		size_t i = 0;
+		if (aTable == Table::Separate) {
+			std::vector<LookupTable3D> tables;
+			for (const TableData& depData : outputs) {
+				TableDataSet data(axes);
+				data.push_back(depData);
+				tables.emplace_back(std::move(data));
+			}
+			for (auto _ : aState) {
+				const std::vector<double>& query = queries[i];
+				for (size_t k = 0; k < aOutputs; k++) {
+					tables[k].QueryByValues(query[0], query[1], query[2], &values[k], &errMsg);
+				}
+				benchmark::DoNotOptimize(values.data());
+				benchmark::ClobberMemory();
+				i = (i + 1) % kQueryCount;
+			}
+		}
+		else {
+			const LookupTableMulti table(axes, outputs);
+			for (auto _ : aState) {
+				table.QueryByValues(queries[i], values.data(), &errMsg);
+				benchmark::DoNotOptimize(values.data());
+				benchmark::ClobberMemory();
+				i = (i + 1) % kQueryCount;
+			}
+		}
+		aState.counters["queries/s"] = benchmark::Counter(static_cast<double>(aState.iterations()),
+			benchmark::Counter::kIsRate);
+	}
+}
+
+
+int main(int argc, char** argv)
+{
+	const std::pair<const char*, Table> tables[] = {
+		{ "Separate", Table::Separate }, { "Multi", Table::Multi } };
+	const size_t outputCounts[] = { 1, 4, 12 };
+	const std::pair<const char*, Axes> axes[] = {
+		{ "Uniform", Axes::Uniform }, { "NonUniform", Axes::NonUniform } };
+	const std::pair<const char*, Stream> streams[] = {
+		{ "Random", Stream::Random }, { "Coherent", Stream::Coherent } };
+	for (const size_t outputs : outputCounts) {
+		for (const auto& axis : axes) {
+			for (const auto& stream : streams) {
+				for (const auto& table : tables) {
+					const std::string name = std::string(table.first) + "/" + std::to_string(outputs)
+						+ "/" + axis.first + "/" + stream.first;
+					benchmark::RegisterBenchmark(name.c_str(), &LookupAllOutputs, table.second,
+						outputs, axis.second, stream.second);
+				}
+			}
+		}
+	}
+
+	benchmark::Initialize(&argc, argv);
+	if (benchmark::ReportUnrecognizedArguments(argc, argv))
+		return 1;
+	benchmark::RunSpecifiedBenchmarks();
+	benchmark::Shutdown();
+	return 0;
+}
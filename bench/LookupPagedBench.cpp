@@ -0,0 +1,187 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+// This file is part of LookupTable <https://github.com/zjldemers/LookupTable>.
+// 
+// MIT License
+// Copyright (c) 2022 Zachary J. L. Demers
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+// Benchmarks of single lookups by values on a table paged from its file (see
+// LookupTableND::LoadBinary with PageOptions), against the same file loaded with
+// FileMode::Copy, for every combination of:
+// - Cache: the page cache holding All of the file, or a Quarter of it
+// - Prefetch: On or Off (see PageOptions::prefetch)
+// - Stream: Random (independent points) or Coherent (a slow random walk)
+// The table is 3D with 128 breakpoints per dimension (16 MB of doubles, stored Tiled),
+// streamed to a file in the working directory by PopulateStream before the benchmarks
+// run and removed afterwards.  Each reports queries/s and the page hit rate (see
+// PageStats::HitRate).  Built by the lookup_paged_bench target of the CMake project, or
+// e.g. from this directory:
+//   g++ -std=c++17 -O2 -I.. LookupPagedBench.cpp ../Lookup*.cpp -lbenchmark -lpthread
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+#include "LookupTable.h"
+
+using namespace zjld; // feel free to remove/rename as the license above allows
+
+
+namespace
+{
+	const char kPath[] = "lookup_paged_bench.lut";
+	const size_t kSize = 128;              // breakpoints per dimension
+	const size_t kQueryCount = 1 << 16;    // points cycled through by each benchmark
+
+	enum class Cache { Copy, All, Quarter };
+	enum class Stream { Random, Coherent };
+
+	TableDataSet MakeAxes()
+	{
+		TableDataSet indepData(3, TableData(kSize));
+		for (TableData& breakpoints : indepData) {
+			for (size_t i = 0; i < kSize; i++) {
+				breakpoints[i] = static_cast<double>(i) / (kSize - 1);
+			}
+		}
+		return indepData;
+	}
+
+	// Streams the table to kPath as Linear, then saves it again Tiled (which pages far
+	// better, see LoadBinary), returning false if either failed
+	bool WriteTable()
+	{
+		std::mt19937_64 rng(3);
+		std::uniform_real_distribution<double> value(-1.0, 1.0);
+		size_t remaining = kSize * kSize * kSize;
+		const DepDataSource source = [&](double* outValues, const size_t& aMaxCount) {
+			const size_t count = std::min(aMaxCount, remaining);
+			for (size_t i = 0; i < count; i++) {
+				outValues[i] = value(rng);
+			}
+			remaining -= count;
+			return count;
+		};
+		LookupTableND streamed;
+		std::string errMsg;
+		if (!streamed.PopulateStream(kPath, MakeAxes(), source, PageOptions(), &errMsg))
+			return false;
+		LookupTableND tiled;
+		TableOptions options;
+		options.dataLayout = TableOptions::DataLayout::Tiled;
+		tiled.SetOptions(options);
+		return tiled.LoadBinary(kPath, FileMode::Copy, &errMsg) && tiled.SaveBinary(kPath, &errMsg);
+	}
+
+	// Builds kQueryCount points within [0, 1], either independent or following a random walk
+	std::vector<std::vector<double>> MakeQueries(const Stream aStream)
+	{
+		std::mt19937_64 rng(42);
+		std::uniform_real_distribution<double> position(0.0, 1.0), step(-0.002, 0.002);
+		std::vector<std::vector<double>> queries(kQueryCount, std::vector<double>(3));
+		std::vector<double> walk(3, 0.5);
+		for (std::vector<double>& query : queries) {
+			for (size_t d = 0; d < 3; d++) {
+				if (aStream == Stream::Random) {
+					query[d] = position(rng);
+				}
+				else {
+					walk[d] = std::abs(walk[d] + step(rng)); // reflect off of 0...
+					walk[d] = (walk[d] > 1.0) ? 2.0 - walk[d] : walk[d]; // ...and 1
+					query[d] = walk[d];
+				}
+			}
+		}
+		return queries;
+	}
+
+	void LookupPaged(benchmark::State& aState,
+		const Cache aCache,
+		const bool aPrefetch,
+		const Stream aStream)
+	{
+		LookupTableND table;
+		std::string errMsg;
+		bool loaded;
+		if (aCache == Cache::Copy) {
+			loaded = table.LoadBinary(kPath, FileMode::Copy, &errMsg);
+		}
+		else {
+			PageOptions pages;
+			pages.cacheBytes = kSize * kSize * kSize * sizeof(double) / (aCache == Cache::All ? 1 : 4);
+			pages.prefetch = aPrefetch;
+			loaded = table.LoadBinary(kPath, pages, &errMsg);
+		}
+		if (!loaded) {
+			aState.SkipWithError(errMsg.c_str());
+			return;
+		}
+
+		const std::vector<std::vector<double>> queries = MakeQueries(aStream);
+		size_t i = 0;
+		for (auto _ : aState) {
+			double value;
+			benchmark::DoNotOptimize(table.QueryByValues(queries[i], &value, &errMsg));
+			i = (i + 1) % kQueryCount;
+		}
+		aState.counters["queries/s"] = benchmark::Counter(static_cast<double>(aState.iterations()),
+			benchmark::Counter::kIsRate);
+		aState.counters["hitRate"] = table.PagingStats().HitRate();
+	}
+}
+
+
+int main(int argc, char** argv)
+{
+	benchmark::Initialize(&argc, argv);
+	if (benchmark::ReportUnrecognizedArguments(argc, argv))
+		return 1;
+	if (!WriteTable()) {
+		std::fprintf(stderr, "Unable to write %s.\n", kPath);
+		std::remove(kPath);
+		return 1;
+	}
+	const std::pair<const char*, Stream> streams[] = {
+		{ "Random", Stream::Random }, { "Coherent", Stream::Coherent } };
+	const std::pair<const char*, Cache> caches[] = {
+		{ "All", Cache::All }, { "Quarter", Cache::Quarter } };
+	for (const auto& stream : streams) {
+		benchmark::RegisterBenchmark((std::string("Copy/") + stream.first).c_str(),
+			&LookupPaged, Cache::Copy, false, stream.second);
+		for (const auto& cache : caches) {
+			for (const bool prefetch : { true, false }) {
+				const std::string name = std::string("Paged/") + cache.first
+					+ (prefetch ? "/PrefetchOn/" : "/PrefetchOff/") + stream.first;
+				benchmark::RegisterBenchmark(name.c_str(), &LookupPaged, cache.second, prefetch,
+					stream.second);
+			}
+		}
+	}
+
+	benchmark::RunSpecifiedBenchmarks();
+	benchmark::Shutdown();
+	std::remove(kPath);
+	return 0;
+}
@@ -0,0 +1,110 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+// This file is part of LookupTable <https://github.com/zjldemers/LookupTable>.
+// 
+// MIT License
+// Copyright (c) 2022 Zachary J. L. Demers
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+// Scaling benchmark of parallel batch evaluation (see
+// LookupTableND::QueryBatchByValuesParallel), running the same large batch on pools of
+// 1, 2, 4, ... threads up to the hardware thread count.  Throughput should grow close to
+// linearly with the thread count until memory bandwidth saturates, which happens sooner
+// for larger tables (whose dependent data does not fit in the caches) than for smaller.
+// Built with Google Benchmark, e.g. from this directory:
+//   g++ -std=c++17 -O2 -I.. LookupParallelBench.cpp ../Lookup*.cpp -lbenchmark -lpthread
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+#include "LookupTable.h"
+
+using namespace zjld; // feel free to remove/rename as the license above allows
+
+
+namespace
+{
+	const size_t kPointCount = 1 << 22; // points per batch
+
+	// Builds a 3D table with aSize random breakpoints along each dimension
+	LookupTable3D MakeTable(const size_t aSize)
+	{
+		std::mt19937_64 rng(aSize);
+		std::uniform_real_distribution<double> spacing(0.1, 1.1), value(-1.0, 1.0);
+		TableDataSet indepData(3, TableData(aSize));
+		for (TableData& breakpoints : indepData) {
+			double position = 0.0;
+			for (double& breakpoint : breakpoints) {
+				breakpoint = position;
+				position += spacing(rng);
+			}
+		}
+		TableData depData(aSize * aSize * aSize);
+		for (double& dep : depData) {
+			dep = value(rng);
+		}
+		return LookupTable3D(std::move(indepData), std::move(depData));
+	}
+
+	void BatchParallel(benchmark::State& aState)
+	{
+		const LookupTable3D table = MakeTable(static_cast<size_t>(aState.range(0)));
+		ThreadPool pool(static_cast<size_t>(aState.range(1)) - 1); // the caller works too
+		const BatchExecutor executor = pool.Executor();
+
+		std::mt19937_64 rng(42);
+		std::vector<std::vector<double>> inputs(3, std::vector<double>(kPointCount));
+		std::vector<const double*> dimValues;
+		for (size_t d = 0; d < 3; d++) {
+			std::uniform_real_distribution<double> position(table.Axis(d).Data().front(),
+				table.Axis(d).Data().back());
+			for (double& input : inputs[d]) {
+				input = position(rng);
+			}
+			dimValues.push_back(inputs[d].data());
+		}
+		std::vector<double> values(kPointCount);
+		std::vector<uint64_t> mask(utils::BatchMaskWords(kPointCount));
+		for (auto _ : aState) {
+			benchmark::DoNotOptimize(table.QueryBatchByValuesParallel(dimValues, kPointCount,
+				values.data(), mask.data(), executor));
+		}
+		aState.SetItemsProcessed(aState.iterations() * kPointCount);
+	}
+
+	void ThreadCounts(benchmark::internal::Benchmark* aBenchmark)
+	{
+		const size_t hardware = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+		for (const long size : { 16, 256 }) { // 32 KB and 128 MB of dependent data
+			for (size_t threads = 1; threads < hardware; threads *= 2) {
+				aBenchmark->Args({ size, static_cast<long>(threads) });
+			}
+			aBenchmark->Args({ size, static_cast<long>(hardware) });
+		}
+	}
+}
+
+
+BENCHMARK(BatchParallel)->Apply(ThreadCounts)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
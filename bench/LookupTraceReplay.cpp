@@ -0,0 +1,378 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+// This file is part of LookupTable <https://github.com/zjldemers/LookupTable>.
+// 
+// MIT License
+// Copyright (c) 2022 Zachary J. L. Demers
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+// Replays a trace recorded by LookupTraceRecorder (see LookupTrace.h) against the table
+// it was recorded on, once per lookup strategy, to tune the table's options against a
+// real query stream rather than a synthetic one.  The table must have been saved with
+// LookupTableND::SaveBinary, and its breakpoints must match the trace's fingerprint.
+//   lookup_trace_replay <table file> <trace file> [seconds per strategy, default 0.5]
+// It first reports, per dimension, whether its axis is uniform, the depth of an unhinted
+// search along it and the distribution of the segment jumps between consecutive points
+// of each recorded thread (a hinted search costs about 2*log2 of the jump, see
+// LookupAxis::FindSegment, while uniform axes need no search at all).  Then each
+// strategy, i.e. every combination of:
+// - Data: Linear, Cells (Linear with TableOptions::precomputeCells), Tiled or Compressed
+// - Search: Binary or Eytzinger (see LookupAxis::SearchLayout)
+// - Mode: Single (unhinted QueryByValues), Hinted (one LookupHint per recorded thread) or
+//   Batch (each recorded thread's points as one QueryBatchByValues)
+// replays every point, repeating until the given time has passed, and reports the time
+// per query, the cache references and misses per query (last level and L1 data, from the
+// perf events of Linux, or n/a elsewhere or if not permitted, see perf_event_paranoid)
+// and, if built with ZJLD_LOOKUP_STATS, the mean search steps taken per dimension.
+// Built by the lookup_trace_replay target of the CMake project (which does not need
+// Google Benchmark), or e.g. from this directory:
+//   g++ -std=c++17 -O2 -I.. LookupTraceReplay.cpp ../Lookup*.cpp -lpthread
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <utility>
+#include <vector>
+#include "LookupTable.h"
+#if defined(__linux__)
+	#include <linux/perf_event.h>
+	#include <sys/ioctl.h>
+	#include <sys/syscall.h>
+	#include <unistd.h>
+	#define ZJLD_LOOKUP_PERF_EVENTS
+#endif
+
+using namespace zjld; // feel free to remove/rename as the license above allows
+
+
+namespace
+{
+	enum class Mode { Single, Hinted, Batch };
+
+	struct Strategy
+	{
+		std::string name;
+		TableOptions::DataLayout dataLayout;
+		bool precomputeCells;
+		LookupAxis::SearchLayout searchLayout;
+		Mode mode;
+	};
+
+	// Jumps of up to 2^(kJumpBins-2) segments are binned by power of two, and any further
+	// ones in the last bin
+	const size_t kJumpBins = 12;
+
+	// The points of one recorded thread, both as points and as a structure of arrays
+	struct ReplayStream
+	{
+		std::vector<std::vector<double>> points;
+		std::vector<std::vector<double>> dimValues;
+		std::vector<const double*> dimPointers;
+		std::vector<double> outValues;
+		std::vector<uint64_t> outValidMask;
+	};
+
+	// Counts of the hardware cache events of the calling thread while running (see the
+	// top), all reading 0 if unavailable
+	class CacheCounters
+	{
+		static const size_t kCounters = 4; // LLC references, LLC misses, L1D reads, misses
+		int _fds[kCounters];
+
+	public:
+		CacheCounters()
+		{
+			std::fill(_fds, _fds + kCounters, -1);
+		#if defined(ZJLD_LOOKUP_PERF_EVENTS)
+			const uint64_t l1Read = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8);
+			const std::pair<uint32_t, uint64_t> events[kCounters] = {
+				{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_REFERENCES },
+				{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+				{ PERF_TYPE_HW_CACHE, l1Read | (PERF_COUNT_HW_CACHE_RESULT_ACCESS << 16) },
+				{ PERF_TYPE_HW_CACHE, l1Read | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) } };
+			for (size_t i = 0; i < kCounters; i++) {
+				perf_event_attr attr = {};
+				attr.size = sizeof(attr);
+				attr.type = events[i].first;
+				attr.config = events[i].second;
+				attr.disabled = 1;
+				attr.exclude_kernel = 1;
+				attr.exclude_hv = 1;
+				_fds[i] = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+			}
+		#endif
+		}
+		~CacheCounters()
+		{
+		#if defined(ZJLD_LOOKUP_PERF_EVENTS)
+			for (const int fd : _fds) {
+				if (fd >= 0) {
+					close(fd);
+				}
+			}
+		#endif
+		}
+		CacheCounters(const CacheCounters&) = delete;
+		CacheCounters& operator=(const CacheCounters&) = delete;
+
+		bool Available(const size_t& aCounter) const { return _fds[aCounter] >= 0; }
+
+		void Start()
+		{
+		#if defined(ZJLD_LOOKUP_PERF_EVENTS)
+			for (const int fd : _fds) {
+				if (fd >= 0) {
+					ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+					ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+				}
+			}
+		#endif
+		}
+
+		// Stops counting, returning the counts since Start
+		std::vector<uint64_t> Stop()
+		{
+			std::vector<uint64_t> counts(kCounters, 0);
+		#if defined(ZJLD_LOOKUP_PERF_EVENTS)
+			for (size_t i = 0; i < kCounters; i++) {
+				if (_fds[i] >= 0) {
+					ioctl(_fds[i], PERF_EVENT_IOC_DISABLE, 0);
+					if (read(_fds[i], &counts[i], sizeof(uint64_t)) != sizeof(uint64_t)) {
+						counts[i] = 0;
+					}
+				}
+			}
+		#endif
+			return counts;
+		}
+	};
+
+	std::vector<Strategy> MakeStrategies()
+	{
+		typedef TableOptions::DataLayout DataLayout;
+		typedef LookupAxis::SearchLayout SearchLayout;
+		const std::pair<const char*, DataLayout> layouts[] = { { "Linear", DataLayout::Linear },
+			{ "Cells", DataLayout::Linear }, { "Tiled", DataLayout::Tiled },
+			{ "Compressed", DataLayout::Compressed } };
+		const std::pair<const char*, SearchLayout> searches[] = {
+			{ "Binary", SearchLayout::Binary }, { "Eytzinger", SearchLayout::Eytzinger } };
+		const std::pair<const char*, Mode> modes[] = {
+			{ "Single", Mode::Single }, { "Hinted", Mode::Hinted }, { "Batch", Mode::Batch } };
+
+		std::vector<Strategy> strategies;
+		for (const auto& layout : layouts) {
+			for (const auto& search : searches) {
+				for (const auto& mode : modes) {
+					const std::string name = std::string(layout.first) + "/" + search.first + "/"
+						+ mode.first;
+					strategies.push_back({ name, layout.second, layout.first == std::string("Cells"),
+						search.second, mode.second });
+				}
+			}
+		}
+		return strategies;
+	}
+
+	std::vector<ReplayStream> MakeStreams(const LookupTrace& aTrace)
+	{
+		const size_t dims = aTrace.Dimensions();
+		std::vector<ReplayStream> streams;
+		for (const LookupTrace::Stream& recorded : aTrace.Streams()) {
+			const size_t count = recorded.points.size() / dims;
+			ReplayStream stream;
+			stream.dimValues.assign(dims, std::vector<double>(count));
+			for (size_t i = 0; i < count; i++) {
+				const double* point = &recorded.points[i * dims];
+				stream.points.emplace_back(point, point + dims);
+				for (size_t d = 0; d < dims; d++) {
+					stream.dimValues[d][i] = point[d];
+				}
+			}
+			for (const std::vector<double>& values : stream.dimValues) {
+				stream.dimPointers.push_back(values.data());
+			}
+			stream.outValues.resize(count);
+			stream.outValidMask.resize(utils::BatchMaskWords(count));
+			streams.push_back(std::move(stream));
+		}
+		return streams;
+	}
+
+	// Prints each dimension's axis and the distribution of its segment jumps (see the top)
+	void ReportSearches(const LookupTableND& aTable,
+		const LookupTrace& aTrace)
+	{
+		const size_t dims = aTrace.Dimensions();
+		std::printf("\n%-5s %-8s %7s %6s  segment jumps between consecutive points (%% per bin)\n",
+			"dim", "axis", "size", "depth");
+		std::printf("%-30s", "");
+		for (size_t b = 0; b < kJumpBins; b++) {
+			const std::string label = (b == 0) ? "0" : (b == kJumpBins - 1)
+				? ">" + std::to_string((1 << (b - 1)) - 1) : "<" + std::to_string(1 << b);
+			std::printf(" %6s", label.c_str());
+		}
+		std::printf("\n");
+
+		for (size_t d = 0; d < dims; d++) {
+			const LookupAxis& axis = aTable.Axis(d);
+			std::vector<uint64_t> bins(kJumpBins, 0);
+			uint64_t jumps = 0;
+			for (const LookupTrace::Stream& stream : aTrace.Streams()) {
+				bool first = true;
+				size_t previous = 0;
+				for (size_t i = d; i < stream.points.size(); i += dims) {
+					const double value = stream.points[i];
+					if (std::isnan(value))
+						continue;
+					const double clamped = std::min(std::max(value, axis.Data().front()),
+						axis.Data().back());
+					const size_t segment = axis.FindSegment(clamped);
+					if (!first) {
+						size_t jump = (segment > previous) ? segment - previous : previous - segment;
+						size_t bin = 0;
+						for (; jump > 0 && bin < kJumpBins - 1; jump >>= 1) {
+							bin++;
+						}
+						bins[bin]++;
+						jumps++;
+					}
+					first = false;
+					previous = segment;
+				}
+			}
+			std::printf("%-5zu %-8s %7zu %6zu ", d, axis.Uniform() ? "uniform" : "searched",
+				axis.Size(), axis.SearchDepth());
+			for (const uint64_t count : bins) {
+				std::printf(" %6.1f", jumps ? 100.0 * count / jumps : 0.0);
+			}
+			std::printf("\n");
+		}
+	}
+
+	// Replays every stream once through aMode, returning a sum of the results
+	// so that the lookups are not optimized away
+	double Replay(const LookupTableND& aTable,
+		const Mode aMode,
+		std::vector<ReplayStream>* ioStreams)
+	{
+		double sum = 0.0;
+		for (ReplayStream& stream : *ioStreams) {
+			if (aMode == Mode::Batch) {
+				aTable.QueryBatchByValues(stream.dimPointers, stream.points.size(),
+					stream.outValues.data(), stream.outValidMask.data());
+				sum += stream.outValues.empty() ? 0.0 : stream.outValues.back();
+				continue;
+			}
+			LookupHint hint;
+			for (const std::vector<double>& point : stream.points) {
+				const utils::Result<double> result = (aMode == Mode::Hinted)
+					? aTable.QueryByValues(point, &hint) : aTable.QueryByValues(point);
+				sum += result.Valid() ? result.Value() : 0.0;
+			}
+		}
+		return sum;
+	}
+}
+
+
+int main(int argc, char** argv)
+{
+	if (argc < 3) {
+		std::fprintf(stderr, "Usage: %s <table file> <trace file> [seconds per strategy]\n", argv[0]);
+		return 1;
+	}
+	const double seconds = (argc > 3) ? std::atof(argv[3]) : 0.5;
+
+	LookupTableND table;
+	LookupTrace trace;
+	std::string errMsg;
+	if (!table.LoadBinary(argv[1], FileMode::Copy, &errMsg) || !trace.Load(argv[2], &errMsg)) {
+		std::fprintf(stderr, "%s\n", errMsg.c_str());
+		return 1;
+	}
+	if (trace.Dimensions() != table.Dimensions() || trace.Fingerprint() != trace::Fingerprint(table)) {
+		std::fprintf(stderr, "The trace was recorded on a table with other breakpoints.\n");
+		return 1;
+	}
+	if (trace.PointCount() == 0) {
+		std::fprintf(stderr, "The trace holds no points.\n");
+		return 1;
+	}
+	std::printf("%zu points from %zu threads (1 in %u lookups), %zu dimensions\n",
+		trace.PointCount(), trace.Streams().size(), trace.SampleInterval(), trace.Dimensions());
+	ReportSearches(table, trace);
+
+	std::vector<ReplayStream> streams = MakeStreams(trace);
+	CacheCounters counters;
+	const char* columns[] = { "refs/q", "misses/q", "L1 refs/q", "L1 miss/q" };
+	std::printf("\n%-28s %9s", "strategy", "ns/query");
+	for (const char* column : columns) {
+		std::printf(" %10s", column);
+	}
+	std::printf(" %8s\n", "steps");
+
+	const TableOptions baseOptions = table.Options();
+	double sum = 0.0;
+	for (const Strategy& strategy : MakeStrategies()) {
+		TableOptions options = baseOptions;
+		options.dataLayout = strategy.dataLayout;
+		options.precomputeCells = strategy.precomputeCells;
+		options.searchLayout = strategy.searchLayout;
+		table.SetOptions(options);
+
+		sum += Replay(table, strategy.mode, &streams); // warm up the caches
+		const LookupStats before = stats::TakeSnapshot();
+		size_t passes = 0;
+		const auto start = std::chrono::steady_clock::now();
+		std::chrono::duration<double> elapsed{ 0.0 };
+		counters.Start();
+		while (passes == 0 || elapsed.count() < seconds) {
+			sum += Replay(table, strategy.mode, &streams);
+			passes++;
+			elapsed = std::chrono::steady_clock::now() - start;
+		}
+		const std::vector<uint64_t> counts = counters.Stop();
+		const LookupStats after = stats::TakeSnapshot();
+
+		const double queries = static_cast<double>(passes * trace.PointCount());
+		std::printf("%-28s %9.2f", strategy.name.c_str(), 1e9 * elapsed.count() / queries);
+		for (size_t i = 0; i < counts.size(); i++) {
+			if (counters.Available(i)) {
+				std::printf(" %10.3f", counts[i] / queries);
+			}
+			else {
+				std::printf(" %10s", "n/a");
+			}
+		}
+		const uint64_t searches = after.searches - before.searches;
+		if (stats::Enabled() && searches > 0) {
+			std::printf(" %8.2f\n", static_cast<double>(after.searchSteps - before.searchSteps) / searches);
+		}
+		else {
+			std::printf(" %8s\n", "n/a");
+		}
+	}
+	volatile double sink = sum; // keeps the lookups from being optimized away
+	(void)sink;
+	return 0;
+}
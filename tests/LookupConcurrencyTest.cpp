@@ -0,0 +1,199 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+// This file is part of LookupTable <https://github.com/zjldemers/LookupTable>.
+// 
+// MIT License
+// Copyright (c) 2022 Zachary J. L. Demers
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+// Concurrency tests: many threads looking up one const table at once through every lookup
+// path (unhinted, hinted, batch and parallel batch), and the work-stealing ThreadPool
+// behind the parallel batches.  Every result must be bit-identical to the serial ones.
+// These are most useful built with -fsanitize=thread, e.g.
+//   cmake -S . -B build-tsan -DCMAKE_BUILD_TYPE=Debug -DCMAKE_CXX_FLAGS=-fsanitize=thread
+//   cmake --build build-tsan && ctest --test-dir build-tsan --output-on-failure
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "LookupTable.h"
+#include "LookupTestUtils.h"
+
+using namespace zjld; // feel free to remove/rename as the license above allows
+using namespace test;
+
+
+namespace
+{
+	const size_t kThreadCount = 8;
+	const size_t kPointCount = 3 * LookupTableND::kBatchChunkSize + 517; // not a whole chunk
+
+	// Looks up kPointCount points in aTable from kThreadCount threads at once, each going
+	// through the unhinted, hinted, batch and parallel batch lookups in turn (starting
+	// with a different one per thread), and checks every result against a serial batch
+	void CheckConcurrentReads(const LookupTableND& aTable)
+	{
+		ZJLD_CHECK(aTable.Valid());
+		const std::vector<TableData> points = MakePoints(aTable, kPointCount);
+		const std::vector<const double*> pointers = Pointers(points);
+		const size_t maskWords = utils::BatchMaskWords(kPointCount);
+		std::vector<double> expected(kPointCount);
+		std::vector<uint64_t> expectedMask(maskWords);
+		const size_t expectedCount = aTable.QueryBatchByValues(pointers, kPointCount,
+			expected.data(), expectedMask.data());
+		ZJLD_CHECK(expectedCount > kPointCount / 2 && expectedCount < kPointCount);
+
+		std::atomic<size_t> mismatches{ 0 };
+		std::vector<std::thread> threads;
+		for (size_t t = 0; t < kThreadCount; t++) {
+			threads.emplace_back([&, t]() {
+				size_t bad = 0;
+				LookupHint hint;
+				std::vector<double> inputs(aTable.Dimensions());
+				std::vector<double> values(kPointCount);
+				std::vector<uint64_t> mask(maskWords);
+				for (size_t round = 0; round < 4; round++) {
+					const size_t mode = (t + round) % 4;
+					if (mode < 2) {
+						for (size_t i = 0; i < kPointCount; i++) {
+							for (size_t d = 0; d < inputs.size(); d++) {
+								inputs[d] = points[d][i];
+							}
+							const utils::Result<double> result = (mode == 0)
+								? aTable.QueryByValues(inputs) : aTable.QueryByValues(inputs, &hint);
+							bad += (result.Valid() != utils::BatchMaskTest(expectedMask.data(), i))
+								|| (result.Valid() && !SameBits(result.Value(), expected[i]));
+						}
+					}
+					else {
+						const size_t count = (mode == 2)
+							? aTable.QueryBatchByValues(pointers, kPointCount, values.data(), mask.data())
+							: aTable.QueryBatchByValuesParallel(pointers, kPointCount, values.data(),
+								mask.data());
+						bad += (count != expectedCount) || (mask != expectedMask) || !SameBits(values, expected);
+					}
+				}
+				mismatches += bad;
+			});
+		}
+		for (std::thread& thread : threads) {
+			thread.join();
+		}
+		ZJLD_CHECK(mismatches.load() == 0);
+	}
+
+	void TestConcurrentReads()
+	{
+		CheckConcurrentReads(LookupTable2D(MakeDataSet(2, 200)));
+		CheckConcurrentReads(LookupTable3D(MakeDataSet(3, 40)));
+		CheckConcurrentReads(LookupTableND(MakeDataSet(4, 12)));
+
+		TableOptions options;
+		options.dataLayout = TableOptions::DataLayout::Tiled;
+		options.boundPolicy = LookupAxis::BoundPolicy::Clamp;
+		options.boundPolicies = { LookupAxis::BoundPolicy::Error };
+		CheckConcurrentReads(LookupTableND(MakeDataSet(3, 30), options));
+	}
+
+	void TestEveryTaskRunsOnce()
+	{
+		// The first tasks are far slower than the rest, so that the threads owning the later
+		// ranges run out of work early and steal from the others
+		ThreadPool pool(5);
+		const size_t taskCount = 10000;
+		std::vector<std::atomic<unsigned int>> runs(taskCount);
+		std::atomic<unsigned long long> sink{ 0 };
+		for (size_t round = 0; round < 20; round++) {
+			for (std::atomic<unsigned int>& run : runs) {
+				run = 0;
+			}
+			pool.Run(taskCount, [&](size_t aTask) {
+				unsigned long long work = aTask;
+				for (size_t i = 0, spins = (aTask < taskCount / 6) ? 2000 : 10; i < spins; i++) {
+					work = work * 6364136223846793005ull + 1442695040888963407ull;
+				}
+				sink += work & 1;
+				runs[aTask]++;
+			});
+			size_t wrong = 0;
+			for (const std::atomic<unsigned int>& run : runs) {
+				wrong += (run.load() != 1);
+			}
+			ZJLD_CHECK(wrong == 0);
+		}
+	}
+
+	void TestNestedAndConcurrentRuns()
+	{
+		ThreadPool pool(3);
+		std::atomic<size_t> nested{ 0 };
+		pool.Run(100, [&](size_t aOuter) {
+			pool.Run(10, [&](size_t aInner) { nested += aOuter * 10 + aInner; });
+		});
+		ZJLD_CHECK(nested.load() == 999 * 1000 / 2);
+
+		std::atomic<size_t> concurrent{ 0 };
+		std::vector<std::thread> threads;
+		for (size_t t = 0; t < 4; t++) {
+			threads.emplace_back([&]() {
+				for (size_t run = 0; run < 50; run++) {
+					pool.Run(1000, [&](size_t aTask) { concurrent += aTask; });
+				}
+			});
+		}
+		for (std::thread& thread : threads) {
+			thread.join();
+		}
+		ZJLD_CHECK(concurrent.load() == 4 * 50 * (999 * 1000 / 2));
+	}
+
+	void TestParallelBatchesMatchSerial()
+	{
+		const LookupTable3D table(MakeDataSet(3, 40));
+		const std::vector<TableData> points = MakePoints(table, kPointCount);
+		const std::vector<const double*> pointers = Pointers(points);
+		ThreadPool pool(3);
+		for (const size_t count : { size_t(0), size_t(1), size_t(63), LookupTableND::kBatchChunkSize,
+			LookupTableND::kBatchChunkSize + 1, kPointCount }) {
+			const size_t maskWords = utils::BatchMaskWords(count);
+			std::vector<double> serial(count), parallel(count), shared(count);
+			std::vector<uint64_t> serialMask(maskWords), parallelMask(maskWords, ~0ull),
+				sharedMask(maskWords, ~0ull);
+			const size_t serialCount = table.QueryBatchByValues(pointers, count, serial.data(),
+				serialMask.data());
+			ZJLD_CHECK(table.QueryBatchByValuesParallel(pointers, count, parallel.data(),
+				parallelMask.data(), pool.Executor()) == serialCount);
+			ZJLD_CHECK(table.QueryBatchByValuesParallel(pointers, count, shared.data(),
+				sharedMask.data()) == serialCount);
+			ZJLD_CHECK(SameBits(parallel, serial) && parallelMask == serialMask);
+			ZJLD_CHECK(SameBits(shared, serial) && sharedMask == serialMask);
+		}
+	}
+}
+
+
+int main()
+{
+	TestConcurrentReads();
+	TestEveryTaskRunsOnce();
+	TestNestedAndConcurrentRuns();
+	TestParallelBatchesMatchSerial();
+	return Finish();
+}
@@ -0,0 +1,155 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+// This file is part of LookupTable <https://github.com/zjldemers/LookupTable>.
+// 
+// MIT License
+// Copyright (c) 2022 Zachary J. L. Demers
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+// Device batches (see LookupTableCuda) against the host batches of the same tables: values
+// and validity bits must match bit for bit, including the last, partly filled warp of a
+// batch, and hardware interpolation must stay within its documented precision.  Only built
+// with ZJLD_LOOKUP_CUDA, and skipped (exit code 77) on machines without a CUDA device.
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <cstdio>
+#include <vector>
+#include <cuda_runtime_api.h>
+#include "LookupCuda.h"
+#include "LookupTestUtils.h"
+
+using namespace zjld; // feel free to remove/rename as the license above allows
+using namespace test;
+
+
+namespace
+{
+	// Device memory for aCount values of type T, freed on destruction
+	template<typename T>
+	struct DeviceBuffer
+	{
+		T* data;
+
+		explicit DeviceBuffer(const size_t aCount)
+			: data{ nullptr }
+		{
+			ZJLD_CHECK(cudaMalloc(&data, std::max<size_t>(aCount, 1) * sizeof(T)) == cudaSuccess);
+		}
+		~DeviceBuffer() { cudaFree(data); }
+		DeviceBuffer(const DeviceBuffer&) = delete;
+		DeviceBuffer& operator=(const DeviceBuffer&) = delete;
+	};
+
+	// Runs a batch of aCount points on aDeviceLut and on aTable, and compares their results
+	// exactly or, with hardware interpolation, to within 1/128 of the range of the values
+	void CheckBatch(const LookupTableND& aTable,
+		const LookupTableCuda& aDeviceLut,
+		const size_t aCount)
+	{
+		const std::vector<TableData> points = MakePoints(aTable, aCount);
+		const size_t maskWords = utils::BatchMaskWords(aCount);
+		std::vector<double> expected(aCount);
+		std::vector<uint64_t> expectedMask(maskWords);
+		aTable.QueryBatchByValues(Pointers(points), aCount, expected.data(), expectedMask.data());
+
+		DeviceBuffer<double> devicePoints(points.size() * aCount); // one dimension after another
+		std::vector<const double*> deviceInputs;
+		for (size_t d = 0; d < points.size(); d++) {
+			double* dimension = devicePoints.data + d * aCount;
+			ZJLD_CHECK(cudaMemcpy(dimension, points[d].data(), aCount * sizeof(double),
+				cudaMemcpyHostToDevice) == cudaSuccess);
+			deviceInputs.push_back(dimension);
+		}
+		DeviceBuffer<double> deviceValues(aCount);
+		DeviceBuffer<uint64_t> deviceMask(maskWords);
+		std::string errMsg;
+		ZJLD_CHECK(aDeviceLut.QueryBatchByValues(deviceInputs, aCount, deviceValues.data,
+			deviceMask.data, &errMsg));
+		ZJLD_CHECK(cudaDeviceSynchronize() == cudaSuccess);
+
+		std::vector<double> values(aCount);
+		std::vector<uint64_t> mask(maskWords);
+		ZJLD_CHECK(cudaMemcpy(values.data(), deviceValues.data, aCount * sizeof(double),
+			cudaMemcpyDeviceToHost) == cudaSuccess);
+		ZJLD_CHECK(cudaMemcpy(mask.data(), deviceMask.data, maskWords * sizeof(uint64_t),
+			cudaMemcpyDeviceToHost) == cudaSuccess);
+		ZJLD_CHECK(mask == expectedMask);
+		if (!aDeviceLut.HardwareInterpolation()) {
+			ZJLD_CHECK(SameBits(values, expected));
+			return;
+		}
+
+		const double tolerance = 2.0 / 128.0; // (values are within [-1, 1], see MakeDataSet)
+		size_t farOff = 0;
+		for (size_t i = 0; i < aCount; i++) {
+			farOff += utils::BatchMaskTest(expectedMask.data(), i)
+				&& !(std::fabs(values[i] - expected[i]) <= tolerance);
+		}
+		ZJLD_CHECK(farOff == 0);
+	}
+
+	// Uploads aTable and checks batches of sizes around the warp and mask word sizes
+	void CheckTable(const LookupTableND& aTable,
+		const bool aHardwareInterpolation = false)
+	{
+		LookupTableCuda deviceLut;
+		LookupTableCuda::Options options;
+		options.hardwareInterpolation = aHardwareInterpolation;
+		std::string errMsg;
+		ZJLD_CHECK(deviceLut.Upload(aTable, options, &errMsg));
+		if (!deviceLut.Valid()) {
+			std::fprintf(stderr, "Upload failed: %s\n", errMsg.c_str());
+			return;
+		}
+		for (const size_t count : { 1, 31, 33, 64 * 3 + 5, 10007, (1 << 20) + 13 }) {
+			CheckBatch(aTable, deviceLut, count);
+		}
+	}
+}
+
+
+int main()
+{
+	int deviceCount = 0;
+	if (cudaGetDeviceCount(&deviceCount) != cudaSuccess || deviceCount == 0) {
+		std::printf("No CUDA device, skipping.\n");
+		return 77;
+	}
+
+	// Every dimension count the devices support, then hardware interpolation
+	const size_t sizes[] = { 0, 0, 300, 40, 12, 7, 5, 4, 3 };
+	static_assert(sizeof(sizes) / sizeof(sizes[0]) == device::kMaxDimensions + 1,
+		"One size per dimension count.");
+	for (size_t dims = 2; dims <= device::kMaxDimensions; dims++) {
+		CheckTable(LookupTableND(MakeDataSet(dims, sizes[dims])));
+
+		TableOptions options;
+		options.storageType = StorageType::Float;
+		options.boundPolicy = LookupAxis::BoundPolicy::Extrapolate;
+		CheckTable(LookupTableND(MakeDataSet(dims, sizes[dims]), options));
+	}
+	TableOptions clamped;
+	clamped.boundPolicy = LookupAxis::BoundPolicy::Clamp;
+	CheckTable(LookupTableND(MakeDataSet(2, sizes[2]), clamped), true);
+	CheckTable(LookupTableND(MakeDataSet(3, sizes[3])), true);
+	return Finish();
+}
@@ -0,0 +1,105 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+// This file is part of LookupTable <https://github.com/zjldemers/LookupTable>.
+// 
+// MIT License
+// Copyright (c) 2022 Zachary J. L. Demers
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+// Host checks of the data copied to devices (see LookupDeviceData): device::EvaluatePoint
+// over a HostView must give the same value, bit for bit, and the same validity as the
+// table itself for every supported dimension count, storage type and bound policy.
+
+#include <vector>
+#include "LookupDevice.h"
+#include "LookupTableND.h"
+#include "LookupTestUtils.h"
+
+using namespace zjld; // feel free to remove/rename as the license above allows
+using namespace test;
+
+
+namespace
+{
+	const size_t kPointCount = 5000;
+
+	// Compares device::EvaluatePoint against a batch of aTable for kPointCount points
+	void CheckHostView(const LookupTableND& aTable)
+	{
+		ZJLD_CHECK(aTable.Valid());
+		LookupDeviceData data;
+		ZJLD_CHECK(data.Build(aTable) == utils::ErrorCode::None);
+		const device::TableView view = data.HostView();
+		ZJLD_CHECK(view.dims == aTable.Dimensions());
+
+		const std::vector<TableData> points = MakePoints(aTable, kPointCount);
+		std::vector<double> expected(kPointCount);
+		std::vector<uint64_t> expectedMask(utils::BatchMaskWords(kPointCount));
+		aTable.QueryBatchByValues(Pointers(points), kPointCount, expected.data(), expectedMask.data());
+
+		size_t mismatches = 0;
+		std::vector<double> inputs(aTable.Dimensions());
+		for (size_t i = 0; i < kPointCount; i++) {
+			for (size_t d = 0; d < inputs.size(); d++) {
+				inputs[d] = points[d][i];
+			}
+			double value = 0.0;
+			const bool valid = device::EvaluatePoint(view, inputs.data(), &value);
+			mismatches += (valid != utils::BatchMaskTest(expectedMask.data(), i))
+				|| (valid && !SameBits(value, expected[i]));
+		}
+		ZJLD_CHECK(mismatches == 0);
+	}
+}
+
+
+int main()
+{
+	// Every dimension count the devices support, with tables of similar sizes
+	const size_t sizes[] = { 0, 0, 300, 40, 12, 7, 5, 4, 3 };
+	static_assert(sizeof(sizes) / sizeof(sizes[0]) == device::kMaxDimensions + 1,
+		"One size per dimension count.");
+	for (size_t dims = 2; dims <= device::kMaxDimensions; dims++) {
+		CheckHostView(LookupTableND(MakeDataSet(dims, sizes[dims])));
+
+		TableOptions options;
+		options.storageType = StorageType::Float;
+		options.boundPolicy = LookupAxis::BoundPolicy::Clamp;
+		options.boundPolicies = { LookupAxis::BoundPolicy::Extrapolate };
+		CheckHostView(LookupTableND(MakeDataSet(dims, sizes[dims]), options));
+
+		options.storageType = StorageType::BFloat16;
+		options.dataLayout = TableOptions::DataLayout::Tiled;
+		options.boundPolicy = LookupAxis::BoundPolicy::Extrapolate;
+		options.boundPolicies = {};
+		CheckHostView(LookupTableND(MakeDataSet(dims, sizes[dims]), options));
+	}
+
+	// Tables that cannot be used on devices
+	LookupDeviceData data;
+	ZJLD_CHECK(data.Build(LookupTableND()) == utils::ErrorCode::InvalidTable);
+	ZJLD_CHECK(data.Build(LookupTableND(MakeDataSet(device::kMaxDimensions + 1, 2)))
+		== utils::ErrorCode::Unsupported);
+	TableOptions cubic;
+	cubic.interpolation = TableOptions::Interpolation::CatmullRom;
+	ZJLD_CHECK(data.Build(LookupTableND(MakeDataSet(3, 10), cubic)) == utils::ErrorCode::Unsupported);
+	ZJLD_CHECK(!data.Valid());
+	return Finish();
+}
@@ -0,0 +1,162 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+// This file is part of LookupTable <https://github.com/zjldemers/LookupTable>.
+// 
+// MIT License
+// Copyright (c) 2022 Zachary J. L. Demers
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+// Repopulating tables whose dependent data was not held in memory: a table loaded paged
+// (see LookupTableND::LoadBinary) or populated lazily (see PopulateLazy), then populated
+// again through any of PopulateData or PopulateDataView, must behave exactly like a table
+// populated with the new data from the start, without reading the old file or generator.
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "LookupTableND.h"
+#include "LookupTestUtils.h"
+
+using namespace zjld; // feel free to remove/rename as the license above allows
+using namespace test;
+
+
+namespace
+{
+	const size_t kPointCount = 2000;
+	const char* const kPagedPath = "lookup_repopulate_test.lut";
+
+	// The ways of populating a table from data held in memory
+	enum class Populate { Full, Split, FullMoved, SplitMoved, View, Count };
+
+	bool PopulateWith(LookupTableND* ioTable,
+		const Populate aHow,
+		const TableDataSet& aFullDataSet)
+	{
+		const TableDataSet indepData(aFullDataSet.begin(), aFullDataSet.end() - 1);
+		TableDataSet full = aFullDataSet, indep = indepData;
+		TableData dep = aFullDataSet.back();
+		switch (aHow) {
+		case Populate::Full: return ioTable->PopulateData(aFullDataSet);
+		case Populate::Split: return ioTable->PopulateData(indepData, aFullDataSet.back());
+		case Populate::FullMoved: return ioTable->PopulateData(std::move(full));
+		case Populate::SplitMoved: return ioTable->PopulateData(std::move(indep), std::move(dep));
+		default: return ioTable->PopulateDataView(indepData, aFullDataSet.back().data(),
+			aFullDataSet.back().size());
+		}
+	}
+
+	// Checks that aTable, just repopulated with aFullDataSet, matches a table built from
+	// it with the same options, in its results and in what it built for them
+	void CheckRepopulated(const LookupTableND& aTable,
+		const TableDataSet& aFullDataSet)
+	{
+		const LookupTableND expected(aFullDataSet, aTable.Options());
+		ZJLD_CHECK(aTable.Valid() && expected.Valid());
+		ZJLD_CHECK(!aTable.Paged());
+		ZJLD_CHECK(aTable.FilledTileCount() == 0);
+		ZJLD_CHECK(aTable.DepDataBytes() == expected.DepDataBytes());
+		ZJLD_CHECK(aTable.CellDataSize() == expected.CellDataSize());
+		ZJLD_CHECK(aTable.DerivativeDataSize() == expected.DerivativeDataSize());
+
+		const std::vector<TableData> points = MakePoints(expected, kPointCount);
+		const std::vector<const double*> pointers = Pointers(points);
+		const size_t maskWords = utils::BatchMaskWords(kPointCount);
+		std::vector<double> values(kPointCount), expectedValues(kPointCount);
+		std::vector<uint64_t> mask(maskWords), expectedMask(maskWords);
+		aTable.QueryBatchByValues(pointers, kPointCount, values.data(), mask.data());
+		expected.QueryBatchByValues(pointers, kPointCount, expectedValues.data(), expectedMask.data());
+		ZJLD_CHECK(SameBits(values, expectedValues) && mask == expectedMask);
+
+		size_t mismatches = 0;
+		std::vector<double> inputs(expected.Dimensions());
+		for (size_t i = 0; i < kPointCount; i++) {
+			for (size_t d = 0; d < inputs.size(); d++) {
+				inputs[d] = points[d][i];
+			}
+			const utils::Result<double> result = aTable.QueryByValues(inputs);
+			mismatches += (result.Valid() != utils::BatchMaskTest(expectedMask.data(), i))
+				|| (result.Valid() && !SameBits(result.Value(), expectedValues[i]));
+		}
+		ZJLD_CHECK(mismatches == 0);
+	}
+
+	// Options building everything that paged and lazy tables skip
+	TableOptions NewOptions(const bool aCubic)
+	{
+		TableOptions options;
+		options.precomputeCells = !aCubic;
+		options.interpolation = aCubic ? TableOptions::Interpolation::CatmullRom
+			: TableOptions::Interpolation::Linear;
+		return options;
+	}
+
+	// Loads a saved table paged, looks it up, then repopulates it with other data
+	void TestPagedThenPopulated()
+	{
+		const TableDataSet oldData = MakeDataSet(3, 20);
+		TableDataSet newData = oldData;
+		for (double& dep : newData.back()) {
+			dep = dep * 10.0 + 5.0;
+		}
+		std::string errMsg;
+		ZJLD_CHECK(LookupTableND(oldData).SaveBinary(kPagedPath, &errMsg));
+		for (size_t how = 0; how < static_cast<size_t>(Populate::Count); how++) {
+			for (const bool cubic : { false, true }) {
+				LookupTableND table;
+				ZJLD_CHECK(table.LoadBinary(kPagedPath, PageOptions(), &errMsg));
+				ZJLD_CHECK(table.Paged());
+				ZJLD_CHECK(table.LookupByValues({ 1.0, 1.0, 1.0 }) == LookupTableND(oldData).LookupByValues({ 1.0, 1.0, 1.0 }));
+				table.SetOptions(NewOptions(cubic));
+				ZJLD_CHECK(PopulateWith(&table, static_cast<Populate>(how), newData));
+				CheckRepopulated(table, newData);
+			}
+		}
+		std::remove(kPagedPath);
+	}
+
+	// Populates a table lazily, looks it up, then repopulates it with eager data
+	void TestLazyThenPopulated()
+	{
+		const TableDataSet newData = MakeDataSet(3, 20);
+		const TableDataSet indepData(newData.begin(), newData.end() - 1);
+		for (size_t how = 0; how < static_cast<size_t>(Populate::Count); how++) {
+			for (const bool cubic : { false, true }) {
+				LookupTableND table;
+				std::string errMsg;
+				ZJLD_CHECK(table.PopulateLazy(indepData, [](const double* aPoint) { return aPoint[0] + 100.0; },
+					LazyOptions(), &errMsg));
+				ZJLD_CHECK(table.LookupByValues({ 1.0, 1.0, 1.0 }) == 101.0);
+				ZJLD_CHECK(table.FilledTileCount() > 0);
+				table.SetOptions(NewOptions(cubic));
+				ZJLD_CHECK(PopulateWith(&table, static_cast<Populate>(how), newData));
+				CheckRepopulated(table, newData);
+			}
+		}
+	}
+}
+
+
+int main()
+{
+	TestPagedThenPopulated();
+	TestLazyThenPopulated();
+	return Finish();
+}
@@ -0,0 +1,136 @@
+/////////////////////////////////////////////////////////////////////////////////////////////
+// This file is part of LookupTable <https://github.com/zjldemers/LookupTable>.
+// 
+// MIT License
+// Copyright (c) 2022 Zachary J. L. Demers
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef _ZJLD_LOOKUP_TEST_UTILS_H_
+#define _ZJLD_LOOKUP_TEST_UTILS_H_
+
+// Helpers shared by the tests in this directory, each of which is a plain executable
+// returning nonzero if any of its checks failed (see ZJLD_CHECK)
+
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+#include "LookupTableND.h"
+
+// Reports a failed check and counts it in test::gFailures
+#define ZJLD_CHECK(aCondition) \
+	do { \
+		if (!(aCondition)) { \
+			std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #aCondition); \
+			test::gFailures++; \
+		} \
+	} while (false)
+
+
+namespace test
+{
+	inline size_t gFailures = 0; // checks failed so far
+
+	// Returns the exit code of a test: 0 if every check passed, 1 otherwise
+	inline int Finish()
+	{
+		if (gFailures == 0)
+			std::printf("All checks passed.\n");
+		else
+			std::printf("%zu checks failed.\n", gFailures);
+		return (gFailures == 0) ? 0 : 1;
+	}
+
+	// Builds a table with aDims dimensions of aSize breakpoints each, evenly spaced along
+	// the even dimensions and randomly along the odd ones
+	inline zjld::TableDataSet MakeDataSet(const size_t aDims,
+		const size_t aSize)
+	{
+		std::mt19937_64 rng(aDims * 1000 + aSize);
+		std::uniform_real_distribution<double> spacing(0.1, 1.1), value(-1.0, 1.0);
+		zjld::TableDataSet dataSet(aDims, zjld::TableData(aSize));
+		size_t depSize = 1;
+		for (size_t d = 0; d < aDims; d++) {
+			double position = 0.0;
+			for (double& breakpoint : dataSet[d]) {
+				breakpoint = position;
+				position += (d % 2 == 0) ? 0.5 : spacing(rng);
+			}
+			depSize *= aSize;
+		}
+		zjld::TableData depData(depSize);
+		for (double& dep : depData) {
+			dep = value(rng);
+		}
+		dataSet.push_back(depData);
+		return dataSet;
+	}
+
+	// Draws aCount points as one array per dimension of aTable, with about 5% of the
+	// values of each dimension out of bounds and 5% exactly on breakpoints
+	inline std::vector<zjld::TableData> MakePoints(const zjld::LookupTableND& aTable,
+		const size_t aCount)
+	{
+		std::mt19937_64 rng(aTable.Dimensions() * 1000 + aCount);
+		std::uniform_real_distribution<double> unit(0.0, 1.0);
+		std::vector<zjld::TableData> points(aTable.Dimensions(), zjld::TableData(aCount));
+		for (size_t d = 0; d < aTable.Dimensions(); d++) {
+			const zjld::TableData& breakpoints = aTable.Axis(d).Data();
+			const double low = breakpoints.front();
+			const double span = breakpoints.back() - low;
+			for (double& point : points[d]) {
+				const double kind = unit(rng);
+				if (kind < 0.05)
+					point = breakpoints[rng() % breakpoints.size()];
+				else if (kind < 0.10)
+					point = low + span * (unit(rng) * 0.4 + ((kind < 0.075) ? -0.2 : 1.0));
+				else
+					point = low + span * unit(rng);
+			}
+		}
+		return points;
+	}
+
+	// Returns the batch inputs (see LookupTableND::QueryBatchByValues) of aPoints
+	inline std::vector<const double*> Pointers(const std::vector<zjld::TableData>& aPoints)
+	{
+		std::vector<const double*> pointers;
+		for (const zjld::TableData& dimension : aPoints) {
+			pointers.push_back(dimension.data());
+		}
+		return pointers;
+	}
+
+	// These return true if the values have the same bits (NaN included)
+	inline bool SameBits(const double aValue,
+		const double aExpected)
+	{
+		return std::memcmp(&aValue, &aExpected, sizeof(double)) == 0;
+	}
+	inline bool SameBits(const std::vector<double>& aValues,
+		const std::vector<double>& aExpected)
+	{
+		return aValues.size() == aExpected.size() && (aValues.empty()
+			|| std::memcmp(aValues.data(), aExpected.data(), aValues.size() * sizeof(double)) == 0);
+	}
+}
+
+#endif // _ZJLD_LOOKUP_TEST_UTILS_H_